@@ -12,14 +12,43 @@
 #include "ClientHandler.h"
 #include "DatabaseManager.h"
 #include "vigenere.h"
+#include "vigenereanalysis.h"
+#include "vigenereattack.h"
 #include "sha1.h"
 #include "newton.h"
+#include "newtonstats.h"
 #include "wavembed.h"
 #include <QRandomGenerator>
 #include <QStandardPaths>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QJsonArray>
 #include <QJsonParseError>
+#include <QHash>
+#include <cmath>
+
+namespace {
+
+// Ключи задачи 4
+const QStringList TASK4_KEYS = {"KEY", "CODE", "PASS", "LOCK", "SAFE"};
+
+// Короче этого числа букв статистический анализ ненадёжен и ключ подбирается перебором
+const int VIGENERE_ANALYSIS_MIN_LETTERS = 200;
+
+// Скомпилированные ключи задачи 4: строятся один раз при первом обращении
+const QHash<QString, VigenereKey>& task4Keys()
+{
+    static const QHash<QString, VigenereKey> keys = [] {
+        QHash<QString, VigenereKey> compiled;
+        for (const QString& key : TASK4_KEYS) {
+            compiled.insert(key, VigenereKey(key));
+        }
+        return compiled;
+    }();
+    return keys;
+}
+
+} // namespace
 
 ClientHandler::ClientHandler(QTcpSocket* socket, QObject *parent)
     : QObject(parent), socket(socket), userId(-1), isAuthenticated(false)
@@ -129,6 +158,68 @@ QJsonObject ClientHandler::processCommand(const QJsonObject& request)
         response["message"] = "Статистика пользователя";
         return response;
     }
+    if (cmd == "newtonstats") {
+        // Гистограмма итераций метода Ньютона; "power" выбирает степень корня
+        int power = request.contains("power") ? request["power"].toInt() : -1;
+        RootIterationHistogram histogram = RootIterationStats::instance().histogram(power);
+        int last = histogram.counts.size() - 1;
+        while (last > 0 && histogram.counts[last] == 0) {
+            --last;
+        }
+        QJsonArray counts;
+        for (int i = 0; i <= last; ++i) {
+            counts.append(double(histogram.counts[i]));
+        }
+        response["success"] = true;
+        response["total"] = double(histogram.total());
+        response["histogram"] = counts;
+        response["within3to5"] = histogram.fractionWithin(3, 5);
+        response["p50"] = histogram.percentile(0.5);
+        response["p99"] = histogram.percentile(0.99);
+        response["message"] = "Гистограмма числа итераций метода Ньютона";
+        return response;
+    }
+    if (cmd == "vigenerebreak") {
+        // Восстановление ключа по шифротексту: проверка заданий «взломай шифр»
+        const QString ciphertext = request["ciphertext"].toString();
+        VigenereAnalysis analysis = analyzeVigenere(ciphertext);
+        if (analysis.key.isEmpty()) {
+            response["success"] = false;
+            response["message"] = "В шифротексте нет латинских букв";
+            return response;
+        }
+        QString key = analysis.key;
+        qint64 elapsedNs = analysis.elapsedNs;
+        if (analysis.letters < VIGENERE_ANALYSIS_MIN_LETTERS) {
+            // Короткий текст: сначала ключи задачи 4; общий словарь и поиск
+            // восхождением — только если букв хватает, иначе подходит почти любой ключ
+            VigenereKeySearch search(ciphertext);
+            search.dictionary(TASK4_KEYS);
+            elapsedNs += search.stats().elapsedNs;
+            if (analysis.letters >= 2 * VigenereKeySearch::MIN_LETTERS_PER_KEY_LETTER) {
+                search.dictionary(VigenereKeySearch::defaultDictionary(), VigenereKeySearch::AllMutations);
+                elapsedNs += search.stats().elapsedNs;
+                search.hillClimb();
+                elapsedNs += search.stats().elapsedNs;
+                response["keysPerSecondPerCore"] = search.stats().keysPerSecondPerCore();
+            }
+            key = search.key();
+            if (key.isEmpty()) {
+                // Словарь не пробуется на тексте короче 4 букв
+                response["success"] = false;
+                response["message"] = "Слишком короткий шифротекст для подбора ключа";
+                return response;
+            }
+        } else {
+            response["chiSquared"] = analysis.chiSquared;
+        }
+        response["success"] = true;
+        response["key"] = key;
+        response["keyLength"] = key.size();
+        response["elapsedMs"] = elapsedNs / 1e6;
+        response["message"] = QString("Предполагаемый ключ: %1").arg(key);
+        return response;
+    }
     if (cmd == "task1") {
         DatabaseManager* db = DatabaseManager::getInstance();
         QJsonObject resp;
@@ -168,13 +259,44 @@ QJsonObject ClientHandler::processCommand(const QJsonObject& request)
         double number = request["question"].toString().toDouble(&ok1);
         double userAnswer = request["answer"].toString().toDouble(&ok2);
         QJsonObject failResp = resp;
-        if (!ok1 || !ok2) {
+        // Любой отклонённый ответ, как и неверный, засчитывается как неудачная попытка.
+        // toDouble принимает "inf" и "nan"
+        if (!ok1 || !ok2 || !std::isfinite(number) || !std::isfinite(userAnswer)) {
             db->updateTaskStats(userId, "NEWTON", false);
             failResp["success"] = false;
             failResp["message"] = "Неверный формат числа";
             return failResp;
         }
-        double correctAnswer = newtonMethod(number);
+        // Необязательное поле "method": newton, halley или householder
+        RootMethod method = RootMethod::Newton;
+        if (request.contains("method") && !parseRootMethod(request["method"].toString(), method)) {
+            db->updateTaskStats(userId, "NEWTON", false);
+            failResp["success"] = false;
+            failResp["message"] = "Неизвестный метод: " + request["method"].toString();
+            return failResp;
+        }
+        double correctAnswer;
+        try {
+            if (request.contains("method")) {
+                EquationSolution solution = solveSquareRoot(number, 1e-12, method);
+                if (!solution.converged || !solution.error.isEmpty()) {
+                    db->updateTaskStats(userId, "NEWTON", false);
+                    failResp["success"] = false;
+                    failResp["message"] = "Ошибка вычисления корня: " + solution.error;
+                    return failResp;
+                }
+                correctAnswer = solution.root;
+                resp["method"] = rootMethodName(method);
+                resp["evaluations"] = solution.evaluations;
+            } else {
+                correctAnswer = newtonMethod(number);
+            }
+        } catch (const std::exception& e) {
+            db->updateTaskStats(userId, "NEWTON", false);
+            failResp["success"] = false;
+            failResp["message"] = QString("Ошибка вычисления корня: %1").arg(e.what());
+            return failResp;
+        }
         bool isCorrect = qAbs(userAnswer - correctAnswer) < 0.01;
         db->updateTaskStats(userId, "NEWTON", isCorrect);
         resp["success"] = isCorrect;
@@ -206,9 +328,8 @@ QJsonObject ClientHandler::processCommand(const QJsonObject& request)
         resp["command"] = "task4";
         if (!request.contains("question")) {
             QStringList testMessages = {"HELLO", "WORLD", "SECRET", "MESSAGE", "CRYPTO"};
-            QStringList testKeys = {"KEY", "CODE", "PASS", "LOCK", "SAFE"};
             QString message = testMessages[QRandomGenerator::global()->bounded(testMessages.size())];
-            QString key = testKeys[QRandomGenerator::global()->bounded(testKeys.size())];
+            QString key = TASK4_KEYS[QRandomGenerator::global()->bounded(TASK4_KEYS.size())];
             resp["success"] = true;
             resp["question"] = message;
             resp["key"] = key;
@@ -218,7 +339,10 @@ QJsonObject ClientHandler::processCommand(const QJsonObject& request)
         QString message = request["question"].toString();
         QString key = request["key"].toString();
         QString userAnswer = request["answer"].toString().toUpper();
-        QString correctAnswer = vigenereEncrypt(message, key).toUpper();
+        // Ключи задания уже скомпилированы; чужой ключ компилируется на один запрос
+        const auto compiled = task4Keys().constFind(key);
+        QString correctAnswer = (compiled != task4Keys().constEnd() ? compiled.value() : VigenereKey(key))
+                .encrypt(message).toUpper();
         bool isCorrect = (userAnswer == correctAnswer);
         db->updateTaskStats(userId, "ENCRYPT", isCorrect);
         resp["success"] = isCorrect;
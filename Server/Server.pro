@@ -12,17 +12,54 @@ SOURCES += \
     ClientHandler.cpp \
     DatabaseManager.cpp \
     sha1.cpp \
+    sha1search.cpp \
     newton.cpp \
+    expression.cpp \
+    newtonbatch.cpp \
+    newtonstats.cpp \
+    rootfinder.cpp \
+    polynomial.cpp \
+    newtonsystem.cpp \
     vigenere.cpp \
-    wavembed.cpp
+    classicalciphers.cpp \
+    vigenereanalysis.cpp \
+    vigenereattack.cpp \
+    vigenerestream.cpp \
+    wavembed.cpp \
+    wavformat.cpp \
+    stegcontainer.cpp \
+    lsbkernels.cpp \
+    streampipeline.cpp \
+    keyedscatter.cpp
 
 HEADERS += \
     mytcpserver.h \
     ClientHandler.h \
     DatabaseManager.h \
     sha1.h \
+    sha1search.h \
+    cpufeatures.h \
+    parallel.h \
     newton.h \
+    expression.h \
+    dual.h \
+    jet.h \
+    newtonbatch.h \
+    newtonstats.h \
+    rootfinder.h \
+    polynomial.h \
+    newtonsystem.h \
     vigenere.h \
-    wavembed.h
+    classicalciphers.h \
+    cipherkernel.h \
+    vigenereanalysis.h \
+    vigenereattack.h \
+    vigenerestream.h \
+    wavembed.h \
+    wavformat.h \
+    stegcontainer.h \
+    lsbkernels.h \
+    streampipeline.h \
+    keyedscatter.h
 
 
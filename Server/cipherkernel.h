@@ -0,0 +1,363 @@
+/**
+ * @file cipherkernel.h
+ * @brief Обобщённое ядро шифров сдвига по ключевому потоку
+ * @date 2024
+ *
+ * @details
+ * Виженер, Бофор, Гронсфельд и автоключ отличаются только тремя
+ * вещами: правилом сдвига буквы, тем, как строится ключевой поток, и
+ * алфавитом. CipherKernel собирает шифр из политик времени компиляции,
+ * и для каждой комбинации компилятор генерирует отдельные скалярный и
+ * AVX2-код без ветвлений на выбор шифра во внутреннем цикле.
+ *
+ * Ключевой поток передаётся окном сдвигов window (номера букв ключа):
+ * для периодического ключа — сдвиги, повторённые на длину ключа плюс
+ * KEY_WINDOW_PADDING позиций; для бегущего — весь поток плюс запас.
+ * Векторный путь читает окно с позиции phase одной 128-битной загрузкой
+ * и раздаёт сдвиги буквам блока через pshufb по префиксной сумме маски
+ * букв.
+ *
+ * @example
+ * @code
+ * // Бофор с периодическим ключом, ключ сдвигается только на буквах
+ * typedef CipherKernel<ReflectShift, PeriodicKey> Beaufort;
+ * int phase = 0;
+ * Beaufort::run(in, out, count, window, keyLength, phase);
+ * @endcode
+ *
+ * @see vigenere.h, classicalciphers.h
+ */
+
+#ifndef CIPHERKERNEL_H
+#define CIPHERKERNEL_H
+
+#include "cpufeatures.h"
+#include <QtGlobal>
+
+/// Запас окна ключа сверх длины ключа или потока: байтовое ядро читает
+/// до 16 позиций дальше фазы и ещё 16
+const int KEY_WINDOW_PADDING = 32;
+
+/**
+ * @brief Как ключ продвигается по тексту
+ */
+enum class KeyAdvance {
+    ByLetter,   ///< Ключ сдвигается только на буквах
+    ByPosition  ///< Ключ идёт по позиции символа (encryptVigenere())
+};
+
+/**
+ * @brief Правило сдвига c = p + k (Виженер, Гронсфельд, автоключ)
+ *
+ * Расшифрование — то же правило с дополненными сдвигами size - k.
+ */
+struct AddShift {
+    static int apply(int letter, int shift, int size)
+    {
+        const int value = letter + shift;
+        return value >= size ? value - size : value;
+    }
+
+#if HAVE_X86_SIMD
+    TARGET_AVX2 static __m256i apply16(__m256i letter, __m256i shift, __m256i size)
+    {
+        const __m256i value = _mm256_add_epi16(letter, shift);
+        return _mm256_sub_epi16(value, _mm256_andnot_si256(_mm256_cmpgt_epi16(size, value), size));
+    }
+
+    TARGET_AVX2 static __m256i apply8(__m256i letter, __m256i shift, __m256i size)
+    {
+        const __m256i value = _mm256_add_epi8(letter, shift);
+        return _mm256_sub_epi8(value, _mm256_andnot_si256(_mm256_cmpgt_epi8(size, value), size));
+    }
+#endif
+};
+
+/**
+ * @brief Правило сдвига c = k - p (Бофор); шифрование и расшифрование совпадают
+ */
+struct ReflectShift {
+    static int apply(int letter, int shift, int size)
+    {
+        const int value = shift - letter;
+        return value < 0 ? value + size : value;
+    }
+
+#if HAVE_X86_SIMD
+    TARGET_AVX2 static __m256i apply16(__m256i letter, __m256i shift, __m256i size)
+    {
+        const __m256i value = _mm256_sub_epi16(shift, letter);
+        return _mm256_add_epi16(value, _mm256_and_si256(_mm256_cmpgt_epi16(_mm256_setzero_si256(), value), size));
+    }
+
+    TARGET_AVX2 static __m256i apply8(__m256i letter, __m256i shift, __m256i size)
+    {
+        const __m256i value = _mm256_sub_epi8(shift, letter);
+        return _mm256_add_epi8(value, _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_setzero_si256(), value), size));
+    }
+#endif
+};
+
+/**
+ * @brief Периодический ключ: позиция в ключе берётся по модулю длины
+ */
+struct PeriodicKey {
+    static int next(int phase, int length) { return phase + 1 == length ? 0 : phase + 1; }
+    static int skip(int phase, int count, int length) { return (phase + count) % length; }
+};
+
+/**
+ * @brief Бегущий ключ: окно содержит весь ключевой поток (автоключ)
+ */
+struct RunningKey {
+    static int next(int phase, int) { return phase + 1; }
+    static int skip(int phase, int count, int) { return phase + count; }
+};
+
+/**
+ * @brief Латинский алфавит ASCII; регистр буквы сохраняется
+ */
+struct LatinAlphabet {
+    static const int SIZE = 26;
+
+    /// Номер буквы 0..25 или -1; base — 'A' или 'a'
+    static int letter(uint c, uint& base)
+    {
+        const uint index = (c | 0x20) - 'a';
+        if (index >= uint(SIZE)) {
+            return -1;
+        }
+        base = c & 0x20 ? 'a' : 'A';
+        return int(index);
+    }
+
+    /// Символ буквы index с базой base
+    static uint symbol(int index, uint base) { return base + uint(index); }
+
+#if HAVE_X86_SIMD
+    /// Маска букв среди 16 символов ASCII и база 'A'/'a' для каждой
+    TARGET_AVX2 static __m256i letters16(__m256i c, __m256i& base)
+    {
+        const __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi16(c, _mm256_set1_epi16('A' - 1)),
+                                               _mm256_cmpgt_epi16(_mm256_set1_epi16('Z' + 1), c));
+        const __m256i lower = _mm256_and_si256(_mm256_cmpgt_epi16(c, _mm256_set1_epi16('a' - 1)),
+                                               _mm256_cmpgt_epi16(_mm256_set1_epi16('z' + 1), c));
+        base = _mm256_blendv_epi8(_mm256_set1_epi16('a'), _mm256_set1_epi16('A'), upper);
+        return _mm256_or_si256(upper, lower);
+    }
+
+    /// То же для 32 байтов; байты от 0x80 отрицательны и не попадают ни в один диапазон
+    TARGET_AVX2 static __m256i letters8(__m256i c, __m256i& base)
+    {
+        const __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('A' - 1)),
+                                               _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), c));
+        const __m256i lower = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('a' - 1)),
+                                               _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), c));
+        base = _mm256_blendv_epi8(_mm256_set1_epi8('a'), _mm256_set1_epi8('A'), upper);
+        return _mm256_or_si256(upper, lower);
+    }
+#endif
+};
+
+/**
+ * @brief Ядро шифра сдвига, собранное из политик
+ * @tparam Rule Правило сдвига (AddShift, ReflectShift)
+ * @tparam Stream Ключевой поток (PeriodicKey, RunningKey)
+ * @tparam Advance Когда ключ продвигается
+ * @tparam Alphabet Алфавит (LatinAlphabet)
+ *
+ * @details
+ * Все функции продолжают шифрование с позиции phase в окне и
+ * обновляют её, поэтому текст можно обрабатывать частями.
+ *
+ * Скалярному пути от алфавита нужны только letter() и symbol(), поэтому
+ * он работает и с алфавитами без векторных функций (кириллица
+ * VigenereKey). Векторные пути требуют letters16()/letters8() и букв,
+ * идущих подряд от базы.
+ */
+template <typename Rule, typename Stream, KeyAdvance Advance = KeyAdvance::ByLetter,
+          typename Alphabet = LatinAlphabet>
+struct CipherKernel {
+    /// Кодовых единиц UTF-16 и байтов в одном регистре AVX2
+    static const int WIDTH16 = 16;
+    static const int WIDTH8 = 32;
+
+    /**
+     * Один символ: буква сдвигается, прочие символы не меняются. Сдвиги
+     * окна — quint8 или int (сдвиги вне алфавита у encryptVigenere()).
+     */
+    template <typename Shift>
+    static uint character(uint c, const Shift* window, int length, int& phase)
+    {
+        uint base = 0;
+        const int letter = Alphabet::letter(c, base);
+        if (letter < 0) {
+            if (Advance == KeyAdvance::ByPosition) {
+                phase = Stream::next(phase, length);
+            }
+            return c;
+        }
+        const uint result = Alphabet::symbol(Rule::apply(letter, window[phase], Alphabet::SIZE), base);
+        phase = Stream::next(phase, length);
+        return result;
+    }
+
+    /// Скалярный путь для символов UTF-16 [begin, end)
+    template <typename Shift>
+    static void scalar(const ushort* in, ushort* out, int begin, int end, const Shift* window, int length,
+                       int& phase)
+    {
+        for (int i = begin; i < end; ++i) {
+            out[i] = ushort(character(in[i], window, length, phase));
+        }
+    }
+
+    /// Скалярный путь для байтов [begin, end); возвращает фазу после них
+    static int scalarBytes(const uchar* in, uchar* out, qint64 begin, qint64 end, const quint8* window, int length,
+                           int phase)
+    {
+        for (qint64 i = begin; i < end; ++i) {
+            out[i] = uchar(character(in[i], window, length, phase));
+        }
+        return phase;
+    }
+
+#if HAVE_X86_SIMD
+    /**
+     * Обрабатывает текст блоками по WIDTH16 символов и возвращает число
+     * обработанных символов. Блок с символом вне ASCII передаётся в
+     * fallback(begin, end), который продолжает ту же фазу ключа.
+     */
+    template <typename Fallback>
+    TARGET_AVX2 static int avx2(const ushort* in, ushort* out, int count, const quint8* window, int length,
+                                int& phase, Fallback fallback)
+    {
+        const __m256i nonAscii = _mm256_set1_epi16(short(0xFF80));
+        const __m256i size = _mm256_set1_epi16(Alphabet::SIZE);
+        const __m256i one = _mm256_set1_epi16(1);
+        const __m256i zeroHighByte = _mm256_set1_epi16(short(0x8000));
+
+        int i = 0;
+        for (; i + WIDTH16 <= count; i += WIDTH16) {
+            const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+            if (!_mm256_testz_si256(c, nonAscii)) {
+                fallback(i, i + WIDTH16);
+                continue;
+            }
+
+            __m256i base;
+            const __m256i letter = Alphabet::letters16(c, base);
+            __m256i shifts;
+            if (Advance == KeyAdvance::ByPosition) {
+                shifts = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(window + phase)));
+                phase = Stream::skip(phase, WIDTH16, length);
+            } else {
+                // Номер буквы в блоке: исключающая префиксная сумма маски букв.
+                // Сначала сумма внутри 128-битных половин, затем итог нижней
+                // половины (элемент 7) добавляется ко всей верхней.
+                const __m256i isLetter = _mm256_and_si256(letter, one);
+                __m256i prefix = _mm256_add_epi16(isLetter, _mm256_slli_si256(isLetter, 2));
+                prefix = _mm256_add_epi16(prefix, _mm256_slli_si256(prefix, 4));
+                prefix = _mm256_add_epi16(prefix, _mm256_slli_si256(prefix, 8));
+                __m256i carry = _mm256_permute2x128_si256(prefix, prefix, 0x08);
+                carry = _mm256_shufflehi_epi16(carry, 0xFF);
+                carry = _mm256_unpackhi_epi64(carry, carry);
+                prefix = _mm256_add_epi16(prefix, carry);
+                const __m256i index = _mm256_sub_epi16(prefix, isLetter);
+
+                // Сдвиг k-й буквы блока — байт k окна ключа; старший байт
+                // управляющего слова 0x80 обнуляет старший байт результата
+                const __m256i keyWindow = _mm256_broadcastsi128_si256(
+                            _mm_loadu_si128(reinterpret_cast<const __m128i*>(window + phase)));
+                shifts = _mm256_shuffle_epi8(keyWindow, _mm256_or_si256(index, zeroHighByte));
+                phase = Stream::skip(phase, __builtin_popcount(_mm256_movemask_epi8(letter)) / 2, length);
+            }
+
+            const __m256i value = Rule::apply16(_mm256_sub_epi16(c, base), shifts, size);
+            const __m256i result = _mm256_blendv_epi8(c, _mm256_add_epi16(value, base), letter);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), result);
+        }
+        return i;
+    }
+
+    /**
+     * Байтовое ядро: 32 байта за шаг. Номер буквы внутри каждой 128-битной
+     * половины — префиксная сумма маски букв; верхняя половина читает окно
+     * ключа со сдвигом на число букв нижней, поэтому pshufb хватает
+     * индексов 0..15. Возвращает число обработанных байтов.
+     */
+    TARGET_AVX2 static qint64 avx2Bytes(const uchar* in, uchar* out, qint64 count, const quint8* window,
+                                        int length, int& phase)
+    {
+        const __m256i size = _mm256_set1_epi8(Alphabet::SIZE);
+        const __m256i one = _mm256_set1_epi8(1);
+
+        qint64 i = 0;
+        for (; i + WIDTH8 <= count; i += WIDTH8) {
+            const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+            __m256i base;
+            const __m256i letter = Alphabet::letters8(c, base);
+            const quint32 mask = quint32(_mm256_movemask_epi8(letter));
+            if (mask == 0) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), c);
+                if (Advance == KeyAdvance::ByPosition) {
+                    phase = Stream::skip(phase, WIDTH8, length);
+                }
+                continue;
+            }
+
+            __m256i keyWindow;
+            if (Advance == KeyAdvance::ByPosition) {
+                keyWindow = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(window + phase));
+                phase = Stream::skip(phase, WIDTH8, length);
+            } else {
+                const __m256i isLetter = _mm256_and_si256(letter, one);
+                __m256i prefix = _mm256_add_epi8(isLetter, _mm256_slli_si256(isLetter, 1));
+                prefix = _mm256_add_epi8(prefix, _mm256_slli_si256(prefix, 2));
+                prefix = _mm256_add_epi8(prefix, _mm256_slli_si256(prefix, 4));
+                prefix = _mm256_add_epi8(prefix, _mm256_slli_si256(prefix, 8));
+                const __m256i index = _mm256_sub_epi8(prefix, isLetter);
+
+                const int lowLetters = __builtin_popcount(mask & 0xFFFF);
+                keyWindow = _mm256_inserti128_si256(
+                            _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(window + phase))),
+                            _mm_loadu_si128(reinterpret_cast<const __m128i*>(window + phase + lowLetters)), 1);
+                keyWindow = _mm256_shuffle_epi8(keyWindow, index);
+                phase = Stream::skip(phase, __builtin_popcount(mask), length);
+            }
+
+            const __m256i value = Rule::apply8(_mm256_sub_epi8(c, base), keyWindow, size);
+            const __m256i result = _mm256_blendv_epi8(c, _mm256_add_epi8(value, base), letter);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), result);
+        }
+        return i;
+    }
+#endif // HAVE_X86_SIMD
+
+    /// Весь текст UTF-16: AVX2, если доступен, и скалярный хвост
+    static void run(const ushort* in, ushort* out, int count, const quint8* window, int length, int& phase)
+    {
+        int done = 0;
+#if HAVE_X86_SIMD
+        if (useAvx2()) {
+            done = avx2(in, out, count, window, length, phase,
+                        [&](int begin, int end) { scalar(in, out, begin, end, window, length, phase); });
+        }
+#endif
+        scalar(in, out, done, count, window, length, phase);
+    }
+
+    /// Весь байтовый буфер; возвращает фазу после него
+    static int runBytes(const uchar* in, uchar* out, qint64 count, const quint8* window, int length, int phase)
+    {
+        qint64 done = 0;
+#if HAVE_X86_SIMD
+        if (useAvx2()) {
+            done = avx2Bytes(in, out, count, window, length, phase);
+        }
+#endif
+        return scalarBytes(in, out, done, count, window, length, phase);
+    }
+};
+
+#endif // CIPHERKERNEL_H
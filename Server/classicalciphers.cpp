@@ -0,0 +1,147 @@
+/**
+ * @file classicalciphers.cpp
+ * @brief Реализация шифров Бофора, Гронсфельда и автоключа
+ * @date 2024
+ */
+
+#include "classicalciphers.h"
+#include "cipherkernel.h"
+#include <QByteArray>
+
+namespace {
+
+const int LETTERS = LatinAlphabet::SIZE;
+
+typedef CipherKernel<ReflectShift, PeriodicKey> BeaufortKernel;
+typedef CipherKernel<AddShift, PeriodicKey> GronsfeldKernel;
+typedef CipherKernel<AddShift, RunningKey> AutokeyKernel;
+
+// Сдвиги ключа: номера латинских букв или значения цифр; прочие символы пропускаются
+QByteArray keyShifts(const QString& key, bool digits)
+{
+    QByteArray shifts;
+    shifts.reserve(key.size());
+    for (QChar c : key) {
+        const uint u = c.unicode();
+        uint base = 0;
+        if (digits) {
+            if (u - '0' < 10u) {
+                shifts.append(char(u - '0'));
+            }
+        } else {
+            const int letter = LatinAlphabet::letter(u, base);
+            if (letter >= 0) {
+                shifts.append(char(letter));
+            }
+        }
+    }
+    return shifts;
+}
+
+// Периодическое окно: сдвиги (или дополнения до размера алфавита) на length + KEY_WINDOW_PADDING позиций
+QByteArray periodicWindow(const QByteArray& shifts, bool complement)
+{
+    const int length = shifts.size();
+    QByteArray window(length + KEY_WINDOW_PADDING, Qt::Uninitialized);
+    for (int i = 0; i < window.size(); ++i) {
+        const int shift = shifts[i % length];
+        window[i] = char(complement ? (LETTERS - shift) % LETTERS : shift);
+    }
+    return window;
+}
+
+template <typename Kernel>
+QString transform(const QString& text, const QByteArray& window, int length)
+{
+    QString result(text.size(), Qt::Uninitialized);
+    int phase = 0;
+    Kernel::run(text.utf16(), reinterpret_cast<ushort*>(result.data()), text.size(),
+                reinterpret_cast<const quint8*>(window.constData()), length, phase);
+    return result;
+}
+
+QString transformGronsfeld(const QString& text, const QString& key, bool decrypt)
+{
+    const QByteArray shifts = keyShifts(key, true);
+    if (shifts.isEmpty()) {
+        return text;
+    }
+    return transform<GronsfeldKernel>(text, periodicWindow(shifts, decrypt), shifts.size());
+}
+
+} // namespace
+
+QString encryptBeaufort(const QString& text, const QString& key)
+{
+    const QByteArray shifts = keyShifts(key, false);
+    if (shifts.isEmpty()) {
+        return text;
+    }
+    return transform<BeaufortKernel>(text, periodicWindow(shifts, false), shifts.size());
+}
+
+QString decryptBeaufort(const QString& text, const QString& key)
+{
+    return encryptBeaufort(text, key);
+}
+
+QString encryptGronsfeld(const QString& text, const QString& key)
+{
+    return transformGronsfeld(text, key, false);
+}
+
+QString decryptGronsfeld(const QString& text, const QString& key)
+{
+    return transformGronsfeld(text, key, true);
+}
+
+QString encryptAutokey(const QString& text, const QString& key)
+{
+    const QByteArray shifts = keyShifts(key, false);
+    if (shifts.isEmpty()) {
+        return text;
+    }
+
+    // Ключевой поток известен заранее: ключ, затем буквы открытого текста
+    QByteArray stream = shifts;
+    stream.reserve(shifts.size() + text.size() + KEY_WINDOW_PADDING);
+    for (QChar c : text) {
+        uint base = 0;
+        const int letter = LatinAlphabet::letter(c.unicode(), base);
+        if (letter >= 0) {
+            stream.append(char(letter));
+        }
+    }
+    const int length = stream.size();
+    stream.append(QByteArray(KEY_WINDOW_PADDING, 0));
+    return transform<AutokeyKernel>(text, stream, length);
+}
+
+QString decryptAutokey(const QString& text, const QString& key)
+{
+    QByteArray ring = keyShifts(key, false);
+    const int length = ring.size();
+    if (length == 0) {
+        return text;
+    }
+
+    // Кольцо из length последних элементов потока: ключ для буквы i —
+    // буква i - length, расшифрованная перед ней
+    QString result(text.size(), Qt::Uninitialized);
+    const ushort* in = text.utf16();
+    ushort* out = reinterpret_cast<ushort*>(result.data());
+    int position = 0;
+    for (int i = 0; i < text.size(); ++i) {
+        uint base = 0;
+        const int letter = LatinAlphabet::letter(in[i], base);
+        if (letter < 0) {
+            out[i] = in[i];
+            continue;
+        }
+        const int plain = AddShift::apply(letter, (LETTERS - ring[position]) % LETTERS, LETTERS);
+        out[i] = ushort(base + plain);
+        ring[position] = char(plain);
+        position = PeriodicKey::next(position, length);
+    }
+    return result;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file classicalciphers.h
+ * @brief Шифры Бофора, Гронсфельда и автоключ
+ * @date 2024
+ *
+ * @details
+ * Классические шифры семейства Виженера для новых заданий. Все они —
+ * экземпляры ядра CipherKernel (cipherkernel.h) и различаются только
+ * политиками:
+ * - Бофор: c = k - p, периодический ключ; шифрование обратно самому себе;
+ * - Гронсфельд: c = p + k, ключ из цифр 0–9;
+ * - автоключ: c = p + k, после ключа поток продолжается буквами
+ *   открытого текста.
+ *
+ * Как и в VigenereKey, меняются только латинские буквы (регистр
+ * сохраняется), а ключ сдвигается только на буквах. Символы ключа вне
+ * его алфавита пропускаются; ключ без подходящих символов возвращает
+ * текст без изменений.
+ *
+ * Расшифрование автоключа зависит от собственного результата (ключ для
+ * буквы i — расшифрованная буква i - L) и выполняется скалярно.
+ *
+ * @example
+ * @code
+ * encryptBeaufort("DEFENDTHEEASTWALL", "FORTIFICATION");  // "CKMPVCPVWPIWUJOGI"
+ * encryptGronsfeld("HELLO", "31415");                     // "KFPMT"
+ * encryptAutokey("ATTACKATDAWN", "QUEENLY");              // "QNXEPVYTWTWP"
+ * @endcode
+ *
+ * @see vigenere.h
+ */
+
+#ifndef CLASSICALCIPHERS_H
+#define CLASSICALCIPHERS_H
+
+#include <QString>
+
+/**
+ * @brief Шифрует текст шифром Бофора
+ * @param text Исходный текст
+ * @param key Ключ (латинские буквы)
+ * @return Зашифрованный текст
+ */
+QString encryptBeaufort(const QString& text, const QString& key);
+
+/**
+ * @brief Дешифрует текст шифром Бофора (то же, что encryptBeaufort())
+ * @param text Зашифрованный текст
+ * @param key Ключ (латинские буквы)
+ * @return Расшифрованный текст
+ */
+QString decryptBeaufort(const QString& text, const QString& key);
+
+/**
+ * @brief Шифрует текст шифром Гронсфельда
+ * @param text Исходный текст
+ * @param key Ключ из цифр; цифра — величина сдвига
+ * @return Зашифрованный текст
+ */
+QString encryptGronsfeld(const QString& text, const QString& key);
+
+/**
+ * @brief Дешифрует текст шифром Гронсфельда
+ * @param text Зашифрованный текст
+ * @param key Ключ из цифр
+ * @return Расшифрованный текст
+ */
+QString decryptGronsfeld(const QString& text, const QString& key);
+
+/**
+ * @brief Шифрует текст шифром с автоключом
+ * @param text Исходный текст
+ * @param key Начальный ключ (латинские буквы)
+ * @return Зашифрованный текст
+ */
+QString encryptAutokey(const QString& text, const QString& key);
+
+/**
+ * @brief Дешифрует текст шифром с автоключом
+ * @param text Зашифрованный текст
+ * @param key Начальный ключ (латинские буквы)
+ * @return Расшифрованный текст
+ */
+QString decryptAutokey(const QString& text, const QString& key);
+
+#endif // CLASSICALCIPHERS_H
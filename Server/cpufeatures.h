@@ -0,0 +1,87 @@
+/**
+ * @file cpufeatures.h
+ * @brief Определение возможностей процессора для SIMD-ядер
+ * @date 2024
+ *
+ * @details
+ * Векторные ядра компилируются с атрибутом target("avx2"), поэтому
+ * сервер собирается без флага -mavx2 и работает на любом x86-64.
+ * Выбор между векторным и скалярным путём делается во время выполнения.
+ */
+
+#ifndef CPUFEATURES_H
+#define CPUFEATURES_H
+
+#include <atomic>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define HAVE_X86_SIMD 1
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_AVX2_FMA __attribute__((target("avx2,fma")))
+#include <immintrin.h>
+#else
+#define HAVE_X86_SIMD 0
+#define TARGET_AVX2
+#define TARGET_AVX2_FMA
+#endif
+
+/**
+ * @brief Флаг, разрешающий использование SIMD-ядер
+ * @return Ссылка на общий для всех модулей флаг
+ */
+inline std::atomic<bool>& simdEnabledFlag()
+{
+    static std::atomic<bool> enabled(true);
+    return enabled;
+}
+
+/**
+ * @brief Проверяет, поддерживает ли процессор AVX2
+ * @return true если инструкции AVX2 доступны
+ */
+inline bool cpuHasAvx2()
+{
+#if HAVE_X86_SIMD
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    return hasAvx2;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Проверяет, поддерживает ли процессор AVX2 вместе с FMA
+ * @return true если доступны AVX2 и FMA3
+ */
+inline bool cpuHasAvx2Fma()
+{
+#if HAVE_X86_SIMD
+    static const bool hasFma = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return hasFma;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Включает или отключает SIMD-ядра
+ * @param enabled false заставляет все модули использовать скалярный путь
+ *
+ * @details
+ * Используется в тестах для сравнения векторных и скалярных результатов.
+ */
+inline void setSimdEnabled(bool enabled)
+{
+    simdEnabledFlag().store(enabled);
+}
+
+/**
+ * @brief Проверяет, следует ли использовать AVX2-ядра
+ * @return true если AVX2 доступен и не отключён через setSimdEnabled()
+ */
+inline bool useAvx2()
+{
+    return cpuHasAvx2() && simdEnabledFlag().load(std::memory_order_relaxed);
+}
+
+#endif // CPUFEATURES_H
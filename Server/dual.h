@@ -0,0 +1,99 @@
+/**
+ * @file dual.h
+ * @brief Дуальные числа для автоматического дифференцирования
+ * @date 2024
+ *
+ * @details
+ * Дуальное число v + d·ε (ε² = 0) несёт значение функции и её
+ * производную. Если вычислить выражение от Dual(x, 1), то в поле
+ * derivative окажется точное значение f'(x) — без символьных правил
+ * и без погрешности конечных разностей (прямой режим AD).
+ *
+ * @example
+ * @code
+ * Dual x(2.0, 1.0);
+ * Dual y = x * x - 4.0;  // y.value = 0, y.derivative = 4
+ * @endcode
+ */
+
+#ifndef DUAL_H
+#define DUAL_H
+
+#include <cmath>
+
+/**
+ * @brief Дуальное число: значение и производная
+ */
+struct Dual {
+    double value;       ///< Значение функции
+    double derivative;  ///< Производная по переменной
+
+    Dual() = default;
+    Dual(double v, double d = 0.0) : value(v), derivative(d) {}
+};
+
+inline Dual operator+(const Dual& a, const Dual& b) { return Dual(a.value + b.value, a.derivative + b.derivative); }
+inline Dual operator-(const Dual& a, const Dual& b) { return Dual(a.value - b.value, a.derivative - b.derivative); }
+inline Dual operator-(const Dual& a) { return Dual(-a.value, -a.derivative); }
+
+inline Dual operator*(const Dual& a, const Dual& b)
+{
+    return Dual(a.value * b.value, a.derivative * b.value + a.value * b.derivative);
+}
+
+inline Dual operator/(const Dual& a, const Dual& b)
+{
+    return Dual(a.value / b.value, (a.derivative * b.value - a.value * b.derivative) / (b.value * b.value));
+}
+
+inline Dual& operator+=(Dual& a, const Dual& b) { return a = a + b; }
+inline Dual& operator-=(Dual& a, const Dual& b) { return a = a - b; }
+inline Dual& operator*=(Dual& a, const Dual& b) { return a = a * b; }
+inline Dual& operator/=(Dual& a, const Dual& b) { return a = a / b; }
+
+inline Dual sin(const Dual& a) { return Dual(std::sin(a.value), std::cos(a.value) * a.derivative); }
+inline Dual cos(const Dual& a) { return Dual(std::cos(a.value), -std::sin(a.value) * a.derivative); }
+
+inline Dual tan(const Dual& a)
+{
+    const double t = std::tan(a.value);
+    return Dual(t, (1.0 + t * t) * a.derivative);
+}
+
+inline Dual exp(const Dual& a)
+{
+    const double e = std::exp(a.value);
+    return Dual(e, e * a.derivative);
+}
+
+inline Dual log(const Dual& a) { return Dual(std::log(a.value), a.derivative / a.value); }
+
+inline Dual sqrt(const Dual& a)
+{
+    const double s = std::sqrt(a.value);
+    return Dual(s, a.derivative / (2.0 * s));
+}
+
+inline Dual abs(const Dual& a)
+{
+    return Dual(std::abs(a.value), a.value < 0 ? -a.derivative : a.derivative);
+}
+
+/**
+ * @brief Степень с дуальным показателем
+ *
+ * @details
+ * Для постоянного показателя используется правило n·x^(n-1), которое
+ * работает и для отрицательного основания; общий случай идёт через
+ * логарифмическую производную.
+ */
+inline Dual pow(const Dual& a, const Dual& b)
+{
+    const double p = std::pow(a.value, b.value);
+    if (b.derivative == 0.0) {
+        return Dual(p, b.value * std::pow(a.value, b.value - 1.0) * a.derivative);
+    }
+    return Dual(p, p * (b.derivative * std::log(a.value) + b.value * a.derivative / a.value));
+}
+
+#endif // DUAL_H
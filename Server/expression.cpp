@@ -0,0 +1,613 @@
+/**
+ * @file expression.cpp
+ * @brief Реализация компилятора математических выражений
+ * @date 2024
+ *
+ * @details
+ * Разбор — рекурсивный спуск с приоритетами:
+ *   equation := expr ('=' expr)?
+ *   expr     := term (('+' | '-') term)*
+ *   term     := unary (('*' | '/') unary | неявное умножение)*
+ *   unary    := ('-' | '+') unary | power
+ *   power    := primary ('^' unary)?
+ *   primary  := число | x | pi | e | функция '(' expr ')' | '(' expr ')'
+ * Дерево сворачивает константы, а степени с небольшим целым
+ * показателем превращаются в инструкцию PowInt.
+ *
+ * Пробелы разделяют лексемы и не склеивают их: «2e - 3» — это 2·e − 3,
+ * а не число 2e-3. Глубина дерева ограничена MAX_NESTING_DEPTH, чтобы
+ * текст из сети не мог переполнить стек рекурсией разбора.
+ */
+
+#include "expression.h"
+#include <QMutexLocker>
+#include <QtMath>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+// Максимальный показатель, для которого степень раскрывается возведением в квадрат
+const int MAX_INT_POWER = 64;
+
+struct Node {
+    enum Kind { Number, Variable, Unary, Binary };
+
+    Kind kind;
+    Expression::OpCode op;
+    double value;
+    int height;     // высота поддерева
+    std::unique_ptr<Node> left;
+    std::unique_ptr<Node> right;
+
+    Node(Kind k, Expression::OpCode o = Expression::PushConst, double v = 0.0)
+        : kind(k), op(o), value(v), height(1) {}
+};
+
+typedef std::unique_ptr<Node> NodePtr;
+
+NodePtr makeNumber(double value)
+{
+    return NodePtr(new Node(Node::Number, Expression::PushConst, value));
+}
+
+NodePtr makeUnary(Expression::OpCode op, NodePtr operand)
+{
+    NodePtr node(new Node(Node::Unary, op));
+    node->height = operand->height + 1;
+    node->left = std::move(operand);
+    return node;
+}
+
+NodePtr makeBinary(Expression::OpCode op, NodePtr left, NodePtr right)
+{
+    NodePtr node(new Node(Node::Binary, op));
+    node->height = qMax(left->height, right->height) + 1;
+    node->left = std::move(left);
+    node->right = std::move(right);
+    return node;
+}
+
+template <typename T>
+inline T intPower(T x, int n)
+{
+    unsigned int e = n < 0 ? unsigned(-n) : unsigned(n);
+    T result(1.0);
+    while (e) {
+        if (e & 1u) {
+            result *= x;
+        }
+        e >>= 1;
+        if (e) {
+            x *= x;
+        }
+    }
+    return n < 0 ? T(1.0) / result : result;
+}
+
+double applyUnary(Expression::OpCode op, double a)
+{
+    switch (op) {
+    case Expression::Neg:  return -a;
+    case Expression::Sin:  return std::sin(a);
+    case Expression::Cos:  return std::cos(a);
+    case Expression::Tan:  return std::tan(a);
+    case Expression::Exp:  return std::exp(a);
+    case Expression::Log:  return std::log(a);
+    case Expression::Sqrt: return std::sqrt(a);
+    case Expression::Abs:  return std::abs(a);
+    default:               return a;
+    }
+}
+
+double applyBinary(Expression::OpCode op, double a, double b)
+{
+    switch (op) {
+    case Expression::Add: return a + b;
+    case Expression::Sub: return a - b;
+    case Expression::Mul: return a * b;
+    case Expression::Div: return a / b;
+    case Expression::Pow: return std::pow(a, b);
+    default:              return a;
+    }
+}
+
+bool isIntegral(double value)
+{
+    return std::abs(value) <= MAX_INT_POWER && value == std::floor(value);
+}
+
+// Может ли символ входить в число или имя
+bool isOperandChar(QChar c)
+{
+    return c.isLetterOrNumber() || c == '.';
+}
+
+// Длина числа с позиции pos: цифры и точки, затем необязательная экспонента
+int numberLength(const QString& text, int pos)
+{
+    int end = pos;
+    while (end < text.size() && (text[end].isDigit() || text[end] == '.')) {
+        ++end;
+    }
+    // Экспонента: 1e-3, 2e5; одиночная «e» после числа — это константа
+    if (end < text.size() && text[end] == 'e') {
+        int exponent = end + 1;
+        if (exponent < text.size() && (text[exponent] == '+' || text[exponent] == '-')) {
+            ++exponent;
+        }
+        if (exponent < text.size() && text[exponent].isDigit()) {
+            end = exponent;
+            while (end < text.size() && text[end].isDigit()) {
+                ++end;
+            }
+        }
+    }
+    return end - pos;
+}
+
+// Длина лексемы с позиции pos (текст в нижнем регистре, без пробела в pos)
+int tokenLength(const QString& text, int pos)
+{
+    const QChar c = text[pos];
+    if (c.isDigit() || c == '.') {
+        return numberLength(text, pos);
+    }
+    if (c.isLetter()) {
+        int end = pos;
+        while (end < text.size() && text[end].isLetter()) {
+            ++end;
+        }
+        return end - pos;
+    }
+    if (c == '*' && pos + 1 < text.size() && text[pos + 1] == '*') {
+        return 2;
+    }
+    return 1;
+}
+
+} // namespace
+
+/**
+ * @brief Разбор текста в AST и перевод в байткод
+ */
+class ExpressionCompiler {
+public:
+    explicit ExpressionCompiler(const QString& source) : text(source), pos(0), nesting(0) {}
+
+    Expression compile()
+    {
+        NodePtr root = parseEquation();
+        if (pos < text.size()) {
+            fail(QString("Unexpected character '%1'").arg(text[pos]));
+        }
+
+        Expression result;
+        result.text = text;
+        int current = 0;
+        lower(root.get(), result, current);
+        return result;
+    }
+
+private:
+    QString text;
+    int pos;
+    int nesting;    // глубина рекурсии разбора
+
+    // Счётчик вложенности на время разбора одного уровня
+    struct NestingGuard {
+        ExpressionCompiler& compiler;
+
+        explicit NestingGuard(ExpressionCompiler& c) : compiler(c)
+        {
+            if (++compiler.nesting > Expression::MAX_NESTING_DEPTH) {
+                compiler.fail("Expression is too deeply nested");
+            }
+        }
+        ~NestingGuard() { --compiler.nesting; }
+    };
+
+    [[noreturn]] void fail(const QString& message) const
+    {
+        throw std::runtime_error(QString("%1 at position %2").arg(message).arg(pos + 1).toStdString());
+    }
+
+    QChar peek() const { return pos < text.size() ? text[pos] : QChar(); }
+
+    // Пробел в нормализованном тексте разделяет лексемы, которые иначе слились бы
+    void skipSpace()
+    {
+        if (peek() == ' ') {
+            ++pos;
+        }
+    }
+
+    bool accept(QChar c)
+    {
+        skipSpace();
+        if (peek() == c) {
+            ++pos;
+            return true;
+        }
+        return false;
+    }
+
+    // Может ли с текущей позиции начаться множитель (для неявного умножения)
+    bool startsPrimary()
+    {
+        skipSpace();
+        QChar c = peek();
+        return c.isDigit() || c == '.' || c.isLetter() || c == '(';
+    }
+
+    NodePtr parseEquation()
+    {
+        NodePtr left = parseExpr();
+        if (accept('=')) {
+            NodePtr right = parseExpr();
+            return fold(makeBinary(Expression::Sub, std::move(left), std::move(right)));
+        }
+        return left;
+    }
+
+    NodePtr parseExpr()
+    {
+        NodePtr node = parseTerm();
+        for (;;) {
+            if (accept('+')) {
+                node = fold(makeBinary(Expression::Add, std::move(node), parseTerm()));
+            } else if (accept('-')) {
+                node = fold(makeBinary(Expression::Sub, std::move(node), parseTerm()));
+            } else {
+                return node;
+            }
+        }
+    }
+
+    NodePtr parseTerm()
+    {
+        NodePtr node = parseUnary();
+        for (;;) {
+            if (accept('*')) {
+                node = fold(makeBinary(Expression::Mul, std::move(node), parseUnary()));
+            } else if (accept('/')) {
+                node = fold(makeBinary(Expression::Div, std::move(node), parseUnary()));
+            } else if (startsPrimary()) {
+                node = fold(makeBinary(Expression::Mul, std::move(node), parsePower()));
+            } else {
+                return node;
+            }
+        }
+    }
+
+    NodePtr parseUnary()
+    {
+        // Любая рекурсия разбора (скобки, унарные знаки, показатели,
+        // аргументы функций) проходит через parseUnary
+        NestingGuard guard(*this);
+        if (accept('-')) {
+            return fold(makeUnary(Expression::Neg, parseUnary()));
+        }
+        if (accept('+')) {
+            return parseUnary();
+        }
+        return parsePower();
+    }
+
+    NodePtr parsePower()
+    {
+        NodePtr base = parsePrimary();
+        if (accept('^')) {
+            return fold(makeBinary(Expression::Pow, std::move(base), parseUnary()));
+        }
+        return base;
+    }
+
+    NodePtr parsePrimary()
+    {
+        skipSpace();
+        if (pos >= text.size()) {
+            fail("Unexpected end of expression");
+        }
+
+        QChar c = peek();
+        if (c.isDigit() || c == '.') {
+            return parseNumber();
+        }
+        if (accept('(')) {
+            NodePtr node = parseExpr();
+            if (!accept(')')) {
+                fail("Expected ')'");
+            }
+            return node;
+        }
+        if (c.isLetter()) {
+            return parseIdentifier();
+        }
+        fail(QString("Unexpected character '%1'").arg(c));
+        return NodePtr();
+    }
+
+    NodePtr parseNumber()
+    {
+        const int start = pos;
+        pos += numberLength(text, pos);
+
+        bool ok = false;
+        double value = text.mid(start, pos - start).toDouble(&ok);
+        if (!ok) {
+            pos = start;
+            fail("Invalid number");
+        }
+        return makeNumber(value);
+    }
+
+    NodePtr parseIdentifier()
+    {
+        const int start = pos;
+        while (peek().isLetter()) {
+            ++pos;
+        }
+        const QString name = text.mid(start, pos - start);
+
+        if (name == "x") {
+            return NodePtr(new Node(Node::Variable, Expression::PushX));
+        }
+        if (name == "pi") {
+            return makeNumber(M_PI);
+        }
+        if (name == "e") {
+            return makeNumber(M_E);
+        }
+
+        static const QHash<QString, Expression::OpCode> functions = {
+            {"sin", Expression::Sin}, {"cos", Expression::Cos}, {"tan", Expression::Tan},
+            {"exp", Expression::Exp}, {"log", Expression::Log}, {"ln", Expression::Log},
+            {"sqrt", Expression::Sqrt}, {"abs", Expression::Abs}
+        };
+        auto it = functions.constFind(name);
+        if (it == functions.constEnd()) {
+            pos = start;
+            fail(QString("Unknown identifier '%1'").arg(name));
+        }
+        if (!accept('(')) {
+            fail(QString("Expected '(' after '%1'").arg(name));
+        }
+        NodePtr argument = parseExpr();
+        if (!accept(')')) {
+            fail("Expected ')'");
+        }
+        return fold(makeUnary(it.value(), std::move(argument)));
+    }
+
+    // Свёртка константных поддеревьев; длинные цепочки операций
+    // ограничены так же, как вложенность
+    NodePtr fold(NodePtr node) const
+    {
+        if (node->height > Expression::MAX_NESTING_DEPTH) {
+            fail("Expression is too deeply nested");
+        }
+        if (node->kind == Node::Unary && node->left->kind == Node::Number) {
+            return makeNumber(applyUnary(node->op, node->left->value));
+        }
+        if (node->kind == Node::Binary && node->left->kind == Node::Number
+                && node->right->kind == Node::Number) {
+            return makeNumber(applyBinary(node->op, node->left->value, node->right->value));
+        }
+        return node;
+    }
+
+    void emitInstruction(Expression& program, Expression::OpCode op, qint32 operand, int& current, int delta) const
+    {
+        program.code.append({op, operand});
+        current += delta;
+        if (current > program.depth) {
+            program.depth = current;
+            if (current > Expression::MAX_STACK_DEPTH) {
+                throw std::runtime_error("Expression is too deeply nested");
+            }
+        }
+    }
+
+    void lower(const Node* node, Expression& program, int& current) const
+    {
+        switch (node->kind) {
+        case Node::Number:
+            program.constants.append(node->value);
+            emitInstruction(program, Expression::PushConst, program.constants.size() - 1, current, +1);
+            break;
+        case Node::Variable:
+            emitInstruction(program, Expression::PushX, 0, current, +1);
+            break;
+        case Node::Unary:
+            lower(node->left.get(), program, current);
+            emitInstruction(program, node->op, 0, current, 0);
+            break;
+        case Node::Binary:
+            if (node->op == Expression::Pow && node->right->kind == Node::Number
+                    && isIntegral(node->right->value)) {
+                lower(node->left.get(), program, current);
+                emitInstruction(program, Expression::PowInt, qint32(node->right->value), current, 0);
+                break;
+            }
+            lower(node->left.get(), program, current);
+            lower(node->right.get(), program, current);
+            emitInstruction(program, node->op, 0, current, -1);
+            break;
+        }
+    }
+};
+
+Expression Expression::compile(const QString& text)
+{
+    const QString normalized = normalize(text);
+    if (normalized.isEmpty()) {
+        throw std::runtime_error("Empty expression");
+    }
+    return ExpressionCompiler(normalized).compile();
+}
+
+QString Expression::normalize(const QString& text)
+{
+    // Сначала лексемы, потом пробелы: удаление пробелов до разбора
+    // склеило бы «2e - 3» в число 2e-3
+    const QString lower = text.toLower();
+    QString result;
+    result.reserve(lower.size());
+    int pos = 0;
+    while (pos < lower.size()) {
+        if (lower[pos].isSpace()) {
+            ++pos;
+            continue;
+        }
+        const int length = tokenLength(lower, pos);
+        // Соседние лексемы, которые при повторном разборе слились бы
+        // в одну (числа и имена, «* *»), разделяются одним пробелом
+        if (!result.isEmpty()) {
+            const QChar last = result[result.size() - 1];
+            if ((isOperandChar(last) && isOperandChar(lower[pos])) || (last == '*' && lower[pos] == '*')) {
+                result.append(' ');
+            }
+        }
+        if (length == 2 && lower[pos] == '*') {
+            result.append('^');
+        } else {
+            result.append(lower.mid(pos, length));
+        }
+        pos += length;
+    }
+    return result;
+}
+
+template <typename T>
+T Expression::run(const T& x) const
+{
+    using std::pow;
+    using std::sin;
+    using std::cos;
+    using std::tan;
+    using std::exp;
+    using std::log;
+    using std::sqrt;
+    using std::abs;
+
+    T stack[MAX_STACK_DEPTH];
+    T* top = stack - 1;
+    const double* consts = constants.constData();
+
+    for (const Instruction* ip = code.constData(), *end = ip + code.size(); ip != end; ++ip) {
+        switch (ip->op) {
+        case PushConst: *++top = T(consts[ip->operand]); break;
+        case PushX:     *++top = x; break;
+        case Add:       top[-1] += top[0]; --top; break;
+        case Sub:       top[-1] -= top[0]; --top; break;
+        case Mul:       top[-1] *= top[0]; --top; break;
+        case Div:       top[-1] /= top[0]; --top; break;
+        case Pow:       top[-1] = pow(top[-1], top[0]); --top; break;
+        case PowInt:    *top = intPower(*top, ip->operand); break;
+        case Neg:       *top = -*top; break;
+        case Sin:       *top = sin(*top); break;
+        case Cos:       *top = cos(*top); break;
+        case Tan:       *top = tan(*top); break;
+        case Exp:       *top = exp(*top); break;
+        case Log:       *top = log(*top); break;
+        case Sqrt:      *top = sqrt(*top); break;
+        case Abs:       *top = abs(*top); break;
+        }
+    }
+
+    return stack[0];
+}
+
+double Expression::evaluate(double x) const
+{
+    return run(x);
+}
+
+Dual Expression::evaluate(const Dual& x) const
+{
+    return run(x);
+}
+
+Jet<2> Expression::evaluate(const Jet<2>& x) const
+{
+    return run(x);
+}
+
+Jet<3> Expression::evaluate(const Jet<3>& x) const
+{
+    return run(x);
+}
+
+ExpressionCache::ExpressionCache(int capacity)
+    : maxSize(qMax(1, capacity))
+{
+}
+
+ExpressionCache& ExpressionCache::instance()
+{
+    static ExpressionCache cache;
+    return cache;
+}
+
+std::shared_ptr<const Expression> ExpressionCache::get(const QString& text)
+{
+    const QString key = Expression::normalize(text);
+
+    {
+        QMutexLocker locker(&mutex);
+        auto it = index.find(key);
+        if (it != index.end()) {
+            entries.splice(entries.begin(), entries, it.value());
+            ++hitCount;
+            return entries.front().second;
+        }
+        ++missCount;
+    }
+
+    // Компилируем без блокировки: разбор не зависит от состояния кэша
+    std::shared_ptr<const Expression> program = std::make_shared<Expression>(Expression::compile(key));
+
+    QMutexLocker locker(&mutex);
+    auto it = index.find(key);
+    if (it != index.end()) {
+        // Другой поток успел скомпилировать то же выражение
+        entries.splice(entries.begin(), entries, it.value());
+        return entries.front().second;
+    }
+
+    entries.emplace_front(key, program);
+    index.insert(key, entries.begin());
+    while (entries.size() > size_t(maxSize)) {
+        index.remove(entries.back().first);
+        entries.pop_back();
+    }
+    return program;
+}
+
+void ExpressionCache::clear()
+{
+    QMutexLocker locker(&mutex);
+    entries.clear();
+    index.clear();
+    hitCount = 0;
+    missCount = 0;
+}
+
+int ExpressionCache::size() const
+{
+    QMutexLocker locker(&mutex);
+    return index.size();
+}
+
+quint64 ExpressionCache::hits() const
+{
+    QMutexLocker locker(&mutex);
+    return hitCount;
+}
+
+quint64 ExpressionCache::misses() const
+{
+    QMutexLocker locker(&mutex);
+    return missCount;
+}
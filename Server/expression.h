@@ -0,0 +1,189 @@
+/**
+ * @file expression.h
+ * @brief Заголовочный файл компилятора математических выражений
+ * @date 2024
+ *
+ * @details
+ * Строка уравнения один раз разбирается в дерево (AST), которое
+ * затем переводится в компактный стековый байткод. Вычисление байткода
+ * не выделяет память, поэтому его можно вызывать в горячем цикле
+ * метода Ньютона. Скомпилированные программы хранятся в LRU-кэше по
+ * нормализованному тексту выражения, так что повторные запросы задачи 2
+ * не разбирают строку заново.
+ *
+ * Поддерживаемый синтаксис:
+ * - переменная x, константы pi и e, числа (в том числе 1e-3);
+ * - операции + - * / ^ (или **), унарный минус, скобки;
+ * - неявное умножение: 2x, 3(x+1), x(x-1);
+ * - функции sin, cos, tan, exp, log (ln), sqrt, abs;
+ * - уравнение вида "lhs = rhs" компилируется как lhs - (rhs).
+ *
+ * Тот же байткод вычисляется на дуальных числах (dual.h), что даёт
+ * значение и точную производную за один проход, и на рядах Тейлора
+ * (jet.h) — для вторых и третьих производных.
+ *
+ * @see newton.h
+ */
+
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+
+#include <QString>
+#include <QVector>
+#include <QHash>
+#include <QMutex>
+#include "dual.h"
+#include "jet.h"
+#include <list>
+#include <memory>
+
+/**
+ * @brief Скомпилированное выражение от одной переменной x
+ *
+ * @example
+ * @code
+ * Expression f = Expression::compile("x^2 - 4");
+ * double y = f.evaluate(3.0); // y = 5
+ * @endcode
+ */
+class Expression {
+public:
+    /// Коды инструкций стековой машины
+    enum OpCode : quint8 {
+        PushConst,  ///< Положить константу constants[operand]
+        PushX,      ///< Положить значение переменной
+        Add,
+        Sub,
+        Mul,
+        Div,
+        Pow,        ///< Степень с вещественным показателем
+        PowInt,     ///< Степень с целым показателем operand
+        Neg,
+        Sin,
+        Cos,
+        Tan,
+        Exp,
+        Log,
+        Sqrt,
+        Abs
+    };
+
+    /// Одна инструкция байткода
+    struct Instruction {
+        OpCode op;
+        qint32 operand;
+    };
+
+    /// Максимальная глубина стека вычислений
+    static const int MAX_STACK_DEPTH = 256;
+
+    /// Максимальная вложенность выражения (скобки, знаки, цепочки операций)
+    static const int MAX_NESTING_DEPTH = 256;
+
+    /**
+     * @brief Компилирует выражение
+     * @param text Текст выражения или уравнения
+     * @return Скомпилированное выражение
+     * @throw std::runtime_error при синтаксической ошибке
+     */
+    static Expression compile(const QString& text);
+
+    /**
+     * @brief Приводит текст выражения к каноническому виду для кэша
+     * @param text Исходный текст
+     * @return Лексемы в нижнем регистре без пробелов, с ^ вместо **;
+     * лексемы, которые иначе слились бы, разделены одним пробелом («2 e-3»)
+     */
+    static QString normalize(const QString& text);
+
+    /**
+     * @brief Вычисляет значение выражения
+     * @param x Значение переменной
+     * @return Значение выражения
+     */
+    double evaluate(double x) const;
+
+    /**
+     * @brief Вычисляет значение и производную за один проход
+     * @param x Дуальное значение переменной; для f'(x) передайте Dual(x, 1)
+     * @return Дуальный результат: value = f(x), derivative = f'(x)
+     */
+    Dual evaluate(const Dual& x) const;
+
+    /**
+     * @brief Вычисляет значение, первую и вторую производные
+     * @param x Ряд переменной; передайте Jet<2>::variable(x)
+     * @return Ряд Тейлора выражения в точке x
+     */
+    Jet<2> evaluate(const Jet<2>& x) const;
+
+    /**
+     * @brief Вычисляет значение и производные до третьей включительно
+     * @param x Ряд переменной; передайте Jet<3>::variable(x)
+     * @return Ряд Тейлора выражения в точке x
+     */
+    Jet<3> evaluate(const Jet<3>& x) const;
+
+    /// Нормализованный текст, из которого скомпилировано выражение
+    QString source() const { return text; }
+
+    /// Байткод программы
+    const QVector<Instruction>& instructions() const { return code; }
+
+    /// Необходимая глубина стека
+    int stackDepth() const { return depth; }
+
+private:
+    QString text;
+    QVector<Instruction> code;
+    QVector<double> constants;
+    int depth = 0;
+
+    template <typename T>
+    T run(const T& x) const;
+
+    friend class ExpressionCompiler;
+};
+
+/**
+ * @brief Потокобезопасный LRU-кэш скомпилированных выражений
+ */
+class ExpressionCache {
+public:
+    /**
+     * @brief Конструктор
+     * @param capacity Максимальное число хранимых выражений
+     */
+    explicit ExpressionCache(int capacity = 128);
+
+    /// Общий кэш сервера
+    static ExpressionCache& instance();
+
+    /**
+     * @brief Возвращает скомпилированное выражение, компилируя при промахе
+     * @param text Текст выражения
+     * @return Указатель на программу (остаётся валидным после вытеснения)
+     * @throw std::runtime_error при синтаксической ошибке
+     */
+    std::shared_ptr<const Expression> get(const QString& text);
+
+    /// Очищает кэш и счётчики
+    void clear();
+
+    int size() const;
+    int capacity() const { return maxSize; }
+    quint64 hits() const;
+    quint64 misses() const;
+
+private:
+    typedef std::pair<QString, std::shared_ptr<const Expression>> Entry;
+
+    mutable QMutex mutex;
+    std::list<Entry> entries;                             ///< Порядок использования: начало — самые свежие
+    QHash<QString, std::list<Entry>::iterator> index;
+    int maxSize;
+    quint64 hitCount = 0;
+    quint64 missCount = 0;
+};
+
+#endif // EXPRESSION_H
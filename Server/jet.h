@@ -0,0 +1,262 @@
+/**
+ * @file jet.h
+ * @brief Усечённые ряды Тейлора для производных высших порядков
+ * @date 2024
+ *
+ * @details
+ * Jet<N> хранит коэффициенты ряда f(x + h) = c0 + c1·h + ... + cN·h^N.
+ * Арифметика и элементарные функции реализованы рекуррентными
+ * формулами для рядов, поэтому вычисление выражения от
+ * Jet<N>::variable(x) за один проход даёт f(x) и производные до
+ * N-го порядка: f^(k)(x) = k!·ck. Это обобщение дуальных чисел
+ * (dual.h соответствует N = 1) для методов Галлея (N = 2) и
+ * Хаусхолдера (N = 3).
+ *
+ * @example
+ * @code
+ * Jet<2> x = Jet<2>::variable(2.0);
+ * Jet<2> y = x * x * x;  // y.derivative(1) = 12, y.derivative(2) = 12
+ * @endcode
+ */
+
+#ifndef JET_H
+#define JET_H
+
+#include <cmath>
+
+/**
+ * @brief Ряд Тейлора порядка N в точке
+ */
+template <int N>
+struct Jet {
+    double c[N + 1];  ///< Коэффициенты ряда
+
+    Jet() = default;
+
+    /// Константа
+    Jet(double value)
+    {
+        c[0] = value;
+        for (int k = 1; k <= N; ++k) {
+            c[k] = 0.0;
+        }
+    }
+
+    /// Переменная x в точке value (ряд value + h)
+    static Jet variable(double value)
+    {
+        Jet result(value);
+        if (N >= 1) {
+            result.c[1] = 1.0;
+        }
+        return result;
+    }
+
+    /// Значение функции
+    double value() const { return c[0]; }
+
+    /// Производная порядка order (order <= N)
+    double derivative(int order) const
+    {
+        double factorial = 1.0;
+        for (int k = 2; k <= order; ++k) {
+            factorial *= k;
+        }
+        return c[order] * factorial;
+    }
+};
+
+template <int N>
+inline Jet<N> operator+(const Jet<N>& a, const Jet<N>& b)
+{
+    Jet<N> r;
+    for (int k = 0; k <= N; ++k) {
+        r.c[k] = a.c[k] + b.c[k];
+    }
+    return r;
+}
+
+template <int N>
+inline Jet<N> operator-(const Jet<N>& a, const Jet<N>& b)
+{
+    Jet<N> r;
+    for (int k = 0; k <= N; ++k) {
+        r.c[k] = a.c[k] - b.c[k];
+    }
+    return r;
+}
+
+template <int N>
+inline Jet<N> operator-(const Jet<N>& a)
+{
+    Jet<N> r;
+    for (int k = 0; k <= N; ++k) {
+        r.c[k] = -a.c[k];
+    }
+    return r;
+}
+
+// Произведение рядов: свёртка коэффициентов
+template <int N>
+inline Jet<N> operator*(const Jet<N>& a, const Jet<N>& b)
+{
+    Jet<N> r;
+    for (int k = 0; k <= N; ++k) {
+        double sum = 0.0;
+        for (int i = 0; i <= k; ++i) {
+            sum += a.c[i] * b.c[k - i];
+        }
+        r.c[k] = sum;
+    }
+    return r;
+}
+
+// Частное: r_k = (a_k - Σ_{i=1..k} b_i·r_{k-i}) / b_0
+template <int N>
+inline Jet<N> operator/(const Jet<N>& a, const Jet<N>& b)
+{
+    Jet<N> r;
+    for (int k = 0; k <= N; ++k) {
+        double sum = a.c[k];
+        for (int i = 1; i <= k; ++i) {
+            sum -= b.c[i] * r.c[k - i];
+        }
+        r.c[k] = sum / b.c[0];
+    }
+    return r;
+}
+
+template <int N> inline Jet<N>& operator+=(Jet<N>& a, const Jet<N>& b) { return a = a + b; }
+template <int N> inline Jet<N>& operator-=(Jet<N>& a, const Jet<N>& b) { return a = a - b; }
+template <int N> inline Jet<N>& operator*=(Jet<N>& a, const Jet<N>& b) { return a = a * b; }
+template <int N> inline Jet<N>& operator/=(Jet<N>& a, const Jet<N>& b) { return a = a / b; }
+
+// e' = a'·e: e_k = (1/k)·Σ_{i=1..k} i·a_i·e_{k-i}
+template <int N>
+inline Jet<N> exp(const Jet<N>& a)
+{
+    Jet<N> r;
+    r.c[0] = std::exp(a.c[0]);
+    for (int k = 1; k <= N; ++k) {
+        double sum = 0.0;
+        for (int i = 1; i <= k; ++i) {
+            sum += i * a.c[i] * r.c[k - i];
+        }
+        r.c[k] = sum / k;
+    }
+    return r;
+}
+
+// a·l' = a': l_k = (a_k - (1/k)·Σ_{i=1..k-1} i·l_i·a_{k-i}) / a_0
+template <int N>
+inline Jet<N> log(const Jet<N>& a)
+{
+    Jet<N> r;
+    r.c[0] = std::log(a.c[0]);
+    for (int k = 1; k <= N; ++k) {
+        double sum = 0.0;
+        for (int i = 1; i < k; ++i) {
+            sum += i * r.c[i] * a.c[k - i];
+        }
+        r.c[k] = (a.c[k] - sum / k) / a.c[0];
+    }
+    return r;
+}
+
+// sin и cos считаются совместно: s' = a'·c, c' = -a'·s
+template <int N>
+inline void sinCos(const Jet<N>& a, Jet<N>& s, Jet<N>& co)
+{
+    s.c[0] = std::sin(a.c[0]);
+    co.c[0] = std::cos(a.c[0]);
+    for (int k = 1; k <= N; ++k) {
+        double sumS = 0.0;
+        double sumC = 0.0;
+        for (int i = 1; i <= k; ++i) {
+            sumS += i * a.c[i] * co.c[k - i];
+            sumC += i * a.c[i] * s.c[k - i];
+        }
+        s.c[k] = sumS / k;
+        co.c[k] = -sumC / k;
+    }
+}
+
+template <int N>
+inline Jet<N> sin(const Jet<N>& a)
+{
+    Jet<N> s, co;
+    sinCos(a, s, co);
+    return s;
+}
+
+template <int N>
+inline Jet<N> cos(const Jet<N>& a)
+{
+    Jet<N> s, co;
+    sinCos(a, s, co);
+    return co;
+}
+
+template <int N>
+inline Jet<N> tan(const Jet<N>& a)
+{
+    Jet<N> s, co;
+    sinCos(a, s, co);
+    return s / co;
+}
+
+// r² = a: r_k = (a_k - Σ_{i=1..k-1} r_i·r_{k-i}) / (2·r_0)
+template <int N>
+inline Jet<N> sqrt(const Jet<N>& a)
+{
+    Jet<N> r;
+    r.c[0] = std::sqrt(a.c[0]);
+    for (int k = 1; k <= N; ++k) {
+        double sum = a.c[k];
+        for (int i = 1; i < k; ++i) {
+            sum -= r.c[i] * r.c[k - i];
+        }
+        r.c[k] = sum / (2.0 * r.c[0]);
+    }
+    return r;
+}
+
+template <int N>
+inline Jet<N> abs(const Jet<N>& a)
+{
+    return a.c[0] < 0 ? -a : a;
+}
+
+/**
+ * @brief Степень с рядом в показателе
+ *
+ * @details
+ * Для постоянного показателя b используется рекуррентность для a^b
+ * (a·p' = b·a'·p), которая работает и для отрицательного основания;
+ * общий случай — exp(b·log a).
+ */
+template <int N>
+inline Jet<N> pow(const Jet<N>& a, const Jet<N>& b)
+{
+    bool constantExponent = true;
+    for (int k = 1; k <= N; ++k) {
+        constantExponent = constantExponent && b.c[k] == 0.0;
+    }
+    if (!constantExponent || a.c[0] == 0.0) {
+        return exp(b * log(a));
+    }
+
+    const double e = b.c[0];
+    Jet<N> r;
+    r.c[0] = std::pow(a.c[0], e);
+    for (int k = 1; k <= N; ++k) {
+        double sum = 0.0;
+        for (int i = 1; i <= k; ++i) {
+            sum += (e * i - (k - i)) * a.c[i] * r.c[k - i];
+        }
+        r.c[k] = sum / (k * a.c[0]);
+    }
+    return r;
+}
+
+#endif // JET_H
@@ -0,0 +1,72 @@
+/**
+ * @file keyedscatter.cpp
+ * @brief Реализация ключевой перестановки отсчётов
+ * @date 2024
+ */
+
+#include "keyedscatter.h"
+#include <QCryptographicHash>
+#include <QtEndian>
+#include <cstring>
+
+namespace {
+
+// Stride = 0 — размер отсчёта задаётся во время выполнения
+template <int Stride>
+void gather(const char* samples, int stride, const quint64* indices, qint64 count, char* buffer)
+{
+    const int step = Stride ? Stride : stride;
+    for (qint64 i = 0; i < count; ++i) {
+        memcpy(buffer + i * step, samples + indices[i] * step, step);
+    }
+}
+
+template <int Stride>
+void scatter(char* samples, int stride, const quint64* indices, qint64 count, const char* buffer)
+{
+    const int step = Stride ? Stride : stride;
+    for (qint64 i = 0; i < count; ++i) {
+        memcpy(samples + indices[i] * step, buffer + i * step, step);
+    }
+}
+
+} // namespace
+
+ScatterPermutation::ScatterPermutation(quint64 domain, const QByteArray& key)
+    : size(qMax<quint64>(1, domain))
+{
+    // Наименьшее h, при котором 4^h >= n (не меньше 1 бита на половину)
+    int bits = 2;
+    while (bits < 64 && (quint64(1) << bits) < size) {
+        bits += 2;
+    }
+    halfBits = bits / 2;
+    halfMask = (quint64(1) << halfBits) - 1;
+
+    for (int r = 0; r < ROUNDS; ++r) {
+        const QByteArray digest = QCryptographicHash::hash(key + char(r), QCryptographicHash::Sha256);
+        roundKeys[r] = qFromLittleEndian<quint64>(reinterpret_cast<const uchar*>(digest.constData()));
+    }
+}
+
+void gatherSamples(const char* samples, int stride, const quint64* indices, qint64 count, char* buffer)
+{
+    switch (stride) {
+    case 1: gather<1>(samples, 1, indices, count, buffer); break;
+    case 2: gather<2>(samples, 2, indices, count, buffer); break;
+    case 3: gather<3>(samples, 3, indices, count, buffer); break;
+    case 4: gather<4>(samples, 4, indices, count, buffer); break;
+    default: gather<0>(samples, stride, indices, count, buffer); break;
+    }
+}
+
+void scatterSamples(char* samples, int stride, const quint64* indices, qint64 count, const char* buffer)
+{
+    switch (stride) {
+    case 1: scatter<1>(samples, 1, indices, count, buffer); break;
+    case 2: scatter<2>(samples, 2, indices, count, buffer); break;
+    case 3: scatter<3>(samples, 3, indices, count, buffer); break;
+    case 4: scatter<4>(samples, 4, indices, count, buffer); break;
+    default: scatter<0>(samples, stride, indices, count, buffer); break;
+    }
+}
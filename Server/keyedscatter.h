@@ -0,0 +1,138 @@
+/**
+ * @file keyedscatter.h
+ * @brief Ключевая перестановка отсчётов для рассеянного встраивания
+ * @date 2024
+ *
+ * @details
+ * При последовательном встраивании сообщение занимает начало блока
+ * отсчётов: искажения сосредоточены в одном месте, а сам факт
+ * встраивания легко обнаружить. При рассеянном встраивании отсчёт
+ * сообщения i записывается в отсчёт файла permutation.map(i), где
+ * перестановка всех отсчётов задаётся ключом.
+ *
+ * Перестановка не хранится: map() вычисляется за O(1) памяти
+ * сбалансированной сетью Фейстеля на 2h битах (4^h — наименьшая
+ * степень четырёх, не меньшая числа отсчётов n). Значения за пределами
+ * [0, n) снова пропускаются через сеть (cycle walking), пока не попадут
+ * в диапазон; так как 4^h < 4n, в среднем хватает меньше четырёх
+ * проходов. Раундовые ключи выводятся из ключа через SHA-256, раундовая
+ * функция — два умножения с перемешиванием, результат — старшие биты
+ * произведения. Четыре раунда — минимум, при котором сеть Фейстеля
+ * неотличима от случайной перестановки (Луби — Ракофф).
+ * Это скрывает положение сообщения, но не шифрует его: для тайны
+ * содержимого сообщение нужно зашифровать отдельно.
+ *
+ * Каждый индекс вычисляется независимо, поэтому диапазон отсчётов
+ * сообщения делится между потоками без синхронизации.
+ *
+ * @see wavembed.h
+ */
+
+#ifndef KEYEDSCATTER_H
+#define KEYEDSCATTER_H
+
+#include <QByteArray>
+
+/**
+ * @brief Перестановка [0, n), заданная ключом
+ *
+ * @example
+ * @code
+ * ScatterPermutation permutation(sampleCount, "secret");
+ * quint64 position = permutation.map(0);   // отсчёт первого бита сообщения
+ * // permutation.unmap(position) == 0
+ * @endcode
+ */
+class ScatterPermutation {
+public:
+    /// Число раундов сети Фейстеля
+    static const int ROUNDS = 4;
+
+    /**
+     * @brief Конструктор
+     * @param domain Размер области n (не меньше 1, не больше 2^62)
+     * @param key Ключ
+     */
+    ScatterPermutation(quint64 domain, const QByteArray& key);
+
+    /// Размер области
+    quint64 domain() const { return size; }
+
+    /// Образ индекса index < domain()
+    quint64 map(quint64 index) const
+    {
+        do {
+            index = encrypt(index);
+        } while (index >= size);
+        return index;
+    }
+
+    /// Прообраз индекса: unmap(map(i)) == i
+    quint64 unmap(quint64 index) const
+    {
+        do {
+            index = decrypt(index);
+        } while (index >= size);
+        return index;
+    }
+
+private:
+    // Старшие биты произведения зависят от всех битов половины
+    quint64 round(int r, quint64 half) const
+    {
+        quint64 x = (half ^ roundKeys[r]) * 0x9E3779B97F4A7C15ull;
+        x = (x ^ (x >> 29)) * 0xBF58476D1CE4E5B9ull;
+        return x >> (64 - halfBits);
+    }
+
+    quint64 encrypt(quint64 x) const
+    {
+        quint64 left = x >> halfBits;
+        quint64 right = x & halfMask;
+        for (int r = 0; r < ROUNDS; ++r) {
+            const quint64 next = left ^ round(r, right);
+            left = right;
+            right = next;
+        }
+        return (left << halfBits) | right;
+    }
+
+    quint64 decrypt(quint64 x) const
+    {
+        quint64 left = x >> halfBits;
+        quint64 right = x & halfMask;
+        for (int r = ROUNDS - 1; r >= 0; --r) {
+            const quint64 previous = right ^ round(r, left);
+            right = left;
+            left = previous;
+        }
+        return (left << halfBits) | right;
+    }
+
+    quint64 size;
+    int halfBits;
+    quint64 halfMask;
+    quint64 roundKeys[ROUNDS];
+};
+
+/**
+ * @brief Собирает отсчёты с заданными номерами подряд
+ * @param samples Первый отсчёт блока
+ * @param stride Размер отсчёта, байт
+ * @param indices Номера отсчётов
+ * @param count Число отсчётов
+ * @param buffer Буфер на count · stride байт
+ */
+void gatherSamples(const char* samples, int stride, const quint64* indices, qint64 count, char* buffer);
+
+/**
+ * @brief Раскладывает отсчёты из буфера обратно по номерам
+ * @param samples Первый отсчёт блока
+ * @param stride Размер отсчёта, байт
+ * @param indices Номера отсчётов
+ * @param count Число отсчётов
+ * @param buffer Отсчёты подряд, count · stride байт
+ */
+void scatterSamples(char* samples, int stride, const quint64* indices, qint64 count, const char* buffer);
+
+#endif // KEYEDSCATTER_H
@@ -0,0 +1,331 @@
+/**
+ * @file lsbkernels.cpp
+ * @brief Реализация ядер встраивания и извлечения младших битов
+ * @date 2024
+ */
+
+#include "lsbkernels.h"
+#include "cpufeatures.h"
+#include <QtEndian>
+
+namespace {
+
+const quint64 LSB_MASK = 0x0101010101010101ull;
+
+// Умножение переносит бит байта k (позиция 8k) в бит 63 - k: старший байт
+// произведения — восемь младших битов, первый байт обложки в старшем бите
+const quint64 GATHER_MULTIPLIER = 0x8040201008040201ull;
+
+// Для каждого байта сообщения — слово, где байт k равен биту 7 - k
+struct SpreadTable {
+    quint64 entries[256];
+
+    SpreadTable()
+    {
+        for (int m = 0; m < 256; ++m) {
+            quint64 word = 0;
+            for (int k = 0; k < 8; ++k) {
+                word |= quint64((m >> (7 - k)) & 1) << (8 * k);
+            }
+            entries[m] = word;
+        }
+    }
+};
+
+void embedScalar(uchar* cover, const uchar* message, qint64 count)
+{
+    static const SpreadTable table;
+    for (qint64 i = 0; i < count; ++i) {
+        uchar* p = cover + i * 8;
+        const quint64 word = (qFromLittleEndian<quint64>(p) & ~LSB_MASK) | table.entries[message[i]];
+        qToLittleEndian(word, p);
+    }
+}
+
+void extractScalar(const uchar* cover, uchar* message, qint64 count)
+{
+    for (qint64 i = 0; i < count; ++i) {
+        const quint64 bits = qFromLittleEndian<quint64>(cover + i * 8) & LSB_MASK;
+        message[i] = uchar((bits * GATHER_MULTIPLIER) >> 56);
+    }
+}
+
+#if HAVE_X86_SIMD
+
+// 32 байта обложки за шаг: 4 байта сообщения; возвращает число обработанных байт сообщения
+TARGET_AVX2 qint64 embedAvx2(uchar* cover, const uchar* message, qint64 count)
+{
+    // Байт сообщения j размножается на позиции 8j..8j+7 (в каждой 128-битной половине — два байта)
+    const __m256i spread = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+                                            2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+    const __m256i bitMask = _mm256_set1_epi64x(0x0102040810204080ll);
+    const __m256i one = _mm256_set1_epi8(1);
+    qint64 i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i* p = reinterpret_cast<__m256i*>(cover + i * 8);
+        const __m256i bytes = _mm256_shuffle_epi8(_mm256_set1_epi32(qFromUnaligned<qint32>(message + i)), spread);
+        const __m256i set = _mm256_cmpeq_epi8(_mm256_and_si256(bytes, bitMask), bitMask);
+        const __m256i c = _mm256_loadu_si256(p);
+        _mm256_storeu_si256(p, _mm256_blendv_epi8(_mm256_andnot_si256(one, c), _mm256_or_si256(c, one), set));
+    }
+    return i;
+}
+
+TARGET_AVX2 qint64 extractAvx2(const uchar* cover, uchar* message, qint64 count)
+{
+    // Разворот каждой восьмёрки байт: первый байт обложки даёт старший бит байта сообщения
+    const __m256i reverse = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                                             7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    qint64 i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cover + i * 8));
+        const __m256i msb = _mm256_slli_epi64(_mm256_shuffle_epi8(c, reverse), 7);
+        qToUnaligned(quint32(_mm256_movemask_epi8(msb)), message + i);
+    }
+    return i;
+}
+
+#endif // HAVE_X86_SIMD
+
+// k битов сообщения, начиная с бита bit (старший первым); за концом — нули
+inline uint messageBits(const uchar* message, qint64 size, qint64 bit, int k)
+{
+    const qint64 byte = bit >> 3;
+    if (byte >= size) {
+        return 0;
+    }
+    uint window = uint(message[byte]) << 8;
+    if (byte + 1 < size) {
+        window |= message[byte + 1];
+    }
+    return (window >> (16 - k - (bit & 7))) & ((1u << k) - 1);
+}
+
+// Поле отсчёта шириной до 16 бит: bits бит начиная с бита offset байта index
+struct SampleField {
+    int index;
+    int offset;
+    uint mask;
+    bool wide;  // поле заходит в следующий байт
+
+    explicit SampleField(const LsbLayout& layout)
+        : index(layout.shift / 8), offset(layout.shift % 8), mask((1u << layout.bits) - 1),
+          wide(layout.shift % 8 + layout.bits > 8)
+    {
+    }
+
+    uint read(const uchar* sample) const
+    {
+        const uint window = wide ? uint(sample[index]) | (uint(sample[index + 1]) << 8) : sample[index];
+        return (window >> offset) & mask;
+    }
+
+    void write(uchar* sample, uint value) const
+    {
+        sample[index] = uchar((sample[index] & ~(mask << offset)) | (value << offset));
+        if (wide) {
+            const int high = 8 - offset;
+            sample[index + 1] = uchar((sample[index + 1] & ~(mask >> high)) | (value >> high));
+        }
+    }
+};
+
+// Восемь отсчётов по K бит несут ровно K байт сообщения: группа
+// обрабатывается без проверки границ. Stride = 0 — шаг задаётся во время выполнения
+template <int Stride, int K>
+void embedGroups(uchar* samples, qint64 groups, int stride, SampleField field, const uchar* message)
+{
+    // Поле передаётся по значению: запись через uchar* иначе заставляет перечитывать его на каждом отсчёте
+    const int step = Stride ? Stride : stride;
+    for (qint64 g = 0; g < groups; ++g, message += K, samples += 8 * step) {
+        quint32 value = 0;
+        for (int b = 0; b < K; ++b) {
+            value = (value << 8) | message[b];
+        }
+        for (int j = 0; j < 8; ++j) {
+            field.write(samples + j * step, (value >> (K * (7 - j))) & ((1u << K) - 1));
+        }
+    }
+}
+
+template <int Stride, int K>
+void extractGroups(const uchar* samples, qint64 groups, int stride, SampleField field, uchar* message)
+{
+    const int step = Stride ? Stride : stride;
+    for (qint64 g = 0; g < groups; ++g, message += K, samples += 8 * step) {
+        quint32 value = 0;
+        for (int j = 0; j < 8; ++j) {
+            value = (value << K) | field.read(samples + j * step);
+        }
+        for (int b = 0; b < K; ++b) {
+            message[b] = uchar(value >> (8 * (K - 1 - b)));
+        }
+    }
+}
+
+template <int Stride>
+void embedSamples(uchar* samples, qint64 count, int stride, const SampleField& field, int k,
+                  const uchar* message, qint64 size, qint64 firstSample)
+{
+    const int step = Stride ? Stride : stride;
+    auto embedOne = [&](qint64 i) {
+        field.write(samples + i * step, messageBits(message, size, (firstSample + i) * k, k));
+    };
+
+    // Начало до границы группы
+    qint64 i = 0;
+    for (; i < count && (firstSample + i) % 8 != 0; ++i) {
+        embedOne(i);
+    }
+    // Целые группы, пока хватает сообщения
+    const qint64 byte = (firstSample + i) * k / 8;
+    const qint64 groups = qMax<qint64>(0, qMin((count - i) / 8, (size - byte) / k));
+    uchar* first = samples + i * step;
+    switch (k) {
+    case 1: embedGroups<Stride, 1>(first, groups, step, field, message + byte); break;
+    case 2: embedGroups<Stride, 2>(first, groups, step, field, message + byte); break;
+    case 3: embedGroups<Stride, 3>(first, groups, step, field, message + byte); break;
+    case 4: embedGroups<Stride, 4>(first, groups, step, field, message + byte); break;
+    }
+    // Хвост
+    for (i += groups * 8; i < count; ++i) {
+        embedOne(i);
+    }
+}
+
+template <int Stride>
+void extractSamples(const uchar* samples, int stride, const SampleField& field, int k, int skip,
+                    uchar* message, qint64 count)
+{
+    const int step = Stride ? Stride : stride;
+
+    // Без пропуска битов байты сообщения идут целыми группами
+    qint64 produced = 0;
+    if (skip == 0) {
+        const qint64 groups = count / k;
+        switch (k) {
+        case 1: extractGroups<Stride, 1>(samples, groups, step, field, message); break;
+        case 2: extractGroups<Stride, 2>(samples, groups, step, field, message); break;
+        case 3: extractGroups<Stride, 3>(samples, groups, step, field, message); break;
+        case 4: extractGroups<Stride, 4>(samples, groups, step, field, message); break;
+        }
+        produced = groups * k;
+        samples += groups * 8 * step;
+        if (produced == count) {
+            return;
+        }
+    }
+
+    // Остаток — через накопитель битов
+    uint acc = field.read(samples) & ((1u << (k - skip)) - 1);
+    int accBits = k - skip;
+    const uchar* sample = samples + step;
+    while (produced < count) {
+        if (accBits >= 8) {
+            accBits -= 8;
+            message[produced++] = uchar(acc >> accBits);
+            acc &= (1u << accBits) - 1;
+            continue;
+        }
+        acc = (acc << k) | field.read(sample);
+        accBits += k;
+        sample += step;
+    }
+}
+
+} // namespace
+
+void embedLsbBytes(char* cover, const char* message, qint64 count)
+{
+    uchar* dst = reinterpret_cast<uchar*>(cover);
+    const uchar* src = reinterpret_cast<const uchar*>(message);
+    qint64 done = 0;
+#if HAVE_X86_SIMD
+    if (useAvx2()) {
+        done = embedAvx2(dst, src, count);
+    }
+#endif
+    embedScalar(dst + done * 8, src + done, count - done);
+}
+
+void extractLsbBytes(const char* cover, char* message, qint64 count)
+{
+    const uchar* src = reinterpret_cast<const uchar*>(cover);
+    uchar* dst = reinterpret_cast<uchar*>(message);
+    qint64 done = 0;
+#if HAVE_X86_SIMD
+    if (useAvx2()) {
+        done = extractAvx2(src, dst, count);
+    }
+#endif
+    extractScalar(src + done * 8, dst + done, count - done);
+}
+
+void embedLsbBits(char* cover, qint64 count, const char* message, qint64 firstBit)
+{
+    const uchar* bits = reinterpret_cast<const uchar*>(message);
+    auto embedBit = [&](qint64 i) {
+        const qint64 bit = firstBit + i;
+        cover[i] = char((cover[i] & 0xFE) | ((bits[bit >> 3] >> (7 - (bit & 7))) & 1));
+    };
+
+    // Начало до границы байта сообщения
+    qint64 i = 0;
+    for (; i < count && ((firstBit + i) & 7) != 0; ++i) {
+        embedBit(i);
+    }
+    // Целые байты
+    const qint64 whole = (count - i) / 8;
+    embedLsbBytes(cover + i, message + ((firstBit + i) >> 3), whole);
+    // Хвост
+    for (i += whole * 8; i < count; ++i) {
+        embedBit(i);
+    }
+}
+
+void embedSampleBits(char* samples, qint64 count, const LsbLayout& layout,
+                     const char* message, qint64 messageSize, qint64 firstSample)
+{
+    const SampleField field(layout);
+    const int k = layout.bits;
+    uchar* dst = reinterpret_cast<uchar*>(samples);
+    const uchar* src = reinterpret_cast<const uchar*>(message);
+
+    // Байтовые отсчёты с одним битом — байтовые ядра, пока хватает сообщения
+    if (layout.stride == 1 && layout.shift == 0 && k == 1) {
+        const qint64 inside = qBound<qint64>(0, messageSize * 8 - firstSample, count);
+        embedLsbBits(samples, inside, message, firstSample);
+        embedSamples<1>(dst + inside, count - inside, 1, field, k, src, messageSize, firstSample + inside);
+        return;
+    }
+    switch (layout.stride) {
+    case 1: embedSamples<1>(dst, count, 1, field, k, src, messageSize, firstSample); break;
+    case 2: embedSamples<2>(dst, count, 2, field, k, src, messageSize, firstSample); break;
+    case 3: embedSamples<3>(dst, count, 3, field, k, src, messageSize, firstSample); break;
+    case 4: embedSamples<4>(dst, count, 4, field, k, src, messageSize, firstSample); break;
+    default: embedSamples<0>(dst, count, layout.stride, field, k, src, messageSize, firstSample); break;
+    }
+}
+
+void extractSampleBits(const char* samples, const LsbLayout& layout, int skipBits, char* message, qint64 count)
+{
+    if (count <= 0) {
+        return;
+    }
+    const SampleField field(layout);
+    const int k = layout.bits;
+    const uchar* src = reinterpret_cast<const uchar*>(samples);
+    uchar* dst = reinterpret_cast<uchar*>(message);
+
+    if (layout.stride == 1 && layout.shift == 0 && k == 1) {
+        extractLsbBytes(samples, message, count);
+        return;
+    }
+    switch (layout.stride) {
+    case 1: extractSamples<1>(src, 1, field, k, skipBits, dst, count); break;
+    case 2: extractSamples<2>(src, 2, field, k, skipBits, dst, count); break;
+    case 3: extractSamples<3>(src, 3, field, k, skipBits, dst, count); break;
+    case 4: extractSamples<4>(src, 4, field, k, skipBits, dst, count); break;
+    default: extractSamples<0>(src, layout.stride, field, k, skipBits, dst, count); break;
+    }
+}
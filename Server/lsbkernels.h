@@ -0,0 +1,108 @@
+/**
+ * @file lsbkernels.h
+ * @brief Ядра встраивания и извлечения младших битов
+ * @date 2024
+ *
+ * @details
+ * Байт сообщения занимает младшие биты восьми подряд идущих байт
+ * обложки, старший бит первым.
+ *
+ * - Встраивание (AVX2): четыре байта сообщения размножаются
+ *   перестановкой байт (vpshufb) по 32 позициям, сравнение с маской
+ *   бита позиции даёт 0xFF для единичных битов, и blend выбирает
+ *   байт обложки с установленным или сброшенным младшим битом.
+ *   32 байта обложки за шаг.
+ * - Извлечение (AVX2): перестановка разворачивает порядок байт в каждой
+ *   восьмёрке, сдвиг переносит младший бит в старший, и movemask
+ *   собирает 32 бита — сразу четыре байта сообщения.
+ * - Скалярный путь обрабатывает по 8 байт обложки как одно 64-битное
+ *   слово: при встраивании — маской и таблицей из 256 слов,
+ *   при извлечении — умножением, собирающим восемь бит в старший байт.
+ *
+ * Выбор пути — во время выполнения (useAvx2(), cpufeatures.h).
+ *
+ * Для многобайтовых отсчётов embedSampleBits() и extractSampleBits()
+ * используют k младших битов каждого отсчёта (LsbLayout). Восемь
+ * отсчётов несут ровно k байт сообщения, поэтому основная часть
+ * обрабатывается такими группами без проверки границ, а k и размер
+ * отсчёта (1, 2, 3 и 4 байта: целые 8/16/24/32 бита и float32) —
+ * параметры шаблона. Отсчёты из одного байта с k = 1 идут через
+ * байтовые ядра.
+ *
+ * @see wavembed.h
+ */
+
+#ifndef LSBKERNELS_H
+#define LSBKERNELS_H
+
+#include <QtGlobal>
+
+/**
+ * @brief Встраивает байты сообщения в младшие биты обложки
+ * @param cover Обложка, 8 · count байт
+ * @param message Сообщение, count байт
+ * @param count Число байт сообщения
+ */
+void embedLsbBytes(char* cover, const char* message, qint64 count);
+
+/**
+ * @brief Извлекает байты сообщения из младших битов обложки
+ * @param cover Обложка, 8 · count байт
+ * @param message Буфер сообщения, count байт
+ * @param count Число байт сообщения
+ */
+void extractLsbBytes(const char* cover, char* message, qint64 count);
+
+/**
+ * @brief Встраивает произвольный отрезок битов сообщения
+ * @param cover Обложка; cover[i] получает бит firstBit + i
+ * @param count Число байт обложки (битов сообщения)
+ * @param message Сообщение
+ * @param firstBit Номер первого встраиваемого бита сообщения
+ *
+ * @details
+ * Неполные байты сообщения в начале и в конце отрезка встраиваются
+ * побитно, остальные — embedLsbBytes().
+ */
+void embedLsbBits(char* cover, qint64 count, const char* message, qint64 firstBit);
+
+/**
+ * @brief Расположение битов сообщения в отсчётах
+ *
+ * @details
+ * Отсчёт i несёт биты сообщения [i·bits, i·bits + bits) как число
+ * (первый бит — старший) в битах [shift, shift + bits) отсчёта,
+ * записанного в порядке little-endian.
+ */
+struct LsbLayout {
+    int stride;     ///< Размер отсчёта, байт
+    int shift;      ///< Номер младшего используемого бита отсчёта
+    int bits;       ///< Битов сообщения на отсчёт (1–4)
+
+    /// По умолчанию — младший бит каждого байта
+    LsbLayout(int stride = 1, int shift = 0, int bits = 1) : stride(stride), shift(shift), bits(bits) {}
+};
+
+/**
+ * @brief Встраивает биты сообщения в отсчёты
+ * @param samples Первый обрабатываемый отсчёт
+ * @param count Число отсчётов
+ * @param layout Расположение битов
+ * @param message Сообщение
+ * @param messageSize Длина сообщения, байт; биты за её концом считаются нулями
+ * @param firstSample Номер первого отсчёта от начала сообщения
+ */
+void embedSampleBits(char* samples, qint64 count, const LsbLayout& layout,
+                     const char* message, qint64 messageSize, qint64 firstSample);
+
+/**
+ * @brief Извлекает байты сообщения из отсчётов
+ * @param samples Первый читаемый отсчёт
+ * @param layout Расположение битов
+ * @param skipBits Сколько битов первого отсчёта пропустить (меньше layout.bits)
+ * @param message Буфер сообщения
+ * @param count Число байт сообщения
+ */
+void extractSampleBits(const char* samples, const LsbLayout& layout, int skipBits, char* message, qint64 count);
+
+#endif // LSBKERNELS_H
@@ -10,79 +10,250 @@
  */
 
 #include "newton.h"
+#include "expression.h"
+#include "newtonstats.h"
 #include <QDebug>
 #include <cmath>
+#include <cstring>
+#include <limits>
 
 // Максимальное количество итераций
 const int MAX_ITERATIONS = 100;
 
-// Функция для вычисления значения уравнения
-double evaluateFunction(const QString& equation, double x) {
-    // TODO: Реализовать парсинг и вычисление уравнения
-    // Временная заглушка для примера
-    return x * x - 4; // x^2 - 4
+// Значение уравнения и его производная за один проход (дуальные числа)
+Dual evaluateWithDerivative(const Expression& equation, double x) {
+    return equation.evaluate(Dual(x, 1.0));
 }
 
-// Функция для вычисления производной
-double evaluateDerivative(const QString& equation, double x) {
-    // TODO: Реализовать вычисление производной
-    // Временная заглушка для примера
-    return 2 * x; // производная от x^2 - 4
+namespace {
+
+/// Значение и производные уравнения в точке
+struct Derivatives {
+    double f;
+    double d1;
+    double d2;
+    double d3;
+};
+
+// Вычисляет столько производных, сколько нужно методу, одним проходом байткода
+template <RootMethod Method>
+Derivatives derivativesAt(const Expression& equation, double x);
+
+template <>
+Derivatives derivativesAt<RootMethod::Newton>(const Expression& equation, double x)
+{
+    const Dual y = evaluateWithDerivative(equation, x);
+    return Derivatives{y.value, y.derivative, 0.0, 0.0};
 }
 
-QString solveNewton(const QString& equation, double initialGuess, double tolerance)
+template <>
+Derivatives derivativesAt<RootMethod::Halley>(const Expression& equation, double x)
 {
-    try {
-        double x = initialGuess;
-        double fx, dfx;
-        int iterations = 0;
+    const Jet<2> y = equation.evaluate(Jet<2>::variable(x));
+    return Derivatives{y.value(), y.derivative(1), y.derivative(2), 0.0};
+}
+
+template <>
+Derivatives derivativesAt<RootMethod::Householder3>(const Expression& equation, double x)
+{
+    const Jet<3> y = equation.evaluate(Jet<3>::variable(x));
+    return Derivatives{y.value(), y.derivative(1), y.derivative(2), y.derivative(3)};
+}
+
+// Шаг метода; при нулевом знаменателе формулы высшего порядка — шаг Ньютона
+template <RootMethod Method>
+double methodStep(const Derivatives& d)
+{
+    const double newton = d.f / d.d1;
+    double numerator = 0.0;
+    double denominator = 0.0;
+    if (Method == RootMethod::Halley) {
+        // 2·f·f' / (2·f'^2 - f·f'')
+        numerator = 2.0 * d.f * d.d1;
+        denominator = 2.0 * d.d1 * d.d1 - d.f * d.d2;
+    } else if (Method == RootMethod::Householder3) {
+        // (6·f·f'^2 - 3·f^2·f'') / (6·f'^3 - 6·f·f'·f'' + f^2·f''')
+        numerator = 6.0 * d.f * d.d1 * d.d1 - 3.0 * d.f * d.f * d.d2;
+        denominator = 6.0 * d.d1 * d.d1 * d.d1 - 6.0 * d.f * d.d1 * d.d2 + d.f * d.f * d.d3;
+    } else {
+        return newton;
+    }
 
-        do {
-            fx = evaluateFunction(equation, x);
-            dfx = evaluateDerivative(equation, x);
+    const double step = numerator / denominator;
+    return denominator != 0.0 && std::isfinite(step) ? step : newton;
+}
 
-            if (std::abs(dfx) < tolerance) {
-                return "Error: Derivative too close to zero";
-            }
+/**
+ * Итерации выбранного метода. derivatives(x) возвращает значение и
+ * производные уравнения; цикл общий для скомпилированного выражения
+ * и для уравнений, вычисляемых напрямую.
+ *
+ * Шаг сравнивается с tolerance·max(1, |x|): у больших корней абсолютный
+ * шаг не может стать меньше расстояния между соседними double.
+ */
+template <RootMethod Method, typename Eval>
+EquationSolution iterateEquation(Eval derivatives, double initialGuess, double tolerance)
+{
+    EquationSolution solution;
+    double x = initialGuess;
 
-            double nextX = x - fx / dfx;
-            if (std::abs(nextX - x) < tolerance) {
-                return QString::number(nextX, 'f', 6);
+    while (solution.evaluations < MAX_ITERATIONS) {
+        const Derivatives d = derivatives(x);
+        ++solution.evaluations;
+
+        if (std::abs(d.d1) < tolerance) {
+            solution.root = x;
+            solution.error = "Derivative too close to zero";
+            return solution;
+        }
+
+        const double nextX = x - methodStep<Method>(d);
+        if (!std::isfinite(nextX)) {
+            solution.root = x;
+            solution.error = "Iteration diverged";
+            return solution;
+        }
+        if (std::abs(nextX - x) <= tolerance * qMax(1.0, std::abs(nextX))) {
+            solution.root = nextX;
+            solution.converged = true;
+            return solution;
         }
+        x = nextX;
+    }
 
-            x = nextX;
-            iterations++;
-        } while (iterations < MAX_ITERATIONS);
+    solution.root = x;
+    solution.error = "Maximum iterations reached";
+    return solution;
+}
 
-        return "Error: Maximum iterations reached";
+template <RootMethod Method>
+EquationSolution iterateEquation(const Expression& equation, double initialGuess, double tolerance)
+{
+    return iterateEquation<Method>([&equation](double x) {
+        return derivativesAt<Method>(equation, x);
+    }, initialGuess, tolerance);
+}
+
+template <RootMethod Method>
+EquationSolution iterateSquareRoot(double number, double tolerance)
+{
+    // Ноль и точные квадраты — без итераций, как в Newton::calculateRoot
+    EquationSolution solution;
+    if (Newton::trivialRoot(number, 2, solution.root)) {
+        solution.converged = true;
+        return solution;
     }
-    catch (const std::exception& e) {
-        return QString("Error: %1").arg(e.what());
+
+    // x^2 - reduced для reduced из [1, 4): производные известны, разбор текста
+    // не нужен, а x^2 не переполняется при любом number
+    const RootSeed seed = Newton::initialGuess(number, 2);
+    const double reduced = seed.reduced;
+    solution = iterateEquation<Method>([reduced](double x) {
+        return Derivatives{x * x - reduced, 2.0 * x, 2.0, 0.0};
+    }, seed.guess, tolerance);
+    solution.root = Newton::finishRoot(seed, solution.root, number, 2);
+    return solution;
+}
+
+} // namespace
+
+bool parseRootMethod(const QString& name, RootMethod& method)
+{
+    const QString key = name.trimmed().toLower();
+    if (key == "newton") {
+        method = RootMethod::Newton;
+    } else if (key == "halley") {
+        method = RootMethod::Halley;
+    } else if (key == "householder" || key == "householder3") {
+        method = RootMethod::Householder3;
+    } else {
+        return false;
     }
+    return true;
 }
 
-double Newton::calculateRoot(double number, int power)
+QString rootMethodName(RootMethod method)
 {
-    if (power <= 0) {
-        return 0.0;
+    switch (method) {
+    case RootMethod::Halley:       return "halley";
+    case RootMethod::Householder3: return "householder";
+    default:                       return "newton";
+    }
+}
+
+EquationSolution solveEquation(const Expression& f, double initialGuess, double tolerance, RootMethod method)
+{
+    switch (method) {
+    case RootMethod::Halley:
+        return iterateEquation<RootMethod::Halley>(f, initialGuess, tolerance);
+    case RootMethod::Householder3:
+        return iterateEquation<RootMethod::Householder3>(f, initialGuess, tolerance);
+    default:
+        return iterateEquation<RootMethod::Newton>(f, initialGuess, tolerance);
+    }
+}
+
+EquationSolution solveSquareRoot(double number, double tolerance, RootMethod method)
+{
+    if (!std::isfinite(number) || number < 0.0) {
+        EquationSolution solution;
+        solution.error = "Number must be finite and non-negative";
+        return solution;
     }
 
-    if (power == 1) {
-        return number;
+    switch (method) {
+    case RootMethod::Halley:
+        return iterateSquareRoot<RootMethod::Halley>(number, tolerance);
+    case RootMethod::Householder3:
+        return iterateSquareRoot<RootMethod::Householder3>(number, tolerance);
+    default:
+        return iterateSquareRoot<RootMethod::Newton>(number, tolerance);
     }
+}
 
-    // Начальное приближение
-    double x = number / 2.0;
+QString solveNewton(const QString& equation, double initialGuess, double tolerance, RootMethod method)
+{
+    try {
+        // Программа берётся из кэша: одно и то же уравнение разбирается один раз
+        std::shared_ptr<const Expression> program = ExpressionCache::instance().get(equation);
+
+        EquationSolution solution = solveEquation(*program, initialGuess, tolerance, method);
+        if (!solution.error.isEmpty()) {
+            return "Error: " + solution.error;
+        }
+        return QString::number(solution.root, 'f', 6);
+    }
+    catch (const std::exception& e) {
+        return QString("Error: %1").arg(e.what());
+    }
+}
+
+namespace {
+
+/**
+ * Итерации Ньютона для x^n - number. eval(x) возвращает значение
+ * функции и производную; тело цикла общее для специализированных
+ * ядер и для общего пути.
+ */
+template <typename Eval>
+double iterateRoot(double guess, Eval eval, int* iterations)
+{
+    double x = guess;
     const double epsilon = 1e-10;
     const int maxIterations = 100;
 
     for (int i = 0; i < maxIterations; ++i) {
-        double fx = function(x, power, number);
+        if (iterations) {
+            *iterations = i + 1;
+        }
+
+        Dual f = eval(x);
+        double fx = f.value;
         if (std::abs(fx) < epsilon) {
             break;
         }
 
-        double dfx = derivative(x, power);
+        double dfx = f.derivative;
         if (std::abs(dfx) < epsilon) {
             break;
         }
@@ -98,14 +269,206 @@ double Newton::calculateRoot(double number, int power)
     return x;
 }
 
-double Newton::derivative(double x, int n)
+// Ядро для степени N: x^(N-1) раскрывается при компиляции, x^N = x^(N-1)·x
+template <int N>
+double rootKernel(double number, int* iterations)
+{
+    const RootSeed seed = Newton::initialGuess(number, N);
+    const double reduced = seed.reduced;
+    const double x = iterateRoot(seed.guess, [reduced](double x) {
+        const double xPowNMinus1 = PowerKernel<N - 1>::pow(x);
+        return Dual(xPowNMinus1 * x - reduced, N * xPowNMinus1);
+    }, iterations);
+    return Newton::finishRoot(seed, x, number, N);
+}
+
+typedef double (*RootKernel)(double number, int* iterations);
+
+// Таблица диспетчеризации по степени; индексы 0 и 1 не используются
+const RootKernel ROOT_KERNELS[Newton::MAX_SPECIALIZED_POWER + 1] = {
+    nullptr, nullptr,
+    &rootKernel<2>, &rootKernel<3>, &rootKernel<4>, &rootKernel<5>,
+    &rootKernel<6>, &rootKernel<7>, &rootKernel<8>, &rootKernel<9>,
+    &rootKernel<10>, &rootKernel<11>, &rootKernel<12>, &rootKernel<13>,
+    &rootKernel<14>, &rootKernel<15>, &rootKernel<16>
+};
+
+// Граница, до которой целые числа представимы в double точно (2^53)
+const double EXACT_INTEGER_LIMIT = 9007199254740992.0;
+
+// Многочлен для log2(1 + t), t в [0, 1), абсолютная ошибка ~2e-4
+inline double log2Poly(double t)
+{
+    return t * (1.438547930 + t * (-0.678089456 + t * (0.323646308 + t * -0.084294656)));
+}
+
+// Многочлен для 2^t, t в [0, 1), относительная ошибка ~2e-4
+inline double exp2Poly(double t)
+{
+    return 0.999811963 + t * (0.696838576 + t * (0.224126444 + t * 0.079019940));
+}
+
+// Целая степень возведением в квадрат
+inline double intPower(double x, int n)
+{
+    double result = 1.0;
+    while (n > 0) {
+        if (n & 1) {
+            result *= x;
+        }
+        x *= x;
+        n >>= 1;
+    }
+    return result;
+}
+
+// Если candidate после округления — точный целый корень, записывает его в root
+bool exactIntegerRoot(double number, int power, double candidate, double& root)
+{
+    const double magnitude = std::abs(number);
+    if (magnitude >= EXACT_INTEGER_LIMIT || magnitude != std::floor(magnitude)) {
+        return false;
+    }
+    const double k = std::round(std::abs(candidate));
+    // Все промежуточные произведения не больше number < 2^53, поэтому точны
+    if (k < 1.0 || intPower(k, power) != magnitude) {
+        return false;
+    }
+    root = number < 0 ? -k : k;
+    return true;
+}
+
+} // namespace
+
+bool Newton::trivialRoot(double number, int power, double& root)
+{
+    if (power <= 0) {
+        root = 0.0;
+        return true;
+    }
+    if (power == 1 || number == 0.0 || std::isinf(number) || std::isnan(number)) {
+        root = number;
+        return true;
+    }
+    if (number < 0 && power % 2 == 0) {
+        root = std::numeric_limits<double>::quiet_NaN();
+        return true;
+    }
+
+    // Точная целая степень: округлённое приближение уже даёт корень
+    if (std::abs(number) < EXACT_INTEGER_LIMIT && std::abs(number) == std::floor(std::abs(number))) {
+        const RootSeed seed = initialGuess(number, power);
+        return exactIntegerRoot(number, power, std::ldexp(seed.guess, seed.exponent), root);
+    }
+    return false;
+}
+
+RootSeed Newton::initialGuess(double number, int power)
+{
+    RootSeed seed;
+    seed.negative = number < 0;
+
+    double magnitude = std::abs(number);
+    quint64 bits;
+    std::memcpy(&bits, &magnitude, sizeof(bits));
+    int exponent = int(bits >> 52) - 1023;
+
+    // Денормализованное число сначала переводится в нормализованное
+    if ((bits >> 52) == 0) {
+        magnitude *= 18446744073709551616.0;  // 2^64
+        std::memcpy(&bits, &magnitude, sizeof(bits));
+        exponent = int(bits >> 52) - 1023 - 64;
+    }
+
+    // Деление показателя на степень с округлением вниз: exponent = q·n + r
+    int q = exponent / power;
+    int r = exponent - q * power;
+    if (r < 0) {
+        --q;
+        r += power;
+    }
+
+    // Мантисса m из [1, 2) с показателем r: reduced = m·2^r из [1, 2^n)
+    const quint64 mantissaBits = bits & 0x000FFFFFFFFFFFFFULL;
+    const quint64 reducedBits = mantissaBits | (quint64(r + 1023) << 52);
+    std::memcpy(&seed.reduced, &reducedBits, sizeof(seed.reduced));
+
+    const quint64 oneBits = mantissaBits | (quint64(1023) << 52);
+    double m;
+    std::memcpy(&m, &oneBits, sizeof(m));
+
+    seed.guess = exp2Poly((r + log2Poly(m - 1.0)) / power);
+    seed.exponent = q;
+    return seed;
+}
+
+double Newton::finishRoot(const RootSeed& seed, double x, double number, int power)
+{
+    const double root = std::ldexp(seed.negative ? -x : x, seed.exponent);
+    double exact;
+    if (exactIntegerRoot(number, power, root, exact)) {
+        return exact;
+    }
+    return root;
+}
+
+double Newton::calculateRoot(double number, int power, int* iterations)
+{
+    int used = 0;
+    const double root = calculateRootUntracked(number, power, &used);
+
+    RootIterationStats::instance().record(power, used);
+    if (iterations) {
+        *iterations = used;
+    }
+    return root;
+}
+
+double Newton::calculateRootUntracked(double number, int power, int* iterations)
+{
+    int used = 0;
+    double root;
+    if (!trivialRoot(number, power, root)) {
+        if (power > MAX_SPECIALIZED_POWER) {
+            root = genericRoot(number, power, &used);
+        } else {
+            root = ROOT_KERNELS[power](number, &used);
+        }
+    }
+
+    if (iterations) {
+        *iterations = used;
+    }
+    return root;
+}
+
+double Newton::calculateRootGeneric(double number, int power, int* iterations)
+{
+    int used = 0;
+    double root;
+    if (!trivialRoot(number, power, root)) {
+        root = genericRoot(number, power, &used);
+    }
+
+    RootIterationStats::instance().record(power, used);
+    if (iterations) {
+        *iterations = used;
+    }
+    return root;
+}
+
+double Newton::genericRoot(double number, int power, int* iterations)
 {
-    return n * std::pow(x, n - 1);
+    const RootSeed seed = initialGuess(number, power);
+    const double x = iterateRoot(seed.guess, [this, power, &seed](double x) {
+        return function(Dual(x, 1.0), power, seed.reduced);
+    }, iterations);
+    return finishRoot(seed, x, number, power);
 }
 
-double Newton::function(double x, int n, double number)
+Dual Newton::function(const Dual& x, int n, double number)
 {
-    return std::pow(x, n) - number;
+    return pow(x, Dual(n)) - Dual(number);
 }
 
 double newtonMethod(double value)
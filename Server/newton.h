@@ -6,55 +6,236 @@
  * @details
  * Реализует функцию для нахождения корня уравнения методом Ньютона.
  * Используется в задаче 2 для решения нелинейных уравнений.
+ *
+ * Корень n-й степени ищется в приведённом виде: показатель IEEE-754
+ * делится на n, и задача масштабируется точным умножением на степень
+ * двойки так, что корень лежит в [1, 2). Начальное приближение
+ * строится по битам числа и уточняется многочленами для log2 и 2^x,
+ * поэтому метод сходится за 3–5 итераций при любом порядке числа.
  */
 
 #ifndef NEWTON_H
 #define NEWTON_H
 
 #include <QString>
+#include "dual.h"
+
+/**
+ * @brief x^N возведением в квадрат, раскрываемым при компиляции
+ *
+ * @details
+ * PowerKernel<N>::pow(x) разворачивается в ~log2(N) умножений без
+ * циклов и без вызова std::pow, который рассчитан на вещественные
+ * показатели.
+ */
+template <int N>
+struct PowerKernel {
+    static inline double pow(double x)
+    {
+        const double half = PowerKernel<N / 2>::pow(x);
+        return (N & 1) ? half * half * x : half * half;
+    }
+};
+
+template <>
+struct PowerKernel<1> {
+    static inline double pow(double x) { return x; }
+};
+
+template <>
+struct PowerKernel<0> {
+    static inline double pow(double) { return 1.0; }
+};
+
+/**
+ * @brief Приведённая задача извлечения корня
+ *
+ * @details
+ * Корень из исходного числа равен ±(корень из reduced)·2^exponent,
+ * а корень из reduced лежит в [1, 2).
+ */
+struct RootSeed {
+    double reduced;   ///< Модуль числа, приведённый к [1, 2^power)
+    double guess;     ///< Начальное приближение корня из reduced
+    int exponent;     ///< Показатель двойки для обратного масштабирования
+    bool negative;    ///< Корень нечётной степени из отрицательного числа
+};
 
 /**
  * @brief Класс для работы с методом Ньютона
  */
 class Newton {
 public:
+    /// Наибольшая степень, для которой есть специализированное ядро
+    static const int MAX_SPECIALIZED_POWER = 16;
+
     /**
      * @brief Вычисляет корень n-й степени из числа
      * @param number Число, из которого извлекается корень
      * @param power Степень корня
+     * @param iterations Если не nullptr, сюда записывается число итераций
      * @return Значение корня
+     *
+     * @details
+     * Для степеней 2..MAX_SPECIALIZED_POWER вызывается ядро, собранное
+     * при компиляции для конкретной степени (PowerKernel); для больших
+     * степеней используется calculateRootGeneric(). Число итераций
+     * учитывается в RootIterationStats (newtonstats.h).
      */
-    double calculateRoot(double number, int power);
+    double calculateRoot(double number, int power, int* iterations = nullptr);
 
-private:
     /**
-     * @brief Вычисляет производную функции x^n
-     * @param x Значение x
-     * @param n Степень
-     * @return Значение производной
+     * @brief То же, что calculateRoot(), но без учёта в RootIterationStats
+     * @param number Число, из которого извлекается корень
+     * @param power Степень корня
+     * @param iterations Если не nullptr, сюда записывается число итераций
+     * @return Значение корня
+     *
+     * @details Для пакетных путей, которые сами учитывают задачу вместе
+     * с итерациями, сделанными до перехода к этому решению.
+     */
+    double calculateRootUntracked(double number, int power, int* iterations = nullptr);
+
+    /**
+     * @brief Общий путь для произвольной степени через std::pow
+     * @param number Число, из которого извлекается корень
+     * @param power Степень корня
+     * @param iterations Если не nullptr, сюда записывается число итераций
+     * @return Значение корня
+     */
+    double calculateRootGeneric(double number, int power, int* iterations = nullptr);
+
+    /**
+     * @brief Случаи, решаемые без итераций
+     * @param number Число, из которого извлекается корень
+     * @param power Степень корня
+     * @param root Сюда записывается корень, если функция вернула true
+     * @return true для степени <= 1, нуля, бесконечности, NaN, чётного корня
+     *         из отрицательного числа (NaN) и точных целых степеней
+     */
+    static bool trivialRoot(double number, int power, double& root);
+
+    /**
+     * @brief Приводит задачу к корню из [1, 2) и строит начальное приближение
+     * @param number Конечное ненулевое число
+     * @param power Степень корня (>= 2)
+     * @return Приведённая задача
+     *
+     * @details
+     * Показатель e делится на n с остатком: number = m·2^r·2^(q·n),
+     * где 0 <= r < n. Приближение 2^((r + log2 m) / n) считается
+     * многочленами 4-й и 3-й степени, относительная ошибка ~3e-4.
+     */
+    static RootSeed initialGuess(double number, int power);
+
+    /**
+     * @brief Возвращает корень исходного числа по корню приведённой задачи
+     * @param seed Приведённая задача
+     * @param x Найденный корень из seed.reduced
+     * @param number Исходное число
+     * @param power Степень корня
+     * @return Корень; для точных целых степеней — точное целое
      */
-    double derivative(double x, int n);
+    static double finishRoot(const RootSeed& seed, double x, double number, int power);
 
+private:
     /**
-     * @brief Вычисляет значение функции x^n
-     * @param x Значение x
+     * @brief Вычисляет x^n - number вместе с производной
+     * @param x Дуальное значение x (Dual(x, 1) для производной по x)
      * @param n Степень
-     * @return Значение функции
+     * @param number Число, из которого извлекается корень
+     * @return Значение функции и её производная n·x^(n-1)
      */
-    double function(double x, int n, double number);
+    Dual function(const Dual& x, int n, double number);
+
+    /// Итерации общего пути для нетривиального числа, без учёта в статистике
+    double genericRoot(double number, int power, int* iterations);
+};
+
+class Expression;
+
+/**
+ * @brief Итерационный метод уточнения корня уравнения
+ *
+ * @details
+ * Методы высших порядков делают больше работы за одно вычисление
+ * выражения (ряд Тейлора вместо дуального числа), но сходятся за
+ * меньшее число вычислений.
+ */
+enum class RootMethod {
+    Newton,       ///< Ньютон: f и f', квадратичная сходимость
+    Halley,       ///< Галлей: f, f', f'', кубическая сходимость
+    Householder3  ///< Хаусхолдер 3-го порядка: до f''', сходимость 4-го порядка
+};
+
+/**
+ * @brief Разбирает имя метода ("newton", "halley", "householder")
+ * @param name Имя метода (регистр не важен)
+ * @param method Сюда записывается метод
+ * @return false для неизвестного имени
+ */
+bool parseRootMethod(const QString& name, RootMethod& method);
+
+/// Имя метода для протокола и отчётов
+QString rootMethodName(RootMethod method);
+
+/**
+ * @brief Результат решения уравнения
+ */
+struct EquationSolution {
+    double root = 0.0;       ///< Найденный корень
+    int evaluations = 0;     ///< Число вычислений выражения (одно на итерацию)
+    bool converged = false;  ///< Достигнута ли точность
+    QString error;           ///< Сообщение об ошибке, пустое при успехе
 };
 
+/**
+ * @brief Уточняет корень скомпилированного уравнения выбранным методом
+ * @param f Скомпилированное выражение
+ * @param initialGuess Начальное приближение
+ * @param tolerance Точность: итерации прекращаются, когда шаг не больше tolerance·max(1, |x|)
+ * @param method Метод уточнения
+ * @return Корень, число вычислений и признак сходимости
+ *
+ * @details
+ * Производные берутся из того же байткода: дуальные числа для
+ * Ньютона, Jet<2> для Галлея и Jet<3> для Хаусхолдера. Если знаменатель
+ * формулы высшего порядка обращается в ноль, делается шаг Ньютона.
+ */
+EquationSolution solveEquation(const Expression& f, double initialGuess, double tolerance = 1e-6,
+                               RootMethod method = RootMethod::Newton);
+
+/**
+ * @brief Уточняет квадратный корень из числа выбранным методом
+ * @param number Подкоренное число
+ * @param tolerance Относительная точность корня
+ * @param method Метод уточнения
+ * @return Корень, число вычислений и признак сходимости; для бесконечного,
+ *         неопределённого или отрицательного number — ошибка
+ *
+ * @details
+ * Уравнение x^2 - number вычисляется напрямую, без сборки и разбора
+ * текста выражения. Как и Newton::calculateRoot, задача приводится к
+ * корню из [1, 4) с приближением Newton::initialGuess(), поэтому
+ * сходимость не зависит от порядка number; ноль и точные квадраты
+ * возвращаются без итераций.
+ */
+EquationSolution solveSquareRoot(double number, double tolerance = 1e-6,
+                                 RootMethod method = RootMethod::Newton);
+
 /**
  * @brief Находит корень уравнения методом Ньютона
  * @param equation Строка с уравнением
  * @param initialGuess Начальное приближение
  * @param tolerance Точность вычислений
+ * @param method Метод уточнения (по умолчанию Ньютон)
  * @return Строка с результатом или сообщением об ошибке
  * 
  * @details
  * Функция реализует итерационный метод Ньютона для нахождения
  * корня уравнения. Процесс продолжается до достижения заданной
- * точности или максимального числа итераций.
+ * точности или максимального числа итераций. Значение и производная
+ * вычисляются за один проход байткода на дуальных числах.
  * 
  * @example
  * @code
@@ -63,10 +244,12 @@ private:
  * @endcode
  * 
  * @note
- * Уравнение должно быть в формате, поддерживаемом парсером.
+ * Уравнение должно быть в формате, поддерживаемом парсером
+ * (см. expression.h); скомпилированный байткод кэшируется.
  * Начальное приближение должно быть достаточно близко к корню.
  */
-QString solveNewton(const QString& equation, double initialGuess, double tolerance = 1e-6);
+QString solveNewton(const QString& equation, double initialGuess, double tolerance = 1e-6,
+                    RootMethod method = RootMethod::Newton);
 
 // Функция для нахождения квадратного корня с использованием метода Ньютона
 double newtonMethod(double value);
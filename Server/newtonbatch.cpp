@@ -0,0 +1,440 @@
+/**
+ * @file newtonbatch.cpp
+ * @brief Реализация пакетного извлечения корней методом Ньютона
+ * @date 2024
+ */
+
+#include "newtonbatch.h"
+#include "newton.h"
+#include "newtonstats.h"
+#include "cpufeatures.h"
+#include "parallel.h"
+#include <QElapsedTimer>
+#include <cmath>
+
+namespace {
+
+// Должны совпадать с Newton::calculateRoot
+const double EPSILON = 1e-10;
+const int MAX_ITERATIONS = 100;
+
+// Задач на одно задание параллельного цикла
+const int BLOCK_SIZE = 4096;
+
+/**
+ * Локальная гистограмма итераций. Переносится в RootIterationStats
+ * одной записью на ячейку, чтобы потоки не сталкивались на общих
+ * атомарных счётчиках для каждой задачи.
+ */
+class IterationTally {
+public:
+    void add(int power, int iterations)
+    {
+        ++counts[qBound(0, power, ROWS - 1)][qBound(0, iterations, COLUMNS - 1)];
+    }
+
+    void flush() const
+    {
+        for (int row = 0; row < ROWS; ++row) {
+            for (int column = 0; column < COLUMNS; ++column) {
+                if (counts[row][column] > 0) {
+                    RootIterationStats::instance().record(row, column, counts[row][column]);
+                }
+            }
+        }
+    }
+
+private:
+    static const int ROWS = RootIterationStats::MAX_TRACKED_POWER + 2;
+    static const int COLUMNS = RootIterationStats::MAX_ITERATIONS + 1;
+    quint64 counts[ROWS][COLUMNS] = {};
+};
+
+typedef void (*BlockKernel)(const double* numbers, const qint32* powers, double* roots, qint32* iterations, int count);
+
+void solveBlockScalar(const double* numbers, const qint32* powers, double* roots, qint32* iterations, int count)
+{
+    Newton newton;
+    for (int i = 0; i < count; ++i) {
+        int used = 0;
+        roots[i] = newton.calculateRoot(numbers[i], powers[i], &used);
+        iterations[i] = used;
+    }
+}
+
+#if HAVE_X86_SIMD
+
+const int LANES = 4;
+
+// x^e для четырёх линий double с собственным показателем в каждой линии
+TARGET_AVX2 inline __m256d powerLanes(__m256d x, __m256i e)
+{
+    const __m256i oneBit = _mm256_set1_epi64x(1);
+    __m256d r = _mm256_set1_pd(1.0);
+    while (!_mm256_testz_si256(e, e)) {
+        const __m256d useBit = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(e, oneBit), oneBit));
+        r = _mm256_blendv_pd(r, _mm256_mul_pd(r, x), useBit);
+        x = _mm256_mul_pd(x, x);
+        e = _mm256_srli_epi64(e, 1);
+    }
+    return r;
+}
+
+// То же для восьми линий float
+TARGET_AVX2 inline __m256 powerLanes(__m256 x, __m256i e)
+{
+    const __m256i oneBit = _mm256_set1_epi32(1);
+    __m256 r = _mm256_set1_ps(1.0f);
+    while (!_mm256_testz_si256(e, e)) {
+        const __m256 useBit = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(e, oneBit), oneBit));
+        r = _mm256_blendv_ps(r, _mm256_mul_ps(r, x), useBit);
+        x = _mm256_mul_ps(x, x);
+        e = _mm256_srli_epi32(e, 1);
+    }
+    return r;
+}
+
+/**
+ * Состояние четырёх линий. Когда задача в линии сходится, её результат
+ * записывается, а в линию загружается следующая задача блока.
+ */
+struct LaneState {
+    alignas(32) double x[LANES];
+    alignas(32) double number[LANES];
+    alignas(32) double power[LANES];
+    alignas(32) qint64 exponent[LANES];  ///< power - 1 для возведения в степень
+    RootSeed seed[LANES];                ///< Приведение задачи, для обратного масштабирования
+    int index[LANES];                    ///< Номер задачи в блоке, -1 для пустой линии
+    int iterations[LANES];
+
+    const double* numbers;
+    const qint32* powers;
+    double* roots;
+    qint32* iterationsOut;
+    int count;
+    int next = 0;
+
+    // Загружает в линию следующую задачу, требующую итераций
+    bool load(int lane)
+    {
+        while (next < count) {
+            const int i = next++;
+            const int p = powers[i];
+            if (Newton::trivialRoot(numbers[i], p, roots[i])) {
+                iterationsOut[i] = 0;
+                continue;
+            }
+            // Линия решает приведённую задачу с корнем в [1, 2)
+            seed[lane] = Newton::initialGuess(numbers[i], p);
+            x[lane] = seed[lane].guess;
+            number[lane] = seed[lane].reduced;
+            power[lane] = p;
+            exponent[lane] = p - 1;
+            index[lane] = i;
+            iterations[lane] = 0;
+            return true;
+        }
+
+        // Пустая линия считает безопасную задачу, результат которой не используется
+        x[lane] = 1.0;
+        number[lane] = 1.0;
+        power[lane] = 2.0;
+        exponent[lane] = 0;
+        index[lane] = -1;
+        return false;
+    }
+};
+
+TARGET_AVX2 void solveBlockAvx2(const double* numbers, const qint32* powers, double* roots, qint32* iterations, int count)
+{
+    LaneState s;
+    s.numbers = numbers;
+    s.powers = powers;
+    s.roots = roots;
+    s.iterationsOut = iterations;
+    s.count = count;
+
+    int active = 0;
+    for (int lane = 0; lane < LANES; ++lane) {
+        active += s.load(lane) ? 1 : 0;
+    }
+
+    const __m256d eps = _mm256_set1_pd(EPSILON);
+    const __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+
+    while (active > 0) {
+        const __m256d x = _mm256_load_pd(s.x);
+        const __m256d number = _mm256_load_pd(s.number);
+        const __m256d power = _mm256_load_pd(s.power);
+
+        // x^(n-1) возведением в квадрат с собственным показателем в каждой линии
+        const __m256d r = powerLanes(x, _mm256_load_si256(reinterpret_cast<const __m256i*>(s.exponent)));
+
+        const __m256d fx = _mm256_sub_pd(_mm256_mul_pd(r, x), number);
+        const __m256d dfx = _mm256_mul_pd(power, r);
+        const __m256d xNew = _mm256_sub_pd(x, _mm256_div_pd(fx, dfx));
+
+        // Условия остановки те же, что в скалярном цикле
+        const __m256d stopF = _mm256_cmp_pd(_mm256_and_pd(fx, absMask), eps, _CMP_LT_OQ);
+        const __m256d stopD = _mm256_cmp_pd(_mm256_and_pd(dfx, absMask), eps, _CMP_LT_OQ);
+        const __m256d stopX = _mm256_cmp_pd(_mm256_and_pd(_mm256_sub_pd(xNew, x), absMask), eps, _CMP_LT_OQ);
+        const __m256d stop = _mm256_or_pd(stopF, _mm256_or_pd(stopD, stopX));
+
+        // Остановившиеся линии сохраняют текущее x
+        _mm256_store_pd(s.x, _mm256_blendv_pd(xNew, x, stop));
+        const int stopMask = _mm256_movemask_pd(stop);
+
+        for (int lane = 0; lane < LANES; ++lane) {
+            if (s.index[lane] < 0) {
+                continue;
+            }
+            ++s.iterations[lane];
+            if ((stopMask >> lane) & 1 || s.iterations[lane] >= MAX_ITERATIONS) {
+                const int i = s.index[lane];
+                roots[i] = Newton::finishRoot(s.seed[lane], s.x[lane], numbers[i], powers[i]);
+                iterations[i] = s.iterations[lane];
+                if (!s.load(lane)) {
+                    --active;
+                }
+            }
+        }
+    }
+}
+
+const int FLOAT_LANES = 8;
+
+// Смешанная точность: шаги во float, затем уточнение в double
+const int FLOAT_STEPS = 2;
+const int POLISH_STEPS = 2;
+
+// Выше этой степени x^(n-1) и приведённое число не помещаются во float
+const int MIXED_MAX_POWER = 64;
+
+/**
+ * Восемь задач смешанной точности. Задачи уже приведены к корню из
+ * [1, 2), поэтому float хватает для любой степени до MIXED_MAX_POWER.
+ */
+struct MixedGroup {
+    alignas(32) float x[FLOAT_LANES];
+    alignas(32) float number[FLOAT_LANES];
+    alignas(32) float power[FLOAT_LANES];
+    alignas(32) qint32 exponent[FLOAT_LANES];
+    alignas(32) double xd[FLOAT_LANES];
+    alignas(32) double numberd[FLOAT_LANES];
+    alignas(32) double powerd[FLOAT_LANES];
+    alignas(32) qint64 exponentd[FLOAT_LANES];
+    RootSeed seed[FLOAT_LANES];
+    int index[FLOAT_LANES];
+    int size = 0;
+
+    void add(int i, const RootSeed& s, int p)
+    {
+        x[size] = float(s.guess);
+        number[size] = float(s.reduced);
+        power[size] = float(p);
+        exponent[size] = p - 1;
+        numberd[size] = s.reduced;
+        powerd[size] = p;
+        exponentd[size] = p - 1;
+        seed[size] = s;
+        index[size] = i;
+        ++size;
+    }
+};
+
+TARGET_AVX2 void solveMixedGroup(MixedGroup& g, const double* numbers, const qint32* powers,
+                                 double* roots, qint32* iterations, IterationTally& tally)
+{
+    // Свободные линии считают безопасную задачу √1
+    for (int lane = g.size; lane < FLOAT_LANES; ++lane) {
+        g.x[lane] = g.number[lane] = 1.0f;
+        g.power[lane] = 2.0f;
+        g.exponent[lane] = 1;
+        g.numberd[lane] = 1.0;
+        g.powerd[lane] = 2.0;
+        g.exponentd[lane] = 1;
+    }
+
+    // Итерации во float: восемь линий на регистр
+    __m256 x = _mm256_load_ps(g.x);
+    const __m256 number = _mm256_load_ps(g.number);
+    const __m256 power = _mm256_load_ps(g.power);
+    const __m256i exponent = _mm256_load_si256(reinterpret_cast<const __m256i*>(g.exponent));
+    for (int step = 0; step < FLOAT_STEPS; ++step) {
+        const __m256 r = powerLanes(x, exponent);
+        const __m256 fx = _mm256_sub_ps(_mm256_mul_ps(r, x), number);
+        x = _mm256_sub_ps(x, _mm256_div_ps(fx, _mm256_mul_ps(power, r)));
+    }
+
+    // Уточнение в double: по четыре линии
+    const __m256d absMask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+    const __m256d eps = _mm256_set1_pd(EPSILON);
+    int unconverged = 0;
+    for (int half = 0; half < 2; ++half) {
+        __m256d xd = _mm256_cvtps_pd(half == 0 ? _mm256_castps256_ps128(x) : _mm256_extractf128_ps(x, 1));
+        const __m256d numberd = _mm256_load_pd(g.numberd + 4 * half);
+        const __m256d powerd = _mm256_load_pd(g.powerd + 4 * half);
+        const __m256i exponentd = _mm256_load_si256(reinterpret_cast<const __m256i*>(g.exponentd + 4 * half));
+        __m256d step = _mm256_setzero_pd();
+        for (int polish = 0; polish < POLISH_STEPS; ++polish) {
+            const __m256d r = powerLanes(xd, exponentd);
+            const __m256d fx = _mm256_sub_pd(_mm256_mul_pd(r, xd), numberd);
+            step = _mm256_div_pd(fx, _mm256_mul_pd(powerd, r));
+            xd = _mm256_sub_pd(xd, step);
+        }
+        _mm256_store_pd(g.xd + 4 * half, xd);
+        // Последний шаг должен быть меньше допуска (корень лежит в [1, 2))
+        const __m256d small = _mm256_cmp_pd(_mm256_and_pd(step, absMask), eps, _CMP_LT_OQ);
+        unconverged |= (~_mm256_movemask_pd(small) & 0xF) << (4 * half);
+    }
+
+    Newton newton;
+    for (int lane = 0; lane < g.size; ++lane) {
+        const int i = g.index[lane];
+        if ((unconverged >> lane) & 1) {
+            // Редкий случай: линия не успела сойтись — решаем задачу в double;
+            // в гистограмму идут и шаги float, сделанные до этого
+            int used = 0;
+            roots[i] = newton.calculateRootUntracked(numbers[i], powers[i], &used);
+            iterations[i] = FLOAT_STEPS + POLISH_STEPS + used;
+        } else {
+            roots[i] = Newton::finishRoot(g.seed[lane], g.xd[lane], numbers[i], powers[i]);
+            iterations[i] = FLOAT_STEPS + POLISH_STEPS;
+        }
+        tally.add(powers[i], iterations[i]);
+    }
+    g.size = 0;
+}
+
+TARGET_AVX2 void solveBlockMixedAvx2(const double* numbers, const qint32* powers, double* roots, qint32* iterations, int count)
+{
+    MixedGroup group;
+    IterationTally tally;
+    Newton newton;
+    for (int i = 0; i < count; ++i) {
+        const int p = powers[i];
+        if (Newton::trivialRoot(numbers[i], p, roots[i])) {
+            iterations[i] = 0;
+            tally.add(p, 0);
+            continue;
+        }
+        if (p > MIXED_MAX_POWER) {
+            // x^(n-1) вышел бы за диапазон float
+            int used = 0;
+            roots[i] = newton.calculateRootUntracked(numbers[i], p, &used);
+            iterations[i] = used;
+            tally.add(p, used);
+            continue;
+        }
+        group.add(i, Newton::initialGuess(numbers[i], p), p);
+        if (group.size == FLOAT_LANES) {
+            solveMixedGroup(group, numbers, powers, roots, iterations, tally);
+        }
+    }
+    if (group.size > 0) {
+        solveMixedGroup(group, numbers, powers, roots, iterations, tally);
+    }
+    tally.flush();
+}
+
+#endif // HAVE_X86_SIMD
+
+void collectIterations(const RootBatch& batch, RootBatchStats& stats)
+{
+    for (qint32 used : batch.iterations) {
+        stats.totalIterations += used;
+        stats.maxIterations = qMax(stats.maxIterations, int(used));
+    }
+}
+
+// Добавляет итерации пакета в общие гистограммы одной записью на ячейку
+void recordHistogram(const RootBatch& batch)
+{
+    IterationTally tally;
+    for (int i = 0; i < batch.size(); ++i) {
+        tally.add(batch.powers[i], batch.iterations[i]);
+    }
+    tally.flush();
+}
+
+// Раздаёт блоки пакета по ядрам; simdKernel вызывается, если есть AVX2
+RootBatchStats runBatch(RootBatch& batch, int maxThreads, BlockKernel simdKernel)
+{
+    RootBatchStats stats;
+    const int count = batch.size();
+    batch.roots.resize(count);
+    batch.iterations.resize(count);
+    batch.powers.resize(count);
+
+    const bool simd = simdKernel && useAvx2();
+    const double* numbers = batch.numbers.constData();
+    const qint32* powers = batch.powers.constData();
+    double* roots = batch.roots.data();
+    qint32* iterations = batch.iterations.data();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const int blocks = (count + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    stats.threads = parallelFor(blocks, [&](int block) {
+        const int begin = block * BLOCK_SIZE;
+        const int size = qMin(BLOCK_SIZE, count - begin);
+#if HAVE_X86_SIMD
+        if (simd) {
+            simdKernel(numbers + begin, powers + begin, roots + begin, iterations + begin, size);
+            return;
+        }
+#endif
+        solveBlockScalar(numbers + begin, powers + begin, roots + begin, iterations + begin, size);
+    }, maxThreads);
+
+    stats.elapsedNs = timer.nsecsElapsed();
+    stats.simd = simd;
+    collectIterations(batch, stats);
+    return stats;
+}
+
+} // namespace
+
+RootBatchStats solveRootsBatch(RootBatch& batch, int maxThreads)
+{
+#if HAVE_X86_SIMD
+    RootBatchStats stats = runBatch(batch, maxThreads, solveBlockAvx2);
+#else
+    RootBatchStats stats = runBatch(batch, maxThreads, nullptr);
+#endif
+    if (stats.simd) {
+        // Скалярные блоки уже учтены в Newton::calculateRoot
+        recordHistogram(batch);
+    }
+    return stats;
+}
+
+RootBatchStats solveRootsMixed(RootBatch& batch, int maxThreads)
+{
+    // Все задачи учитываются в гистограммах по блокам с тем же числом
+    // итераций, что записывается в batch.iterations (шаги float и double).
+#if HAVE_X86_SIMD
+    return runBatch(batch, maxThreads, solveBlockMixedAvx2);
+#else
+    return solveRootsBatch(batch, maxThreads);
+#endif
+}
+
+RootBatchStats solveRootsScalar(RootBatch& batch)
+{
+    RootBatchStats stats;
+    const int count = batch.size();
+    batch.roots.resize(count);
+    batch.iterations.resize(count);
+    batch.powers.resize(count);
+
+    QElapsedTimer timer;
+    timer.start();
+    solveBlockScalar(batch.numbers.constData(), batch.powers.constData(),
+                     batch.roots.data(), batch.iterations.data(), count);
+    stats.elapsedNs = timer.nsecsElapsed();
+    stats.threads = 1;
+    collectIterations(batch, stats);
+    return stats;
+}
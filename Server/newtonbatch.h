@@ -0,0 +1,102 @@
+/**
+ * @file newtonbatch.h
+ * @brief Пакетное извлечение корней методом Ньютона
+ * @date 2024
+ *
+ * @details
+ * Решает массивы задач «корень степени n из числа» для массовой
+ * проверки ответов и подготовки вопросов задачи 2. Данные хранятся
+ * в виде структуры массивов (SoA): входные числа, степени, корни и
+ * счётчики итераций лежат в отдельных непрерывных массивах.
+ *
+ * Каждая задача решается той же итерацией, что и Newton::calculateRoot.
+ * В AVX2 четыре задачи идут в линиях одного регистра; сошедшиеся линии
+ * маскируются и сразу заполняются следующими задачами, поэтому
+ * разное число итераций у разных задач не простаивает. Внешний цикл
+ * делит массив на блоки и раздаёт их всем ядрам.
+ *
+ * solveRootsMixed() делает первые итерации во float (восемь линий на
+ * регистр вместо четырёх) и доводит результат до точности double
+ * одним-двумя шагами в double.
+ *
+ * @see newton.h
+ */
+
+#ifndef NEWTONBATCH_H
+#define NEWTONBATCH_H
+
+#include <QVector>
+
+/**
+ * @brief Набор задач в формате структуры массивов
+ */
+struct RootBatch {
+    QVector<double> numbers;     ///< Числа, из которых извлекаются корни
+    QVector<qint32> powers;      ///< Степени корней
+    QVector<double> roots;       ///< Результат: корни
+    QVector<qint32> iterations;  ///< Результат: число итераций для каждой задачи
+
+    /// Задаёт размер всех массивов
+    void resize(int count)
+    {
+        numbers.resize(count);
+        powers.resize(count);
+        roots.resize(count);
+        iterations.resize(count);
+    }
+
+    /// Количество задач
+    int size() const { return numbers.size(); }
+};
+
+/**
+ * @brief Статистика пакетного решения
+ */
+struct RootBatchStats {
+    qint64 elapsedNs = 0;        ///< Время решения, нс
+    int threads = 0;             ///< Использовано потоков
+    bool simd = false;           ///< Использовалось ли векторное ядро
+    qint64 totalIterations = 0;  ///< Сумма итераций по всем задачам
+    int maxIterations = 0;       ///< Максимум итераций среди задач
+
+    /// Корней в секунду
+    double rootsPerSecond(int count) const { return elapsedNs > 0 ? count * 1e9 / elapsedNs : 0.0; }
+};
+
+/**
+ * @brief Решает все задачи пакета
+ * @param batch Пакет задач; заполняются roots и iterations
+ * @param maxThreads Максимальное число потоков (0 — по числу ядер)
+ * @return Статистика решения
+ *
+ * @details
+ * Результат каждой задачи совпадает с Newton::calculateRoot с точностью
+ * до округления (x^n вычисляется возведением в квадрат, а не std::pow).
+ */
+RootBatchStats solveRootsBatch(RootBatch& batch, int maxThreads = 0);
+
+/**
+ * @brief Решает пакет скалярным циклом по Newton::calculateRoot в одном потоке
+ * @param batch Пакет задач; заполняются roots и iterations
+ * @return Статистика решения (эталон для сравнения скорости)
+ */
+RootBatchStats solveRootsScalar(RootBatch& batch);
+
+/**
+ * @brief Решает пакет в смешанной точности: float, затем уточнение в double
+ * @param batch Пакет задач; заполняются roots и iterations
+ * @param maxThreads Максимальное число потоков (0 — по числу ядер)
+ * @return Статистика решения
+ *
+ * @details
+ * Задача приводится к корню из [1, 2) (Newton::initialGuess), после чего
+ * делается два шага Ньютона во float и два шага в double относительно
+ * точного приведённого числа. Последний шаг должен быть меньше 1e-10,
+ * как в Newton::calculateRoot; несошедшиеся задачи и степени, для
+ * которых x^(n-1) не помещается во float (больше 64), решаются в double.
+ * В iterations записывается общее число шагов. Без AVX2 вызывает
+ * solveRootsBatch().
+ */
+RootBatchStats solveRootsMixed(RootBatch& batch, int maxThreads = 0);
+
+#endif // NEWTONBATCH_H
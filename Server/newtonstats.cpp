@@ -0,0 +1,91 @@
+/**
+ * @file newtonstats.cpp
+ * @brief Реализация гистограмм числа итераций метода Ньютона
+ * @date 2024
+ */
+
+#include "newtonstats.h"
+
+// Определения для констант, передаваемых по ссылке (qBound)
+const int RootIterationStats::MAX_ITERATIONS;
+const int RootIterationStats::MAX_TRACKED_POWER;
+
+quint64 RootIterationHistogram::total() const
+{
+    quint64 sum = 0;
+    for (quint64 count : counts) {
+        sum += count;
+    }
+    return sum;
+}
+
+double RootIterationHistogram::fractionWithin(int minIterations, int maxIterations) const
+{
+    const quint64 all = total();
+    if (all == 0) {
+        return 0.0;
+    }
+    quint64 inside = 0;
+    for (int i = qMax(0, minIterations); i <= maxIterations && i < counts.size(); ++i) {
+        inside += counts[i];
+    }
+    return double(inside) / all;
+}
+
+int RootIterationHistogram::percentile(double fraction) const
+{
+    const quint64 all = total();
+    quint64 accumulated = 0;
+    for (int i = 0; i < counts.size(); ++i) {
+        accumulated += counts[i];
+        if (all > 0 && accumulated >= fraction * all) {
+            return i;
+        }
+    }
+    return 0;
+}
+
+RootIterationStats::RootIterationStats()
+{
+    reset();
+}
+
+RootIterationStats& RootIterationStats::instance()
+{
+    static RootIterationStats stats;
+    return stats;
+}
+
+int RootIterationStats::row(int power)
+{
+    return qBound(0, power, MAX_TRACKED_POWER + 1);
+}
+
+void RootIterationStats::record(int power, int iterations, quint64 count)
+{
+    const int column = qBound(0, iterations, MAX_ITERATIONS);
+    counters[row(power)][column].fetch_add(count, std::memory_order_relaxed);
+}
+
+RootIterationHistogram RootIterationStats::histogram(int power) const
+{
+    RootIterationHistogram result;
+    result.counts.fill(0, MAX_ITERATIONS + 1);
+    const int first = power < 0 ? 0 : row(power);
+    const int last = power < 0 ? MAX_TRACKED_POWER + 1 : row(power);
+    for (int r = first; r <= last; ++r) {
+        for (int i = 0; i <= MAX_ITERATIONS; ++i) {
+            result.counts[i] += counters[r][i].load(std::memory_order_relaxed);
+        }
+    }
+    return result;
+}
+
+void RootIterationStats::reset()
+{
+    for (auto& line : counters) {
+        for (auto& counter : line) {
+            counter.store(0, std::memory_order_relaxed);
+        }
+    }
+}
@@ -0,0 +1,79 @@
+/**
+ * @file newtonstats.h
+ * @brief Гистограммы числа итераций метода Ньютона
+ * @date 2024
+ *
+ * @details
+ * Каждое извлечение корня (Newton::calculateRoot, пакетный решатель)
+ * добавляет своё число итераций в гистограмму своей степени. Счётчики
+ * атомарные и не требуют блокировок, так что запись идёт из любых
+ * потоков. Сервер отдаёт гистограммы по команде newtonstats, что
+ * позволяет проверить, сколько решений укладывается в 3–5 итераций.
+ *
+ * @see newton.h
+ */
+
+#ifndef NEWTONSTATS_H
+#define NEWTONSTATS_H
+
+#include <QVector>
+#include <atomic>
+
+/**
+ * @brief Снимок гистограммы: counts[i] — число решений за i итераций
+ */
+struct RootIterationHistogram {
+    QVector<quint64> counts;
+
+    /// Общее число решений
+    quint64 total() const;
+
+    /// Доля решений, потребовавших от minIterations до maxIterations итераций
+    double fractionWithin(int minIterations, int maxIterations) const;
+
+    /// Наименьшее число итераций, за которое решена доля fraction задач
+    int percentile(double fraction) const;
+};
+
+/**
+ * @brief Общие для сервера счётчики итераций по степеням корня
+ */
+class RootIterationStats {
+public:
+    /// Максимальное учитываемое число итераций (больше — в последнюю ячейку)
+    static const int MAX_ITERATIONS = 100;
+
+    /// Степени выше этой учитываются в общей строке
+    static const int MAX_TRACKED_POWER = 16;
+
+    /// Общие счётчики сервера
+    static RootIterationStats& instance();
+
+    /**
+     * @brief Учитывает решения
+     * @param power Степень корня
+     * @param iterations Число итераций
+     * @param count Сколько решений с таким числом итераций добавить
+     */
+    void record(int power, int iterations, quint64 count = 1);
+
+    /**
+     * @brief Возвращает гистограмму
+     * @param power Степень корня; -1 — сумма по всем степеням
+     * @return Снимок счётчиков
+     */
+    RootIterationHistogram histogram(int power = -1) const;
+
+    /// Обнуляет все счётчики
+    void reset();
+
+private:
+    RootIterationStats();
+
+    static int row(int power);
+
+    // Строки 0..MAX_TRACKED_POWER — по степеням, последняя — степени выше
+    std::atomic<quint64> counters[MAX_TRACKED_POWER + 2][MAX_ITERATIONS + 1];
+};
+
+#endif // NEWTONSTATS_H
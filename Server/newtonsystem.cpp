@@ -0,0 +1,252 @@
+/**
+ * @file newtonsystem.cpp
+ * @brief Реализация метода Ньютона для систем нелинейных уравнений
+ * @date 2024
+ */
+
+#include "newtonsystem.h"
+#include "parallel.h"
+#include <QElapsedTimer>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// Систем на одно задание пакетного режима
+const int BATCH_CHUNK = 16;
+
+double maxNorm(const double* v, int n)
+{
+    double norm = 0.0;
+    for (int i = 0; i < n; ++i) {
+        norm = qMax(norm, std::abs(v[i]));
+    }
+    return norm;
+}
+
+inline void swapRows(double* a, int n, int r1, int r2)
+{
+    double* p = a + r1 * n;
+    double* q = a + r2 * n;
+    for (int c = 0; c < n; ++c) {
+        const double t = p[c];
+        p[c] = q[c];
+        q[c] = t;
+    }
+}
+
+} // namespace
+
+bool luDecompose(double* a, int n, int* pivots)
+{
+    for (int k0 = 0; k0 < n; k0 += LU_BLOCK_SIZE) {
+        const int k1 = qMin(n, k0 + LU_BLOCK_SIZE);
+
+        // Разложение панели: столбцы [k0, k1), строки [k0, n)
+        for (int j = k0; j < k1; ++j) {
+            int pivot = j;
+            double best = std::abs(a[j * n + j]);
+            for (int i = j + 1; i < n; ++i) {
+                const double v = std::abs(a[i * n + j]);
+                if (v > best) {
+                    best = v;
+                    pivot = i;
+                }
+            }
+            pivots[j] = pivot;
+            if (best == 0.0) {
+                return false;
+            }
+            if (pivot != j) {
+                swapRows(a, n, j, pivot);
+            }
+
+            const double inverse = 1.0 / a[j * n + j];
+            for (int i = j + 1; i < n; ++i) {
+                double* row = a + i * n;
+                const double l = row[j] * inverse;
+                row[j] = l;
+                const double* pivotRow = a + j * n;
+                for (int c = j + 1; c < k1; ++c) {
+                    row[c] -= l * pivotRow[c];
+                }
+            }
+        }
+
+        if (k1 == n) {
+            break;
+        }
+
+        // U12 = L11^-1 · A12
+        for (int j = k0; j < k1; ++j) {
+            const double* pivotRow = a + j * n;
+            for (int i = j + 1; i < k1; ++i) {
+                double* row = a + i * n;
+                const double l = row[j];
+                for (int c = k1; c < n; ++c) {
+                    row[c] -= l * pivotRow[c];
+                }
+            }
+        }
+
+        // A22 -= L21 · U12: внутренний цикл по непрерывной строке
+        for (int i = k1; i < n; ++i) {
+            double* row = a + i * n;
+            for (int k = k0; k < k1; ++k) {
+                const double l = row[k];
+                const double* pivotRow = a + k * n;
+                for (int c = k1; c < n; ++c) {
+                    row[c] -= l * pivotRow[c];
+                }
+            }
+        }
+    }
+    return true;
+}
+
+void luSolve(const double* lu, int n, const int* pivots, double* b)
+{
+    for (int i = 0; i < n; ++i) {
+        if (pivots[i] != i) {
+            const double t = b[i];
+            b[i] = b[pivots[i]];
+            b[pivots[i]] = t;
+        }
+    }
+
+    // L·y = P·b, диагональ L единичная
+    for (int i = 1; i < n; ++i) {
+        const double* row = lu + i * n;
+        double sum = b[i];
+        for (int j = 0; j < i; ++j) {
+            sum -= row[j] * b[j];
+        }
+        b[i] = sum;
+    }
+
+    // U·x = y
+    for (int i = n - 1; i >= 0; --i) {
+        const double* row = lu + i * n;
+        double sum = b[i];
+        for (int j = i + 1; j < n; ++j) {
+            sum -= row[j] * b[j];
+        }
+        b[i] = sum / row[i];
+    }
+}
+
+NewtonSystemSolver::NewtonSystemSolver(int n)
+    : n(n), jacobian(n * n), residual(n), shifted(n), pivots(n)
+{
+}
+
+template <typename Evaluate>
+SystemSolution NewtonSystemSolver::iterate(Evaluate evaluate, double* x, double tolerance, int maxIterations)
+{
+    SystemSolution solution;
+    double* f = residual.data();
+    double* j = jacobian.data();
+
+    for (int iteration = 0; iteration < maxIterations; ++iteration) {
+        evaluate(x, f, j);
+        solution.iterations = iteration + 1;
+        solution.residualNorm = maxNorm(f, n);
+        if (solution.residualNorm < tolerance) {
+            solution.converged = true;
+            return solution;
+        }
+
+        if (!luDecompose(j, n, pivots.data())) {
+            solution.error = "Singular Jacobian";
+            return solution;
+        }
+
+        // Шаг dx = -J^-1·F считается на месте в буфере невязки
+        for (int i = 0; i < n; ++i) {
+            f[i] = -f[i];
+        }
+        luSolve(j, n, pivots.constData(), f);
+        for (int i = 0; i < n; ++i) {
+            x[i] += f[i];
+        }
+
+        if (!std::isfinite(maxNorm(x, n))) {
+            solution.error = "Diverged";
+            return solution;
+        }
+        if (maxNorm(f, n) < tolerance * qMax(1.0, maxNorm(x, n))) {
+            solution.converged = true;
+            return solution;
+        }
+    }
+
+    solution.error = "Maximum iterations reached";
+    return solution;
+}
+
+SystemSolution NewtonSystemSolver::solve(const FunctionWithJacobian& function, double* x,
+                                         double tolerance, int maxIterations)
+{
+    return iterate(function, x, tolerance, maxIterations);
+}
+
+SystemSolution NewtonSystemSolver::solveWithFiniteDifferences(const Function& function, double* x,
+                                                              double tolerance, int maxIterations)
+{
+    double* fh = shifted.data();
+    const double scale = std::sqrt(std::numeric_limits<double>::epsilon());
+
+    return iterate([&](double* point, double* f, double* j) {
+        function(point, f);
+        // Столбец j якобиана: (F(x + h·e_j) - F(x)) / h
+        for (int c = 0; c < n; ++c) {
+            const double saved = point[c];
+            const double h = scale * qMax(1.0, std::abs(saved));
+            point[c] = saved + h;
+            function(point, fh);
+            point[c] = saved;
+            for (int r = 0; r < n; ++r) {
+                j[r * n + c] = (fh[r] - f[r]) / h;
+            }
+        }
+    }, x, tolerance, maxIterations);
+}
+
+SystemBatchStats solveSystemsBatch(int n, int count, const BatchSystemFunction& function, double* x,
+                                   int* iterations, double tolerance, int maxThreads)
+{
+    SystemBatchStats stats;
+    if (n <= 0 || count <= 0) {
+        return stats;
+    }
+
+    QVector<int> used(count, 0);
+    QVector<char> converged(count, 0);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const int chunks = (count + BATCH_CHUNK - 1) / BATCH_CHUNK;
+    stats.threads = parallelFor(chunks, [&](int chunk) {
+        // Буферы решателя выделяются один раз на задание, а не на систему
+        NewtonSystemSolver solver(n);
+        const int end = qMin(count, (chunk + 1) * BATCH_CHUNK);
+        for (int index = chunk * BATCH_CHUNK; index < end; ++index) {
+            SystemSolution solution = solver.solve([&](const double* point, double* f, double* jacobian) {
+                function(index, point, f, jacobian);
+            }, x + qint64(index) * n, tolerance);
+            used[index] = solution.iterations;
+            converged[index] = solution.converged ? 1 : 0;
+        }
+    }, maxThreads);
+
+    stats.elapsedNs = timer.nsecsElapsed();
+    for (int i = 0; i < count; ++i) {
+        stats.totalIterations += used[i];
+        stats.converged += converged[i];
+        if (iterations) {
+            iterations[i] = used[i];
+        }
+    }
+    return stats;
+}
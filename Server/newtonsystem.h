@@ -0,0 +1,161 @@
+/**
+ * @file newtonsystem.h
+ * @brief Метод Ньютона для систем нелинейных уравнений F(x) = 0
+ * @date 2024
+ *
+ * @details
+ * Рассчитан на небольшие системы (2–64 неизвестных) задачи 2. На каждой
+ * итерации решается линейная система J·dx = -F, где J — матрица Якоби.
+ *
+ * - Якобиан хранится построчно (row-major) в буфере решателя, который
+ *   выделяется один раз; итерации не выделяют память.
+ * - LU-разложение с частичным выбором ведущего элемента выполняется
+ *   на месте. Для n больше LU_BLOCK_SIZE оно блочное: после разложения
+ *   панели из LU_BLOCK_SIZE столбцов оставшаяся матрица обновляется
+ *   одним проходом A22 -= L21·U12, внутренний цикл которого идёт по
+ *   непрерывной строке.
+ * - Если функция не считает якобиан сама, он строится конечными
+ *   разностями в том же буфере.
+ *
+ * Пакетный режим решает много независимых систем одного размера,
+ * распределяя их по ядрам; у каждого потока свой решатель.
+ *
+ * @example
+ * @code
+ * // x² + y² = 4, x = y
+ * NewtonSystemSolver solver(2);
+ * double x[2] = {1.0, 0.5};
+ * SystemSolution s = solver.solve([](const double* v, double* f, double* j) {
+ *     f[0] = v[0] * v[0] + v[1] * v[1] - 4.0;
+ *     f[1] = v[0] - v[1];
+ *     j[0] = 2 * v[0]; j[1] = 2 * v[1];
+ *     j[2] = 1.0;      j[3] = -1.0;
+ * }, x);
+ * // x = {√2, √2}
+ * @endcode
+ *
+ * @see newton.h
+ */
+
+#ifndef NEWTONSYSTEM_H
+#define NEWTONSYSTEM_H
+
+#include <QString>
+#include <QVector>
+#include <functional>
+
+/// Ширина панели блочного LU-разложения
+const int LU_BLOCK_SIZE = 16;
+
+/**
+ * @brief LU-разложение на месте с частичным выбором ведущего элемента
+ * @param a Матрица n×n построчно; заменяется на L (ниже диагонали, с единичной диагональю) и U
+ * @param n Размер матрицы
+ * @param pivots Сюда записываются номера переставленных строк (n элементов)
+ * @return false, если матрица вырождена
+ */
+bool luDecompose(double* a, int n, int* pivots);
+
+/**
+ * @brief Решает A·x = b по LU-разложению
+ * @param lu Результат luDecompose
+ * @param n Размер матрицы
+ * @param pivots Перестановки из luDecompose
+ * @param b Правая часть; заменяется решением
+ */
+void luSolve(const double* lu, int n, const int* pivots, double* b);
+
+/**
+ * @brief Результат решения системы
+ */
+struct SystemSolution {
+    int iterations = 0;         ///< Число итераций Ньютона
+    bool converged = false;     ///< Достигнута ли точность
+    double residualNorm = 0.0;  ///< max |F_i| в последней точке
+    QString error;              ///< Сообщение об ошибке, пустое при успехе
+};
+
+/**
+ * @brief Решатель систем фиксированного размера с переиспользуемыми буферами
+ */
+class NewtonSystemSolver {
+public:
+    /// F(x) и якобиан J (n×n построчно, J[i·n + j] = ∂F_i/∂x_j)
+    typedef std::function<void(const double* x, double* f, double* jacobian)> FunctionWithJacobian;
+
+    /// Только F(x); якобиан строится конечными разностями
+    typedef std::function<void(const double* x, double* f)> Function;
+
+    /**
+     * @brief Конструктор; выделяет все буферы
+     * @param n Число неизвестных
+     */
+    explicit NewtonSystemSolver(int n);
+
+    /// Число неизвестных
+    int size() const { return n; }
+
+    /**
+     * @brief Решает систему с аналитическим якобианом
+     * @param function Функция системы
+     * @param x Начальное приближение; заменяется решением
+     * @param tolerance Точность: max|F_i| или шаг относительно max(1, max|x_i|)
+     * @param maxIterations Предел числа итераций
+     * @return Результат решения
+     */
+    SystemSolution solve(const FunctionWithJacobian& function, double* x,
+                         double tolerance = 1e-10, int maxIterations = 50);
+
+    /**
+     * @brief Решает систему с якобианом из конечных разностей
+     * @param function Функция системы
+     * @param x Начальное приближение; заменяется решением
+     * @param tolerance Точность
+     * @param maxIterations Предел числа итераций
+     * @return Результат решения
+     */
+    SystemSolution solveWithFiniteDifferences(const Function& function, double* x,
+                                              double tolerance = 1e-10, int maxIterations = 50);
+
+private:
+    template <typename Evaluate>
+    SystemSolution iterate(Evaluate evaluate, double* x, double tolerance, int maxIterations);
+
+    int n;
+    QVector<double> jacobian;  ///< n×n, построчно; после разложения — LU
+    QVector<double> residual;  ///< F(x), затем шаг dx
+    QVector<double> shifted;   ///< F(x + h·e_j) для конечных разностей
+    QVector<int> pivots;
+};
+
+/**
+ * @brief Статистика пакетного решения систем
+ */
+struct SystemBatchStats {
+    qint64 elapsedNs = 0;         ///< Время решения, нс
+    int threads = 0;              ///< Использовано потоков
+    int converged = 0;            ///< Сошедшихся систем
+    qint64 totalIterations = 0;   ///< Сумма итераций по всем системам
+
+    /// Систем в секунду
+    double systemsPerSecond(int count) const { return elapsedNs > 0 ? count * 1e9 / elapsedNs : 0.0; }
+};
+
+/// F и якобиан системы номер index пакета
+typedef std::function<void(int index, const double* x, double* f, double* jacobian)> BatchSystemFunction;
+
+/**
+ * @brief Решает count независимых систем размера n в нескольких потоках
+ * @param n Число неизвестных в каждой системе
+ * @param count Число систем
+ * @param function Функция систем
+ * @param x Начальные приближения подряд (count·n); заменяются решениями
+ * @param iterations Если не nullptr, сюда записывается число итераций каждой системы
+ * @param tolerance Точность
+ * @param maxThreads Максимальное число потоков (0 — по числу ядер)
+ * @return Статистика решения
+ */
+SystemBatchStats solveSystemsBatch(int n, int count, const BatchSystemFunction& function, double* x,
+                                   int* iterations = nullptr, double tolerance = 1e-10, int maxThreads = 0);
+
+#endif // NEWTONSYSTEM_H
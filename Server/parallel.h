@@ -0,0 +1,69 @@
+/**
+ * @file parallel.h
+ * @brief Простейший параллельный цикл поверх QThreadPool
+ * @date 2024
+ *
+ * @details
+ * Задания раздаются через атомарный счётчик, поэтому потоки сами
+ * балансируют нагрузку. Вызывающий поток тоже выполняет работу, а
+ * вспомогательные задачи запускаются через tryStart(): при вложенных
+ * вызовах из уже занятого пула цикл просто выполняется меньшим
+ * числом потоков вместо взаимной блокировки.
+ */
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <QThread>
+#include <QThreadPool>
+#include <QSemaphore>
+#include <atomic>
+
+/**
+ * @brief Возвращает число рабочих потоков по умолчанию
+ * @return Количество логических ядер процессора
+ */
+inline int defaultThreadCount()
+{
+    return qMax(1, QThread::idealThreadCount());
+}
+
+/**
+ * @brief Выполняет fn(i) для всех i из [0, count) в нескольких потоках
+ * @param count Количество заданий
+ * @param fn Функция, принимающая индекс задания
+ * @param maxThreads Максимальное число потоков (0 — по числу ядер)
+ * @return Число потоков, фактически участвовавших в работе
+ */
+template <typename Fn>
+int parallelFor(int count, Fn fn, int maxThreads = 0)
+{
+    if (count <= 0) {
+        return 0;
+    }
+
+    int threads = maxThreads > 0 ? maxThreads : defaultThreadCount();
+    threads = qMin(threads, count);
+
+    std::atomic<int> next(0);
+    auto worker = [&]() {
+        for (int i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+            fn(i);
+        }
+    };
+
+    QSemaphore finished;
+    int started = 0;
+    for (int t = 1; t < threads; ++t) {
+        if (!QThreadPool::globalInstance()->tryStart([&]() { worker(); finished.release(); })) {
+            break;
+        }
+        ++started;
+    }
+
+    worker();
+    finished.acquire(started);
+    return started + 1;
+}
+
+#endif // PARALLEL_H
@@ -0,0 +1,211 @@
+/**
+ * @file polynomial.cpp
+ * @brief Реализация поиска корней многочлена методом Аберта–Эрлиха
+ * @date 2024
+ */
+
+#include "polynomial.h"
+#include "parallel.h"
+#include <QElapsedTimer>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+const double EPSILON = std::numeric_limits<double>::epsilon();
+
+// Сдвиг угла начальных точек, чтобы они не совпали с осями симметрии корней
+const double ANGLE_OFFSET = 0.4;
+
+/**
+ * Поправка Ньютона w = p(z) / p'(z) для многочлена степени n с
+ * коэффициентами c[0..n]. Возвращает true, если |p(z)| уже на уровне
+ * ошибки округления схемы Горнера, то есть z — корень.
+ */
+bool newtonCorrection(const double* c, int n, double zr, double zi, double& wr, double& wi)
+{
+    const double modulus = std::hypot(zr, zi);
+    double pr, pi, dr = 0.0, di = 0.0, bound;
+
+    if (modulus <= 1.0) {
+        // Горнер по убыванию степеней для p и p'
+        pr = c[n];
+        pi = 0.0;
+        bound = std::abs(c[n]);
+        for (int k = n - 1; k >= 0; --k) {
+            const double ndr = dr * zr - di * zi + pr;
+            const double ndi = dr * zi + di * zr + pi;
+            dr = ndr;
+            di = ndi;
+            const double npr = pr * zr - pi * zi + c[k];
+            const double npi = pr * zi + pi * zr;
+            pr = npr;
+            pi = npi;
+            bound = bound * modulus + std::abs(c[k]);
+        }
+        const double denominator = dr * dr + di * di;
+        if (denominator == 0.0) {
+            wr = wi = 0.0;
+            return pr == 0.0 && pi == 0.0;
+        }
+        wr = (pr * dr + pi * di) / denominator;
+        wi = (pi * dr - pr * di) / denominator;
+    } else {
+        // p(z) = z^n·q(y), y = 1/z, q(y) = c0·y^n + ... + cn;
+        // тогда p/p' = z / (n - y·q'(y)/q(y)) и значения остаются ограниченными
+        const double inverse = 1.0 / (modulus * modulus);
+        const double yr = zr * inverse;
+        const double yi = -zi * inverse;
+        const double yModulus = 1.0 / modulus;
+        pr = c[0];
+        pi = 0.0;
+        bound = std::abs(c[0]);
+        for (int k = 1; k <= n; ++k) {
+            const double ndr = dr * yr - di * yi + pr;
+            const double ndi = dr * yi + di * yr + pi;
+            dr = ndr;
+            di = ndi;
+            const double npr = pr * yr - pi * yi + c[k];
+            const double npi = pr * yi + pi * yr;
+            pr = npr;
+            pi = npi;
+            bound = bound * yModulus + std::abs(c[k]);
+        }
+        const double q2 = pr * pr + pi * pi;
+        if (q2 == 0.0) {
+            wr = wi = 0.0;
+            return true;
+        }
+        // t = y·q'/q
+        const double ur = dr * yr - di * yi;
+        const double ui = dr * yi + di * yr;
+        const double tr = (ur * pr + ui * pi) / q2;
+        const double ti = (ui * pr - ur * pi) / q2;
+        const double er = n - tr;
+        const double ei = -ti;
+        const double e2 = er * er + ei * ei;
+        if (e2 == 0.0) {
+            wr = wi = 0.0;
+            return false;
+        }
+        wr = (zr * er + zi * ei) / e2;
+        wi = (zi * er - zr * ei) / e2;
+    }
+
+    return std::hypot(pr, pi) <= 2.0 * n * EPSILON * bound;
+}
+
+// Добавляет Σ 1 / (z - z_j) по j из [begin, end); цикл без ветвлений для векторизации
+inline void addRepulsion(const double* re, const double* im, int begin, int end,
+                         double zr, double zi, double& sr, double& si)
+{
+    for (int j = begin; j < end; ++j) {
+        const double dr = zr - re[j];
+        const double di = zi - im[j];
+        const double inverse = 1.0 / (dr * dr + di * di);
+        sr += dr * inverse;
+        si -= di * inverse;
+    }
+}
+
+} // namespace
+
+PolynomialRoots findPolynomialRoots(const QVector<double>& coefficients, int maxIterations)
+{
+    PolynomialRoots result;
+
+    // Старшие нулевые коэффициенты не меняют многочлен
+    int high = coefficients.size() - 1;
+    while (high >= 0 && coefficients[high] == 0.0) {
+        --high;
+    }
+    // Младшие нулевые коэффициенты дают корни в нуле
+    int low = 0;
+    while (low < high && coefficients[low] == 0.0) {
+        ++low;
+    }
+    if (high <= 0) {
+        result.converged = true;
+        return result;
+    }
+
+    const double* c = coefficients.constData() + low;
+    const int n = high - low;
+
+    result.re.fill(0.0, high);
+    result.im.fill(0.0, high);
+    double* re = result.re.data();
+    double* im = result.im.data();
+
+    // Начальные точки на окружности вокруг центра тяжести корней
+    const double center = -c[n - 1] / (n * c[n]);
+    const double radius = std::pow(std::abs(c[0] / c[n]), 1.0 / n);
+    for (int i = 0; i < n; ++i) {
+        const double angle = 2.0 * M_PI * i / n + ANGLE_OFFSET;
+        re[i] = center + radius * std::cos(angle);
+        im[i] = radius * std::sin(angle);
+    }
+
+    QVector<char> done(n, 0);
+    int remaining = n;
+    int iteration = 0;
+    for (; iteration < maxIterations && remaining > 0; ++iteration) {
+        for (int i = 0; i < n; ++i) {
+            if (done[i]) {
+                continue;
+            }
+
+            const double zr = re[i];
+            const double zi = im[i];
+            double wr, wi;
+            if (newtonCorrection(c, n, zr, zi, wr, wi)) {
+                done[i] = 1;
+                --remaining;
+                continue;
+            }
+
+            double sr = 0.0, si = 0.0;
+            addRepulsion(re, im, 0, i, zr, zi, sr, si);
+            addRepulsion(re, im, i + 1, n, zr, zi, sr, si);
+
+            // Поправка Аберта: w / (1 - w·s)
+            const double denominatorR = 1.0 - (wr * sr - wi * si);
+            const double denominatorI = -(wr * si + wi * sr);
+            const double d2 = denominatorR * denominatorR + denominatorI * denominatorI;
+            const double cr = (wr * denominatorR + wi * denominatorI) / d2;
+            const double ci = (wi * denominatorR - wr * denominatorI) / d2;
+
+            re[i] = zr - cr;
+            im[i] = zi - ci;
+
+            if (std::hypot(cr, ci) <= 2.0 * EPSILON * std::hypot(re[i], im[i])) {
+                done[i] = 1;
+                --remaining;
+            }
+        }
+    }
+
+    result.iterations = iteration;
+    result.converged = remaining == 0;
+    return result;
+}
+
+PolynomialBatchStats solvePolynomialBatch(PolynomialBatch& batch, int maxThreads, int maxIterations)
+{
+    PolynomialBatchStats stats;
+    const int count = batch.coefficients.size();
+    batch.roots.resize(count);
+
+    QElapsedTimer timer;
+    timer.start();
+    stats.threads = parallelFor(count, [&](int i) {
+        batch.roots[i] = findPolynomialRoots(batch.coefficients[i], maxIterations);
+    }, maxThreads);
+    stats.elapsedNs = timer.nsecsElapsed();
+
+    for (const PolynomialRoots& roots : batch.roots) {
+        stats.totalRoots += roots.size();
+        stats.failed += roots.converged ? 0 : 1;
+    }
+    return stats;
+}
@@ -0,0 +1,95 @@
+/**
+ * @file polynomial.h
+ * @brief Все комплексные корни многочлена методом Аберта–Эрлиха
+ * @date 2024
+ *
+ * @details
+ * Для общего многочлена поиск корней по одному методом Ньютона
+ * медленный и не находит комплексных корней. Метод Аберта–Эрлиха
+ * уточняет все n приближений одновременно:
+ *
+ *     z_i -= w_i / (1 - w_i · Σ_{j≠i} 1 / (z_i - z_j)),  w_i = p(z_i) / p'(z_i)
+ *
+ * Сумма отталкивает приближения друг от друга, поэтому они не сходятся
+ * к одному корню. Начальные точки лежат на окружности радиуса
+ * |c0 / cn|^(1/n) вокруг центра тяжести корней.
+ *
+ * Корни хранятся как структура массивов: вещественные и мнимые части
+ * в отдельных непрерывных массивах, так что внутренний цикл по j
+ * векторизуется компилятором. При |z| > 1 многочлен вычисляется через
+ * обращённый многочлен от 1/z, что исключает переполнение для больших
+ * степеней.
+ *
+ * @example
+ * @code
+ * // x^2 + 1 = 0: коэффициенты по возрастанию степеней
+ * PolynomialRoots roots = findPolynomialRoots({1.0, 0.0, 1.0});
+ * // roots.re = {0, 0}, roots.im = {1, -1} (в некотором порядке)
+ * @endcode
+ *
+ * @see newton.h
+ */
+
+#ifndef POLYNOMIAL_H
+#define POLYNOMIAL_H
+
+#include <QVector>
+
+/**
+ * @brief Корни одного многочлена
+ */
+struct PolynomialRoots {
+    QVector<double> re;      ///< Вещественные части корней
+    QVector<double> im;      ///< Мнимые части корней
+    int iterations = 0;      ///< Число проходов по всем корням
+    bool converged = false;  ///< Все корни достигли точности
+
+    /// Количество корней (степень многочлена)
+    int size() const { return re.size(); }
+};
+
+/**
+ * @brief Находит все комплексные корни многочлена
+ * @param coefficients Коэффициенты по возрастанию степеней: c0 + c1·x + ... + cn·x^n
+ * @param maxIterations Предел числа проходов
+ * @return Корни; старшие нулевые коэффициенты отбрасываются
+ *
+ * @details
+ * Корень считается найденным, когда поправка меньше машинной точности
+ * относительно |z| или |p(z)| не превышает оценки ошибки округления
+ * схемы Горнера. Найденные корни больше не уточняются, но участвуют
+ * в суммах для остальных.
+ */
+PolynomialRoots findPolynomialRoots(const QVector<double>& coefficients, int maxIterations = 500);
+
+/**
+ * @brief Набор многочленов для пакетного решения
+ */
+struct PolynomialBatch {
+    QVector<QVector<double>> coefficients;  ///< Коэффициенты каждого многочлена
+    QVector<PolynomialRoots> roots;         ///< Результат: корни каждого многочлена
+};
+
+/**
+ * @brief Статистика пакетного решения
+ */
+struct PolynomialBatchStats {
+    qint64 elapsedNs = 0;      ///< Время решения, нс
+    int threads = 0;           ///< Использовано потоков
+    qint64 totalRoots = 0;     ///< Найдено корней
+    int failed = 0;            ///< Многочленов, не сошедшихся за предел итераций
+
+    /// Корней в секунду
+    double rootsPerSecond() const { return elapsedNs > 0 ? totalRoots * 1e9 / elapsedNs : 0.0; }
+};
+
+/**
+ * @brief Решает все многочлены пакета, распределяя их по ядрам
+ * @param batch Пакет; заполняется roots
+ * @param maxThreads Максимальное число потоков (0 — по числу ядер)
+ * @param maxIterations Предел числа проходов для одного многочлена
+ * @return Статистика решения
+ */
+PolynomialBatchStats solvePolynomialBatch(PolynomialBatch& batch, int maxThreads = 0, int maxIterations = 500);
+
+#endif // POLYNOMIAL_H
@@ -0,0 +1,276 @@
+/**
+ * @file rootfinder.cpp
+ * @brief Реализация поиска всех вещественных корней на отрезке
+ * @date 2024
+ */
+
+#include "rootfinder.h"
+#include "parallel.h"
+#include <QElapsedTimer>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Подотрезков на одно задание параллельного цикла
+const int CHUNK_SIZE = 64;
+
+// Корни ближе tolerance·MERGE_FACTOR считаются одним корнем
+const double MERGE_FACTOR = 1000.0;
+
+// Уточнённая точка скобки принимается за корень, только если |f| в ней
+// не больше этой доли |f| на концах скобки; иначе знак сменился через
+// полюс или разрыв (1/x в нуле)
+const double MAX_ROOT_RESIDUAL = 1e-3;
+
+/// Значение и производная функции в точке
+struct Sample {
+    double x;
+    double f;
+    double df;
+};
+
+/**
+ * Поиск корней в одном задании. Счётчики локальные, поэтому задания
+ * не разделяют изменяемых данных.
+ */
+class IntervalScanner {
+public:
+    IntervalScanner(const Expression& f, const RootScanOptions& options)
+        : f(f), options(options)
+    {
+    }
+
+    Sample sample(double x)
+    {
+        ++evaluations;
+        const Dual y = f.evaluate(Dual(x, 1.0));
+        return Sample{x, y.value, y.derivative};
+    }
+
+    // Ищет корни в подотрезке [s0.x, s1.x]; корень в s1.x остаётся следующему подотрезку
+    void scan(const Sample& s0, const Sample& s1)
+    {
+        if (s0.f == 0.0) {
+            roots.append(s0.x);
+        }
+
+        // Вне области определения (log, sqrt от отрицательного) и в полюсах
+        // значения не сравнимы по знаку
+        if (!std::isfinite(s0.f) || !std::isfinite(s1.f)) {
+            return;
+        }
+
+        if ((s0.f < 0) != (s1.f < 0) && s0.f != 0.0 && s1.f != 0.0) {
+            refine(s0, s1);
+            return;
+        }
+
+        // Без смены знака f корни возможны только по обе стороны экстремума
+        if ((s0.df < 0 && s1.df > 0) || (s0.df > 0 && s1.df < 0)) {
+            const Sample m = extremum(s0, s1);
+            ++extrema;
+            if (!std::isfinite(m.f)) {
+                return;
+            }
+            const double scale = qMax(std::abs(s0.f), std::abs(s1.f));
+            if (std::abs(m.f) <= options.valueTolerance * scale) {
+                // Корень касания: f не меняет знак, но обращается в ноль
+                roots.append(m.x);
+            } else if ((m.f < 0) != (s0.f < 0)) {
+                refine(s0, m);
+                refine(m, s1);
+            }
+        }
+    }
+
+    QVector<double> roots;
+    int brackets = 0;
+    int poles = 0;
+    int extrema = 0;
+    qint64 evaluations = 0;
+
+private:
+    const Expression& f;
+    const RootScanOptions& options;
+
+    bool converged(double step, double x) const
+    {
+        return std::abs(step) <= options.tolerance * qMax(1.0, std::abs(x));
+    }
+
+    // Уточняет скобку [a, b] и оставляет корень, если он не полюс
+    void refine(const Sample& a, const Sample& b)
+    {
+        const Sample root = polish(a, b);
+        ++brackets;
+        const double scale = qMax(std::abs(a.f), std::abs(b.f));
+        if (std::isfinite(root.f) && std::abs(root.f) <= MAX_ROOT_RESIDUAL * scale) {
+            roots.append(root.x);
+        } else {
+            ++poles;
+        }
+    }
+
+    /**
+     * Защищённый метод Ньютона в скобке со сменой знака: шаг Ньютона,
+     * выходящий за скобку или сокращающий её медленнее деления пополам,
+     * заменяется делением пополам.
+     *
+     * Возвращает найденную точку x со значением f в последней вычисленной
+     * точке — она отстоит от x не больше чем на последний шаг.
+     */
+    Sample polish(const Sample& a, const Sample& b)
+    {
+        // low — конец с f < 0
+        double low = a.f < 0 ? a.x : b.x;
+        double high = a.f < 0 ? b.x : a.x;
+
+        double x = 0.5 * (a.x + b.x);
+        double step = std::abs(b.x - a.x);
+        double previousStep = step;
+        Sample s = sample(x);
+
+        for (int i = 0; i < options.maxIterations; ++i) {
+            if (s.f == 0.0) {
+                return s;
+            }
+
+            const bool outside = ((x - high) * s.df - s.f) * ((x - low) * s.df - s.f) > 0;
+            const bool slow = std::abs(2.0 * s.f) > std::abs(previousStep * s.df);
+            previousStep = step;
+            if (outside || slow) {
+                step = 0.5 * (high - low);
+                x = low + step;
+            } else {
+                step = s.f / s.df;
+                x -= step;
+            }
+
+            if (converged(step, x)) {
+                return Sample{x, s.f, s.df};
+            }
+
+            s = sample(x);
+            if (s.f < 0) {
+                low = x;
+            } else {
+                high = x;
+            }
+        }
+        return Sample{x, s.f, s.df};
+    }
+
+    // Нуль производной методом Иллинойса (регула фальси с ослаблением неподвижного конца)
+    Sample extremum(const Sample& s0, const Sample& s1)
+    {
+        double a = s0.x;
+        double b = s1.x;
+        double da = s0.df;
+        double db = s1.df;
+        int side = 0;
+        Sample s = s0;
+
+        for (int i = 0; i < options.maxIterations; ++i) {
+            double x = (a * db - b * da) / (db - da);
+            if (!(x > qMin(a, b) && x < qMax(a, b))) {
+                x = 0.5 * (a + b);
+            }
+            const double previous = s.x;
+            s = sample(x);
+            if (s.df == 0.0 || converged(b - a, x) || (i > 0 && converged(x - previous, x))) {
+                break;
+            }
+
+            if ((s.df < 0) == (db < 0)) {
+                b = x;
+                db = s.df;
+                if (side == -1) {
+                    da *= 0.5;
+                }
+                side = -1;
+            } else {
+                a = x;
+                da = s.df;
+                if (side == 1) {
+                    db *= 0.5;
+                }
+                side = 1;
+            }
+        }
+        return s;
+    }
+};
+
+} // namespace
+
+RootScanResult findAllRoots(const Expression& f, double a, double b, const RootScanOptions& options)
+{
+    RootScanResult result;
+    if (a > b) {
+        std::swap(a, b);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const int intervals = qMax(1, options.subintervals);
+    const double width = b - a;
+    auto gridPoint = [&](int i) {
+        return i == intervals ? b : a + width * i / intervals;
+    };
+
+    const int chunks = (intervals + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    QVector<RootScanResult> partial(chunks);
+
+    result.threads = parallelFor(chunks, [&](int chunk) {
+        const int begin = chunk * CHUNK_SIZE;
+        const int end = qMin(intervals, begin + CHUNK_SIZE);
+
+        IntervalScanner scanner(f, options);
+        Sample left = scanner.sample(gridPoint(begin));
+        for (int i = begin; i < end; ++i) {
+            const Sample right = scanner.sample(gridPoint(i + 1));
+            scanner.scan(left, right);
+            left = right;
+        }
+        if (end == intervals && left.f == 0.0) {
+            scanner.roots.append(left.x);
+        }
+
+        RootScanResult& out = partial[chunk];
+        out.roots = scanner.roots;
+        out.brackets = scanner.brackets;
+        out.extrema = scanner.extrema;
+        out.poles = scanner.poles;
+        out.evaluations = scanner.evaluations;
+    }, options.maxThreads);
+
+    QVector<double> all;
+    for (const RootScanResult& part : partial) {
+        all += part.roots;
+        result.brackets += part.brackets;
+        result.extrema += part.extrema;
+        result.poles += part.poles;
+        result.evaluations += part.evaluations;
+    }
+
+    // Соседние подотрезки и концы скобок могут дать один корень дважды
+    std::sort(all.begin(), all.end());
+    const double mergeDistance = MERGE_FACTOR * options.tolerance;
+    for (double root : all) {
+        if (result.roots.isEmpty()
+            || root - result.roots.last() > mergeDistance * qMax(1.0, std::abs(root))) {
+            result.roots.append(root);
+        }
+    }
+
+    result.elapsedNs = timer.nsecsElapsed();
+    return result;
+}
+
+RootScanResult findAllRoots(const QString& equation, double a, double b, const RootScanOptions& options)
+{
+    std::shared_ptr<const Expression> program = ExpressionCache::instance().get(equation);
+    return findAllRoots(*program, a, b, options);
+}
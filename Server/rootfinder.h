@@ -0,0 +1,97 @@
+/**
+ * @file rootfinder.h
+ * @brief Поиск всех вещественных корней функции на отрезке
+ * @date 2024
+ *
+ * @details
+ * solveNewton находит один корень из одного начального приближения.
+ * Здесь отрезок [a, b] делится на равные подотрезки, и в каждом из них
+ * параллельно ищутся:
+ * - смена знака f — корень в скобке;
+ * - смена знака f' — экстремум, который может быть корнем касания
+ *   или делить подотрезок на две скобки.
+ *
+ * Каждая скобка уточняется защищённым методом Ньютона: шаг Ньютона
+ * принимается, только если он остаётся внутри скобки и уменьшает её
+ * достаточно быстро, иначе делается шаг деления пополам. Результат —
+ * отсортированный набор корней без повторов.
+ *
+ * Значение и производная берутся из скомпилированного выражения на
+ * дуальных числах (expression.h), подотрезки делятся между ядрами
+ * через parallelFor.
+ *
+ * @example
+ * @code
+ * RootScanResult result = findAllRoots("(x-1)*(x-2)*(x-3)", 0.0, 4.0);
+ * // result.roots = {1, 2, 3}
+ * @endcode
+ *
+ * @see newton.h
+ */
+
+#ifndef ROOTFINDER_H
+#define ROOTFINDER_H
+
+#include <QString>
+#include <QVector>
+#include "expression.h"
+
+/**
+ * @brief Параметры поиска корней
+ */
+struct RootScanOptions {
+    int subintervals = 4096;        ///< Число подотрезков разбиения
+    double tolerance = 1e-12;       ///< Точность корня (относительно max(1, |x|))
+    double valueTolerance = 1e-6;   ///< |f| в экстремуме относительно |f| на концах подотрезка,
+                                    ///< при котором экстремум считается корнем касания
+    int maxIterations = 100;        ///< Предел итераций уточнения одной скобки
+    int maxThreads = 0;             ///< Максимальное число потоков (0 — по числу ядер)
+};
+
+/**
+ * @brief Результат поиска корней
+ */
+struct RootScanResult {
+    QVector<double> roots;    ///< Корни по возрастанию, без повторов
+    int brackets = 0;         ///< Уточнено скобок со сменой знака
+    int extrema = 0;          ///< Найдено экстремумов внутри подотрезков
+    int poles = 0;            ///< Отброшено скобок со сменой знака через полюс
+    qint64 evaluations = 0;   ///< Вычислений f и f'
+    qint64 elapsedNs = 0;     ///< Время поиска, нс
+    int threads = 0;          ///< Использовано потоков
+};
+
+/**
+ * @brief Находит все вещественные корни функции на отрезке
+ * @param f Скомпилированное выражение
+ * @param a Левый конец отрезка
+ * @param b Правый конец отрезка
+ * @param options Параметры поиска
+ * @return Корни и статистика поиска
+ *
+ * @details
+ * Пара корней, лежащая внутри одного подотрезка, находится только
+ * если между ними есть экстремум f; корни ближе шага разбиения без
+ * смены знака f' могут быть пропущены — тогда увеличьте subintervals.
+ *
+ * Подотрезки с бесконечным или неопределённым значением f на конце
+ * (вне области определения, в полюсе) пропускаются. Скобка, в которой
+ * |f| после уточнения не уменьшилось, — полюс или разрыв (1/x в нуле):
+ * она не даёт корня и учитывается в RootScanResult::poles.
+ */
+RootScanResult findAllRoots(const Expression& f, double a, double b,
+                            const RootScanOptions& options = RootScanOptions());
+
+/**
+ * @brief Находит все вещественные корни уравнения на отрезке
+ * @param equation Текст уравнения (компилируется через ExpressionCache)
+ * @param a Левый конец отрезка
+ * @param b Правый конец отрезка
+ * @param options Параметры поиска
+ * @return Корни и статистика поиска
+ * @throw std::runtime_error при синтаксической ошибке
+ */
+RootScanResult findAllRoots(const QString& equation, double a, double b,
+                            const RootScanOptions& options = RootScanOptions());
+
+#endif // ROOTFINDER_H
@@ -10,6 +10,8 @@
 
 #include "sha1.h"
 #include <QCryptographicHash>
+#include <QtEndian>
+#include <cstring>
 
 QString sha1(const QString& input)
 {
@@ -19,3 +21,71 @@ QString sha1(const QString& input)
     );
     return hash.toHex();
 }
+
+QString sha1Bytes(const QByteArray& data)
+{
+    return QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex();
+}
+
+static inline quint32 rotateLeft(quint32 x, int n)
+{
+    return (x << n) | (x >> (32 - n));
+}
+
+void sha1Compress(quint32 state[5], const quint32 block[16])
+{
+    quint32 w[80];
+    for (int t = 0; t < 16; ++t) {
+        w[t] = block[t];
+    }
+    for (int t = 16; t < 80; ++t) {
+        w[t] = rotateLeft(w[t - 3] ^ w[t - 8] ^ w[t - 14] ^ w[t - 16], 1);
+    }
+
+    quint32 a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+
+    for (int t = 0; t < 80; ++t) {
+        quint32 f, k;
+        if (t < 20) {
+            f = (b & c) | (~b & d);
+            k = 0x5A827999u;
+        } else if (t < 40) {
+            f = b ^ c ^ d;
+            k = 0x6ED9EBA1u;
+        } else if (t < 60) {
+            f = (b & c) | (d & (b | c));
+            k = 0x8F1BBCDCu;
+        } else {
+            f = b ^ c ^ d;
+            k = 0xCA62C1D6u;
+        }
+
+        quint32 temp = rotateLeft(a, 5) + f + e + k + w[t];
+        e = d;
+        d = c;
+        c = rotateLeft(b, 30);
+        b = a;
+        a = temp;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+}
+
+void sha1SingleBlock(const uchar* message, int length, quint32 block[16])
+{
+    Q_ASSERT(length >= 0 && length <= 55);
+
+    uchar bytes[64];
+    std::memset(bytes, 0, sizeof(bytes));
+    std::memcpy(bytes, message, length);
+    bytes[length] = 0x80;
+    qToBigEndian<quint64>(quint64(length) * 8, bytes + 56);
+
+    for (int t = 0; t < 16; ++t) {
+        block[t] = qFromBigEndian<quint32>(bytes + 4 * t);
+    }
+}
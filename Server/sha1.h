@@ -52,4 +52,71 @@ public:
  */
 QString sha1(const QString& input);
 
+/**
+ * @brief Вычисляет SHA1 хеш для произвольных байтов
+ * @param data Входные данные без перекодирования
+ * @return Строка с SHA1 хешем в шестнадцатеричном формате
+ */
+QString sha1Bytes(const QByteArray& data);
+
+/**
+ * @brief Инкрементальное вычисление SHA1 по частям
+ *
+ * @details
+ * Позволяет хешировать данные, которые поступают фрагментами
+ * (файлы, сетевые пакеты), не собирая их в один буфер.
+ *
+ * @example
+ * @code
+ * Sha1Incremental hasher;
+ * hasher.addData(QByteArray("pass"));
+ * hasher.addData(QByteArray("word"));
+ * // hasher.result() == sha1("password")
+ * @endcode
+ */
+class Sha1Incremental {
+public:
+    Sha1Incremental() : hash(QCryptographicHash::Sha1) {}
+
+    /// Добавляет фрагмент байтов
+    void addData(const QByteArray& data) { hash.addData(data); }
+
+    /// Добавляет фрагмент текста в кодировке UTF-8
+    void addData(const QString& text) { hash.addData(text.toUtf8()); }
+
+    /// Сбрасывает состояние для нового сообщения
+    void reset() { hash.reset(); }
+
+    /// Хеш всех добавленных данных в шестнадцатеричном формате
+    QString result() const { return hash.result().toHex(); }
+
+private:
+    QCryptographicHash hash;
+};
+
+/// Начальное состояние SHA1 (FIPS 180-4, раздел 5.3.1)
+const quint32 SHA1_INITIAL_STATE[5] = {
+    0x67452301u, 0xEFCDAB89u, 0x98BADCFEu, 0x10325476u, 0xC3D2E1F0u
+};
+
+/**
+ * @brief Обрабатывает один 512-битный блок SHA1
+ * @param state Текущее состояние хеша (5 слов), обновляется на месте
+ * @param block 16 слов блока, уже прочитанных в порядке big-endian
+ *
+ * @details
+ * Низкоуровневая функция сжатия для кода, которому нужен собственный
+ * внутренний цикл (например, перебор прообразов в sha1search.cpp).
+ * Для обычного хеширования строк используйте sha1().
+ */
+void sha1Compress(quint32 state[5], const quint32 block[16]);
+
+/**
+ * @brief Формирует единственный блок SHA1 для короткого сообщения
+ * @param message Байты сообщения
+ * @param length Длина сообщения, не более 55 байт
+ * @param block Результат: 16 слов блока с дополнением и длиной
+ */
+void sha1SingleBlock(const uchar* message, int length, quint32 block[16]);
+
 #endif // SHA1_H
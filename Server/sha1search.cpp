@@ -0,0 +1,560 @@
+/**
+ * @file sha1search.cpp
+ * @brief Реализация поиска прообразов SHA1 коротких строк
+ * @date 2024
+ *
+ * @details
+ * Кандидаты набираются в пакеты по 8 штук и хешируются за один проход:
+ * в AVX2 каждая линия 256-битного регистра считает свой SHA1.
+ * Все кандидаты короче 56 байт, поэтому каждый занимает ровно один
+ * блок, а из результата сжатия нужно только первое слово.
+ */
+
+#include "sha1search.h"
+#include "sha1.h"
+#include "cpufeatures.h"
+#include "parallel.h"
+#include <QMutexLocker>
+#include <QDebug>
+#include <QtEndian>
+#include <QVector>
+#include <cstring>
+
+// Определение для константы, передаваемой по ссылке (qBound)
+const int Sha1PreimageSearch::MAX_CANDIDATE_LENGTH;
+
+namespace {
+
+const int LANES = 8;
+
+// Константы раундов SHA1
+const quint32 K0 = 0x5A827999u;
+const quint32 K1 = 0x6ED9EBA1u;
+const quint32 K2 = 0x8F1BBCDCu;
+const quint32 K3 = 0xCA62C1D6u;
+
+// Кандидатов на один диапазон полного перебора (не меньше)
+const quint64 MIN_RANGE_SIZE = 1u << 16;
+
+// Кандидатов между обновлениями общего счётчика
+const int TESTED_FLUSH_INTERVAL = 4096;
+
+// Слов словаря на одно задание
+const int WORDS_PER_TASK = 256;
+
+inline quint32 rotateLeft(quint32 x, int n)
+{
+    return (x << n) | (x >> (32 - n));
+}
+
+// Первое слово SHA1 для одного блока без вычисления остальных слов
+quint32 sha1FirstWord(const quint32 block[16])
+{
+    quint32 w[16];
+    std::memcpy(w, block, sizeof(w));
+
+    quint32 a = SHA1_INITIAL_STATE[0], b = SHA1_INITIAL_STATE[1], c = SHA1_INITIAL_STATE[2];
+    quint32 d = SHA1_INITIAL_STATE[3], e = SHA1_INITIAL_STATE[4];
+
+    for (int t = 0; t < 80; ++t) {
+        if (t >= 16) {
+            w[t & 15] = rotateLeft(w[(t - 3) & 15] ^ w[(t - 8) & 15] ^ w[(t - 14) & 15] ^ w[t & 15], 1);
+        }
+
+        quint32 f, k;
+        if (t < 20) {
+            f = (b & c) | (~b & d);
+            k = K0;
+        } else if (t < 40) {
+            f = b ^ c ^ d;
+            k = K1;
+        } else if (t < 60) {
+            f = (b & c) | (d & (b | c));
+            k = K2;
+        } else {
+            f = b ^ c ^ d;
+            k = K3;
+        }
+
+        quint32 temp = rotateLeft(a, 5) + f + e + k + w[t & 15];
+        e = d;
+        d = c;
+        c = rotateLeft(b, 30);
+        b = a;
+        a = temp;
+    }
+
+    return a + SHA1_INITIAL_STATE[0];
+}
+
+void firstWordsScalar(const quint32 words[16][LANES], int lanes, quint32 out[LANES])
+{
+    for (int lane = 0; lane < lanes; ++lane) {
+        quint32 block[16];
+        for (int t = 0; t < 16; ++t) {
+            block[t] = words[t][lane];
+        }
+        out[lane] = sha1FirstWord(block);
+    }
+}
+
+#if HAVE_X86_SIMD
+
+template <int N>
+TARGET_AVX2 inline __m256i rotl(__m256i x)
+{
+    return _mm256_or_si256(_mm256_slli_epi32(x, N), _mm256_srli_epi32(x, 32 - N));
+}
+
+// Один раунд SHA1 в восьми линиях; F — номер группы раундов (0..3)
+template <int F>
+TARGET_AVX2 inline void avx2Round(__m256i& a, __m256i& b, __m256i& c, __m256i& d, __m256i& e,
+                                  __m256i k, __m256i wt)
+{
+    __m256i f;
+    if (F == 0) {
+        f = _mm256_or_si256(_mm256_and_si256(b, c), _mm256_andnot_si256(b, d));
+    } else if (F == 2) {
+        f = _mm256_or_si256(_mm256_and_si256(b, c), _mm256_and_si256(d, _mm256_or_si256(b, c)));
+    } else {
+        f = _mm256_xor_si256(_mm256_xor_si256(b, c), d);
+    }
+
+    __m256i temp = _mm256_add_epi32(_mm256_add_epi32(rotl<5>(a), f),
+                                    _mm256_add_epi32(_mm256_add_epi32(e, k), wt));
+    e = d;
+    d = c;
+    c = rotl<30>(b);
+    b = a;
+    a = temp;
+}
+
+TARGET_AVX2 inline __m256i avx2Schedule(__m256i w[16], int t)
+{
+    __m256i x = _mm256_xor_si256(_mm256_xor_si256(w[(t - 3) & 15], w[(t - 8) & 15]),
+                                 _mm256_xor_si256(w[(t - 14) & 15], w[t & 15]));
+    w[t & 15] = rotl<1>(x);
+    return w[t & 15];
+}
+
+TARGET_AVX2 void firstWordsAvx2(const quint32 words[16][LANES], quint32 out[LANES])
+{
+    __m256i w[16];
+    for (int t = 0; t < 16; ++t) {
+        w[t] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words[t]));
+    }
+
+    __m256i a = _mm256_set1_epi32(int(SHA1_INITIAL_STATE[0]));
+    __m256i b = _mm256_set1_epi32(int(SHA1_INITIAL_STATE[1]));
+    __m256i c = _mm256_set1_epi32(int(SHA1_INITIAL_STATE[2]));
+    __m256i d = _mm256_set1_epi32(int(SHA1_INITIAL_STATE[3]));
+    __m256i e = _mm256_set1_epi32(int(SHA1_INITIAL_STATE[4]));
+
+    const __m256i k0 = _mm256_set1_epi32(int(K0));
+    const __m256i k1 = _mm256_set1_epi32(int(K1));
+    const __m256i k2 = _mm256_set1_epi32(int(K2));
+    const __m256i k3 = _mm256_set1_epi32(int(K3));
+
+    for (int t = 0; t < 16; ++t) {
+        avx2Round<0>(a, b, c, d, e, k0, w[t]);
+    }
+    for (int t = 16; t < 20; ++t) {
+        avx2Round<0>(a, b, c, d, e, k0, avx2Schedule(w, t));
+    }
+    for (int t = 20; t < 40; ++t) {
+        avx2Round<1>(a, b, c, d, e, k1, avx2Schedule(w, t));
+    }
+    for (int t = 40; t < 60; ++t) {
+        avx2Round<2>(a, b, c, d, e, k2, avx2Schedule(w, t));
+    }
+    for (int t = 60; t < 80; ++t) {
+        avx2Round<3>(a, b, c, d, e, k3, avx2Schedule(w, t));
+    }
+
+    a = _mm256_add_epi32(a, _mm256_set1_epi32(int(SHA1_INITIAL_STATE[0])));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), a);
+}
+
+#endif // HAVE_X86_SIMD
+
+} // namespace
+
+struct Sha1PreimageSearch::Batch {
+    /// Блоки кандидатов, транспонированные по линиям. Обнулены заранее:
+    /// AVX2 считает все линии, и в неполной последней пачке хвостовые
+    /// линии не должны читать неинициализированную память.
+    quint32 words[16][LANES] = {};
+    uchar candidates[LANES][MAX_CANDIDATE_LENGTH];  ///< Сами кандидаты для проверки и результата
+    int lengths[LANES] = {};
+    int size = 0;
+    int pendingTested = 0;
+
+    void setBlock(int lane, const quint32 block[16])
+    {
+        for (int t = 0; t < 16; ++t) {
+            words[t][lane] = block[t];
+        }
+    }
+};
+
+Sha1PreimageSearch::Sha1PreimageSearch(const QString& targetHex)
+    : valid(false)
+    , charset("abcdefghijklmnopqrstuvwxyz")
+    , minLength(0)
+    , maxLength(7)
+    , threadCount(0)
+    , progressIntervalMs(1000)
+    , found(false)
+    , cancelled(false)
+    , tested(0)
+    , nextReportMs(0)
+    , total(0)
+    , usedThreads(0)
+    , lastElapsedMs(0)
+{
+    QByteArray digest = QByteArray::fromHex(targetHex.trimmed().toLatin1());
+    valid = (digest.size() == 20 && targetHex.trimmed().size() == 40);
+    for (int i = 0; i < 5; ++i) {
+        target[i] = valid ? qFromBigEndian<quint32>(reinterpret_cast<const uchar*>(digest.constData()) + 4 * i) : 0;
+    }
+}
+
+void Sha1PreimageSearch::setProgressCallback(std::function<void(const Sha1SearchProgress&)> callback, int intervalMs)
+{
+    progressCallback = std::move(callback);
+    progressIntervalMs = qMax(1, intervalMs);
+}
+
+bool Sha1PreimageSearch::simdAvailable()
+{
+    return useAvx2();
+}
+
+quint64 Sha1PreimageSearch::keyspaceSize(int charsetSize, int minLength, int maxLength)
+{
+    if (charsetSize <= 0 || minLength > maxLength) {
+        return 0;
+    }
+
+    quint64 sum = 0;
+    quint64 count = 1;
+    for (int length = 0; length <= maxLength; ++length) {
+        if (length >= minLength) {
+            if (sum > ~quint64(0) - count) {
+                return 0;
+            }
+            sum += count;
+        }
+        if (length < maxLength) {
+            if (count > ~quint64(0) / quint64(charsetSize)) {
+                return 0;
+            }
+            count *= quint64(charsetSize);
+        }
+    }
+    return sum;
+}
+
+QString Sha1PreimageSearch::result() const
+{
+    QMutexLocker locker(&resultMutex);
+    return QString::fromUtf8(foundValue);
+}
+
+Sha1SearchProgress Sha1PreimageSearch::progress() const
+{
+    Sha1SearchProgress p = snapshot();
+    p.elapsedMs = lastElapsedMs;
+    p.hashesPerSecond = lastElapsedMs > 0 ? p.tested * 1000.0 / lastElapsedMs : 0.0;
+    return p;
+}
+
+Sha1SearchProgress Sha1PreimageSearch::snapshot() const
+{
+    Sha1SearchProgress p;
+    p.tested = tested.load(std::memory_order_relaxed);
+    p.total = total;
+    p.threads = usedThreads;
+    p.elapsedMs = timer.isValid() ? timer.elapsed() : 0;
+    p.hashesPerSecond = p.elapsedMs > 0 ? p.tested * 1000.0 / p.elapsedMs : 0.0;
+    return p;
+}
+
+void Sha1PreimageSearch::reset(quint64 keyspace)
+{
+    found.store(false);
+    cancelled.store(false);
+    tested.store(0);
+    nextReportMs.store(progressIntervalMs);
+    total = keyspace;
+    usedThreads = threadCount > 0 ? threadCount : defaultThreadCount();
+    lastElapsedMs = 0;
+    {
+        QMutexLocker locker(&resultMutex);
+        foundValue.clear();
+    }
+    timer.start();
+}
+
+void Sha1PreimageSearch::finish()
+{
+    lastElapsedMs = timer.elapsed();
+    if (progressCallback) {
+        progressCallback(progress());
+    }
+}
+
+void Sha1PreimageSearch::addTested(quint64 count)
+{
+    tested.fetch_add(count, std::memory_order_relaxed);
+
+    if (!progressCallback) {
+        return;
+    }
+
+    // Отчёт выдаёт тот поток, который первым «занял» очередной интервал
+    qint64 now = timer.elapsed();
+    qint64 due = nextReportMs.load(std::memory_order_relaxed);
+    if (now >= due && nextReportMs.compare_exchange_strong(due, now + progressIntervalMs)) {
+        progressCallback(snapshot());
+    }
+}
+
+void Sha1PreimageSearch::flushBatch(Batch& batch)
+{
+    if (batch.size == 0) {
+        return;
+    }
+
+    quint32 first[LANES];
+#if HAVE_X86_SIMD
+    if (useAvx2()) {
+        firstWordsAvx2(batch.words, first);
+    } else
+#endif
+    {
+        firstWordsScalar(batch.words, batch.size, first);
+    }
+
+    for (int lane = 0; lane < batch.size; ++lane) {
+        if (first[lane] != target[0]) {
+            continue;
+        }
+
+        // Первое слово совпало — проверяем хеш целиком
+        quint32 block[16];
+        quint32 state[5];
+        std::memcpy(state, SHA1_INITIAL_STATE, sizeof(state));
+        sha1SingleBlock(batch.candidates[lane], batch.lengths[lane], block);
+        sha1Compress(state, block);
+
+        if (std::memcmp(state, target, sizeof(state)) == 0) {
+            QMutexLocker locker(&resultMutex);
+            if (!found.load()) {
+                foundValue = QByteArray(reinterpret_cast<const char*>(batch.candidates[lane]), batch.lengths[lane]);
+                found.store(true);
+            }
+        }
+    }
+
+    batch.pendingTested += batch.size;
+    if (batch.pendingTested >= TESTED_FLUSH_INTERVAL) {
+        addTested(batch.pendingTested);
+        batch.pendingTested = 0;
+    }
+    batch.size = 0;
+}
+
+void Sha1PreimageSearch::searchRange(const Range& range)
+{
+    if (stopRequested()) {
+        return;
+    }
+
+    const int n = charset.size();
+    const int length = range.length;
+    const int changingWords = length / 4 + 1; // слова с символами и байтом 0x80
+
+    // Переводим начальный индекс в «цифры» по основанию n
+    int digits[MAX_CANDIDATE_LENGTH];
+    uchar bytes[64];
+    quint64 index = range.begin;
+    for (int p = length - 1; p >= 0; --p) {
+        digits[p] = int(index % quint64(n));
+        bytes[p] = uchar(charset[digits[p]]);
+        index /= quint64(n);
+    }
+
+    Batch batch;
+    quint32 block[16];
+    sha1SingleBlock(bytes, length, block);
+    for (int lane = 0; lane < LANES; ++lane) {
+        batch.setBlock(lane, block);
+        batch.lengths[lane] = length;
+    }
+    std::memset(bytes + length, 0, sizeof(bytes) - length);
+    bytes[length] = 0x80;
+
+    quint64 remaining = range.end - range.begin;
+    while (remaining > 0) {
+        const int lane = batch.size;
+        for (int q = 0; q < changingWords; ++q) {
+            batch.words[q][lane] = qFromBigEndian<quint32>(bytes + 4 * q);
+        }
+        std::memcpy(batch.candidates[lane], bytes, length);
+
+        // Следующий кандидат: «одометр» с переносом справа налево
+        for (int p = length - 1; p >= 0; --p) {
+            if (++digits[p] < n) {
+                bytes[p] = uchar(charset[digits[p]]);
+                break;
+            }
+            digits[p] = 0;
+            bytes[p] = uchar(charset[0]);
+        }
+
+        --remaining;
+        if (++batch.size == LANES) {
+            flushBatch(batch);
+            if (stopRequested()) {
+                break;
+            }
+        }
+    }
+
+    flushBatch(batch);
+    addTested(batch.pendingTested);
+}
+
+bool Sha1PreimageSearch::bruteForce()
+{
+    if (!valid || charset.isEmpty() || minLength > maxLength) {
+        return false;
+    }
+
+    const quint64 keyspace = keyspaceSize(charset.size(), minLength, maxLength);
+    if (keyspace == 0) {
+        qWarning() << "Sha1PreimageSearch: пространство перебора не помещается в 64 бита";
+        return false;
+    }
+
+    reset(keyspace);
+
+    // Делим каждую длину на диапазоны так, чтобы на поток приходилось много заданий
+    QVector<Range> ranges;
+    quint64 count = 1;
+    for (int length = 0; length <= maxLength; ++length) {
+        if (length >= minLength) {
+            quint64 rangeSize = qMax(MIN_RANGE_SIZE, count / quint64(usedThreads * 64));
+            for (quint64 begin = 0; begin < count; begin += rangeSize) {
+                ranges.append({length, begin, qMin(count, begin + rangeSize)});
+            }
+        }
+        count *= quint64(charset.size());
+    }
+
+    usedThreads = parallelFor(ranges.size(), [&](int i) { searchRange(ranges[i]); }, usedThreads);
+    finish();
+    return found.load();
+}
+
+void Sha1PreimageSearch::searchWords(const QStringList& words, int begin, int end, int rules)
+{
+    static const char* const leetFrom = "aeios";
+    static const char* const leetTo = "43105";
+
+    Batch batch;
+    QVector<QByteArray> bases;
+
+    auto emitCandidate = [&](const QByteArray& candidate) {
+        if (candidate.size() > MAX_CANDIDATE_LENGTH) {
+            return;
+        }
+        const int lane = batch.size;
+        quint32 block[16];
+        sha1SingleBlock(reinterpret_cast<const uchar*>(candidate.constData()), candidate.size(), block);
+        batch.setBlock(lane, block);
+        std::memcpy(batch.candidates[lane], candidate.constData(), candidate.size());
+        batch.lengths[lane] = candidate.size();
+        if (++batch.size == LANES) {
+            flushBatch(batch);
+        }
+    };
+
+    for (int i = begin; i < end && !stopRequested(); ++i) {
+        const QString& word = words[i];
+
+        bases.clear();
+        auto addBase = [&](const QString& form) {
+            QByteArray utf8 = form.toUtf8();
+            if (!bases.contains(utf8)) {
+                bases.append(utf8);
+            }
+        };
+
+        if (rules & AsIs || !(rules & (Capitalize | UpperCase | Reverse | Leet))) {
+            addBase(word);
+        }
+        if (rules & Capitalize) {
+            addBase(word.left(1).toUpper() + word.mid(1));
+        }
+        if (rules & UpperCase) {
+            addBase(word.toUpper());
+        }
+        if (rules & Reverse) {
+            QString reversed;
+            reversed.reserve(word.size());
+            for (int j = word.size() - 1; j >= 0; --j) {
+                reversed.append(word[j]);
+            }
+            addBase(reversed);
+        }
+        if (rules & Leet) {
+            QString leet = word;
+            for (int j = 0; leetFrom[j]; ++j) {
+                leet.replace(QChar(leetFrom[j]), QChar(leetTo[j]), Qt::CaseInsensitive);
+            }
+            addBase(leet);
+        }
+
+        for (const QByteArray& base : bases) {
+            emitCandidate(base);
+            if (rules & AppendDigit) {
+                for (int digit = 0; digit < 10; ++digit) {
+                    emitCandidate(base + char('0' + digit));
+                }
+            }
+            if (rules & AppendTwoDigits) {
+                for (int number = 0; number < 100; ++number) {
+                    emitCandidate(base + char('0' + number / 10) + char('0' + number % 10));
+                }
+            }
+        }
+    }
+
+    flushBatch(batch);
+    addTested(batch.pendingTested);
+}
+
+bool Sha1PreimageSearch::dictionary(const QStringList& words, int rules)
+{
+    if (!valid || words.isEmpty()) {
+        return false;
+    }
+
+    int forms = 0;
+    for (int rule : {AsIs, Capitalize, UpperCase, Reverse, Leet}) {
+        forms += (rules & rule) ? 1 : 0;
+    }
+    const int suffixes = 1 + ((rules & AppendDigit) ? 10 : 0) + ((rules & AppendTwoDigits) ? 100 : 0);
+    reset(quint64(words.size()) * quint64(qMax(1, forms)) * quint64(suffixes));
+
+    const int tasks = (words.size() + WORDS_PER_TASK - 1) / WORDS_PER_TASK;
+    usedThreads = parallelFor(tasks, [&](int task) {
+        const int begin = task * WORDS_PER_TASK;
+        searchWords(words, begin, qMin(words.size(), begin + WORDS_PER_TASK), rules);
+    }, usedThreads);
+
+    finish();
+    return found.load();
+}
@@ -0,0 +1,181 @@
+/**
+ * @file sha1search.h
+ * @brief Заголовочный файл для поиска прообразов SHA1 коротких строк
+ * @date 2024
+ *
+ * @details
+ * Реализует перебор строк, чей SHA1 совпадает с заданным хешем:
+ * полный перебор по алфавиту (строчные ASCII-символы до ~7 знаков)
+ * и словарную атаку с правилами модификации слов.
+ * Используется для упражнения «обратный хеш» к задаче 1 и для
+ * административного восстановления строк по их хешам.
+ *
+ * Пространство ключей делится на диапазоны, которые обрабатываются
+ * всеми ядрами. Внутренний цикл хеширует 8 кандидатов одновременно
+ * в линиях AVX2 и сравнивает сначала только первое слово хеша;
+ * полная проверка выполняется лишь для редких совпадений.
+ *
+ * @see sha1.h
+ */
+
+#ifndef SHA1SEARCH_H
+#define SHA1SEARCH_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <atomic>
+#include <functional>
+
+/**
+ * @brief Состояние и производительность перебора
+ */
+struct Sha1SearchProgress {
+    quint64 tested = 0;          ///< Проверено кандидатов
+    quint64 total = 0;           ///< Размер пространства ключей (0 если неизвестен)
+    qint64 elapsedMs = 0;        ///< Прошло времени, мс
+    double hashesPerSecond = 0;  ///< Общая скорость, хешей/с
+    int threads = 0;             ///< Число рабочих потоков
+
+    /// Скорость в пересчёте на одно ядро
+    double hashesPerSecondPerCore() const { return threads > 0 ? hashesPerSecond / threads : 0.0; }
+};
+
+/**
+ * @brief Класс для поиска прообразов SHA1
+ *
+ * @example
+ * @code
+ * Sha1PreimageSearch search(sha1("abc"));
+ * search.setMaxLength(5);
+ * if (search.bruteForce()) {
+ *     // search.result() == "abc"
+ * }
+ * @endcode
+ */
+class Sha1PreimageSearch {
+public:
+    /// Правила модификации слов словаря (можно комбинировать)
+    enum Rule {
+        AsIs            = 0x01, ///< Слово без изменений
+        Capitalize      = 0x02, ///< Первая буква заглавная
+        UpperCase       = 0x04, ///< Все буквы заглавные
+        Reverse         = 0x08, ///< Слово задом наперёд
+        AppendDigit     = 0x10, ///< Дописать цифру 0–9
+        AppendTwoDigits = 0x20, ///< Дописать число 00–99
+        Leet            = 0x40, ///< Замены a→4, e→3, i→1, o→0, s→5
+        AllRules        = 0x7F
+    };
+
+    /// Максимальная длина кандидата: сообщение должно помещаться в один блок
+    static const int MAX_CANDIDATE_LENGTH = 55;
+
+    /**
+     * @brief Конструктор
+     * @param targetHex Искомый SHA1 хеш в шестнадцатеричном виде
+     */
+    explicit Sha1PreimageSearch(const QString& targetHex);
+
+    /// Корректен ли заданный хеш (40 шестнадцатеричных символов)
+    bool isValid() const { return valid; }
+
+    /// Алфавит полного перебора (по умолчанию a–z)
+    void setCharset(const QByteArray& chars) { charset = chars; }
+
+    /// Минимальная длина строки при полном переборе (по умолчанию 0)
+    void setMinLength(int length) { minLength = qMax(0, length); }
+
+    /// Максимальная длина строки при полном переборе (по умолчанию 7)
+    void setMaxLength(int length) { maxLength = qBound(0, length, MAX_CANDIDATE_LENGTH); }
+
+    /// Число потоков (0 — по числу ядер)
+    void setThreadCount(int count) { threadCount = qMax(0, count); }
+
+    /**
+     * @brief Задаёт обработчик прогресса
+     * @param callback Функция, получающая текущее состояние перебора
+     * @param intervalMs Минимальный интервал между вызовами, мс
+     *
+     * @note Обработчик вызывается из рабочих потоков.
+     */
+    void setProgressCallback(std::function<void(const Sha1SearchProgress&)> callback, int intervalMs = 1000);
+
+    /**
+     * @brief Полный перебор всех строк из алфавита заданных длин
+     * @return true если прообраз найден
+     */
+    bool bruteForce();
+
+    /**
+     * @brief Словарная атака с правилами модификации
+     * @param words Список слов
+     * @param rules Комбинация флагов Rule
+     * @return true если прообраз найден
+     */
+    bool dictionary(const QStringList& words, int rules = AsIs | Capitalize | AppendDigit);
+
+    /// Прерывает текущий перебор (можно вызывать из другого потока)
+    void cancel() { cancelled.store(true); }
+
+    /// Найденная строка (пустая, если ничего не найдено)
+    QString result() const;
+
+    /// Итоговая статистика последнего запуска
+    Sha1SearchProgress progress() const;
+
+    /// Используется ли векторное ядро AVX2
+    static bool simdAvailable();
+
+    /**
+     * @brief Вычисляет размер пространства перебора
+     * @param charsetSize Размер алфавита
+     * @param minLength Минимальная длина
+     * @param maxLength Максимальная длина
+     * @return Количество строк или 0 при переполнении 64 бит
+     */
+    static quint64 keyspaceSize(int charsetSize, int minLength, int maxLength);
+
+private:
+    struct Range {
+        int length;
+        quint64 begin;
+        quint64 end;
+    };
+
+    struct Batch;
+
+    quint32 target[5];
+    bool valid;
+    QByteArray charset;
+    int minLength;
+    int maxLength;
+    int threadCount;
+
+    std::function<void(const Sha1SearchProgress&)> progressCallback;
+    int progressIntervalMs;
+
+    std::atomic<bool> found;
+    std::atomic<bool> cancelled;
+    std::atomic<quint64> tested;
+    std::atomic<qint64> nextReportMs;
+    quint64 total;
+    int usedThreads;
+    QElapsedTimer timer;
+    qint64 lastElapsedMs;
+
+    mutable QMutex resultMutex;
+    QByteArray foundValue;
+
+    void reset(quint64 keyspace);
+    void finish();
+    void searchRange(const Range& range);
+    void searchWords(const QStringList& words, int begin, int end, int rules);
+    void flushBatch(Batch& batch);
+    bool stopRequested() const { return found.load(std::memory_order_relaxed) || cancelled.load(std::memory_order_relaxed); }
+    void addTested(quint64 count);
+    Sha1SearchProgress snapshot() const;
+};
+
+#endif // SHA1SEARCH_H
@@ -0,0 +1,89 @@
+/**
+ * @file stegcontainer.cpp
+ * @brief Реализация формата контейнера скрытого сообщения
+ * @date 2024
+ */
+
+#include "stegcontainer.h"
+
+namespace {
+
+const char SIGNATURE[] = "\x89STG";
+const int SIGNATURE_SIZE = 4;
+
+// Таблица CRC-32 для отражённого полинома 0xEDB88320
+struct Crc32Table {
+    quint32 entries[256];
+
+    Crc32Table()
+    {
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            entries[i] = c;
+        }
+    }
+};
+
+void appendLe32(QByteArray& bytes, quint32 value)
+{
+    for (int i = 0; i < 4; ++i) {
+        bytes.append(char((value >> (8 * i)) & 0xFF));
+    }
+}
+
+quint32 readLe32(const QByteArray& bytes, int offset)
+{
+    const uchar* p = reinterpret_cast<const uchar*>(bytes.constData()) + offset;
+    return quint32(p[0]) | (quint32(p[1]) << 8) | (quint32(p[2]) << 16) | (quint32(p[3]) << 24);
+}
+
+} // namespace
+
+quint32 crc32(const char* data, qint64 size, quint32 crc)
+{
+    static const Crc32Table table;
+    const uchar* p = reinterpret_cast<const uchar*>(data);
+    crc = ~crc;
+    for (qint64 i = 0; i < size; ++i) {
+        crc = table.entries[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+QByteArray packStegContainer(const QByteArray& payload, quint8 flags)
+{
+    QByteArray container(SIGNATURE, SIGNATURE_SIZE);
+    container.reserve(STEG_HEADER_SIZE + payload.size());
+    container.append(char(STEG_CONTAINER_VERSION));
+    container.append(char(flags));
+    appendLe32(container, quint32(payload.size()));
+    appendLe32(container, crc32(payload.constData(), payload.size()));
+    container.append(payload);
+    return container;
+}
+
+bool hasStegSignature(const QByteArray& bytes)
+{
+    return bytes.startsWith(QByteArray::fromRawData(SIGNATURE, SIGNATURE_SIZE));
+}
+
+QString parseStegHeader(const QByteArray& bytes, StegHeader& header)
+{
+    if (bytes.size() < STEG_HEADER_SIZE || !hasStegSignature(bytes)) {
+        return "Missing container signature";
+    }
+    header.version = quint8(bytes[4]);
+    header.flags = quint8(bytes[5]);
+    header.length = readLe32(bytes, 6);
+    header.crc = readLe32(bytes, 10);
+    if (header.version != STEG_CONTAINER_VERSION) {
+        return QString("Unsupported container version %1").arg(int(header.version));
+    }
+    if (header.flags & ~STEG_FLAG_BITS_MASK) {
+        return QString("Unsupported container flags 0x%1").arg(int(header.flags), 2, 16, QChar('0'));
+    }
+    return QString();
+}
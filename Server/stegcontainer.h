@@ -0,0 +1,91 @@
+/**
+ * @file stegcontainer.h
+ * @brief Формат контейнера скрытого сообщения
+ * @date 2024
+ *
+ * @details
+ * Сообщение встраивается не с нулевым байтом в конце, а с заголовком
+ * фиксированной длины:
+ *
+ * | Смещение | Размер | Поле                                   |
+ * |----------|--------|----------------------------------------|
+ * | 0        | 4      | Сигнатура 0x89 'S' 'T' 'G'             |
+ * | 4        | 1      | Версия формата (STEG_CONTAINER_VERSION) |
+ * | 5        | 1      | Флаги                                  |
+ * | 6        | 4      | Длина сообщения, байт (little-endian)  |
+ * | 10       | 4      | CRC-32 сообщения (little-endian)       |
+ *
+ * Заголовок всегда занимает младший бит отсчёта; флаги задают, сколько
+ * младших битов каждого отсчёта (1–4) несут само сообщение.
+ *
+ * Зная длину, извлечение читает ровно заголовок и сообщение, а CRC
+ * отличает сообщение от случайных младших битов. Первый байт
+ * сигнатуры не может начинать текст UTF-8, поэтому контейнер не
+ * путается с сообщением старого формата (текст и нулевой байт).
+ *
+ * @see wavembed.h
+ */
+
+#ifndef STEGCONTAINER_H
+#define STEGCONTAINER_H
+
+#include <QByteArray>
+#include <QString>
+
+/// Размер заголовка контейнера, байт
+const int STEG_HEADER_SIZE = 14;
+
+/// Текущая версия формата
+const quint8 STEG_CONTAINER_VERSION = 1;
+
+/// Флаги: число битов сообщения на отсчёт минус 1 (0..3)
+const quint8 STEG_FLAG_BITS_MASK = 0x03;
+
+/**
+ * @brief Заголовок контейнера
+ */
+struct StegHeader {
+    quint8 version = STEG_CONTAINER_VERSION;  ///< Версия формата
+    quint8 flags = 0;                         ///< Флаги (STEG_FLAG_BITS_MASK)
+    quint32 length = 0;                       ///< Длина сообщения, байт
+    quint32 crc = 0;                          ///< CRC-32 сообщения
+};
+
+/**
+ * @brief Вычисляет CRC-32 (полином IEEE 802.3, как в zlib)
+ * @param data Данные
+ * @param size Размер данных
+ * @param crc Значение для предыдущих фрагментов (0 для начала)
+ * @return CRC-32 всех данных
+ */
+quint32 crc32(const char* data, qint64 size, quint32 crc = 0);
+
+/// Флаги для bits битов сообщения на отсчёт
+inline quint8 stegFlagsForBits(int bits) { return quint8((bits - 1) & STEG_FLAG_BITS_MASK); }
+
+/// Число битов сообщения на отсчёт по флагам
+inline int stegBitsFromFlags(quint8 flags) { return (flags & STEG_FLAG_BITS_MASK) + 1; }
+
+/**
+ * @brief Упаковывает сообщение в контейнер
+ * @param payload Сообщение
+ * @param flags Флаги заголовка
+ * @return Заголовок и сообщение
+ */
+QByteArray packStegContainer(const QByteArray& payload, quint8 flags = 0);
+
+/**
+ * @brief Проверяет, начинаются ли байты с сигнатуры контейнера
+ * @param bytes Первые байты встроенных данных (не меньше 4)
+ */
+bool hasStegSignature(const QByteArray& bytes);
+
+/**
+ * @brief Разбирает заголовок контейнера
+ * @param bytes Первые STEG_HEADER_SIZE байт встроенных данных
+ * @param header Разобранный заголовок
+ * @return Текст ошибки или пустая строка
+ */
+QString parseStegHeader(const QByteArray& bytes, StegHeader& header);
+
+#endif // STEGCONTAINER_H
@@ -0,0 +1,260 @@
+/**
+ * @file streampipeline.cpp
+ * @brief Реализация конвейера чтение → обработка → запись
+ * @date 2024
+ */
+
+#include "streampipeline.h"
+#include <QElapsedTimer>
+#include <QIODevice>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QQueue>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+
+namespace {
+
+// Очередь номеров буферов между стадиями
+class BufferQueue {
+public:
+    void push(int index)
+    {
+        QMutexLocker locker(&mutex);
+        if (aborted) {
+            return;
+        }
+        items.enqueue(index);
+        ready.wakeOne();
+    }
+
+    /// Ждёт очередной буфер; false — очередь закрыта и пуста
+    bool pop(int& index)
+    {
+        QMutexLocker locker(&mutex);
+        while (items.isEmpty() && !closed) {
+            ready.wait(&mutex);
+        }
+        if (aborted || items.isEmpty()) {
+            return false;
+        }
+        index = items.dequeue();
+        return true;
+    }
+
+    /// Больше буферов не будет; оставшиеся ещё можно забрать
+    void close()
+    {
+        QMutexLocker locker(&mutex);
+        closed = true;
+        ready.wakeAll();
+    }
+
+    /// Остановка конвейера: буферы больше не выдаются
+    void abort()
+    {
+        QMutexLocker locker(&mutex);
+        items.clear();
+        closed = true;
+        aborted = true;
+        ready.wakeAll();
+    }
+
+private:
+    QMutex mutex;
+    QWaitCondition ready;
+    QQueue<int> items;
+    bool closed = false;
+    bool aborted = false;
+};
+
+// Поток стадии конвейера
+class StageThread : public QThread {
+public:
+    explicit StageThread(std::function<void()> body) : body(std::move(body)) {}
+
+protected:
+    void run() override { body(); }
+
+private:
+    std::function<void()> body;
+};
+
+struct Buffer {
+    QByteArray data;
+    qint64 offset = 0;  // от начала диапазона
+    qint64 size = 0;
+};
+
+} // namespace
+
+StreamPipeline::StreamPipeline(qint64 bufferSize, int bufferCount)
+    : cancelled(false)
+{
+    setBuffers(bufferSize, bufferCount);
+}
+
+void StreamPipeline::setBuffers(qint64 bufferSize, int bufferCount)
+{
+    size = qBound<qint64>(1, bufferSize, 1 << 30);
+    count = qMax(2, bufferCount);
+}
+
+void StreamPipeline::setProgressCallback(std::function<void(const StreamPipelineStats&)> callback, int intervalMs)
+{
+    progressCallback = std::move(callback);
+    progressIntervalMs = qMax(0, intervalMs);
+}
+
+bool StreamPipeline::run(QIODevice& input, qint64 inputOffset, qint64 length, QIODevice* output,
+                         qint64 outputOffset, const Processor& process)
+{
+    lastError.clear();
+    lastStats = StreamPipelineStats();
+    lastStats.total = length;
+    lastStats.memory = size * count;
+    lastCancelled = false;
+
+    // Отмена, запрошенная до запуска, прерывает его сразу и на этом снимается
+    if (cancelled.exchange(false)) {
+        lastCancelled = true;
+        lastError = "Cancelled";
+        return false;
+    }
+    if (!input.seek(inputOffset)) {
+        lastError = "Cannot seek in input file";
+        return false;
+    }
+    if (output && !output->seek(outputOffset)) {
+        lastError = "Cannot seek in output file";
+        return false;
+    }
+
+    QVector<Buffer> buffers(count);
+    BufferQueue freeBuffers;
+    BufferQueue filled;
+    BufferQueue processed;
+    for (int i = 0; i < count; ++i) {
+        buffers[i].data.resize(int(size));
+        freeBuffers.push(i);
+    }
+
+    std::atomic<bool> failed(false);
+    std::atomic<qint64> readNs(0);
+    std::atomic<qint64> writeNs(0);
+    QString readError;
+    QString writeError;
+    auto stop = [&]() {
+        failed.store(true);
+        freeBuffers.abort();
+        filled.abort();
+        processed.abort();
+    };
+
+    StageThread reader([&]() {
+        QElapsedTimer timer;
+        int index;
+        for (qint64 position = 0; position < length && freeBuffers.pop(index); ) {
+            Buffer& buffer = buffers[index];
+            buffer.offset = position;
+            buffer.size = qMin(size, length - position);
+            timer.start();
+            const qint64 read = input.read(buffer.data.data(), buffer.size);
+            readNs.fetch_add(timer.nsecsElapsed(), std::memory_order_relaxed);
+            if (read != buffer.size) {
+                readError = read < 0 ? "Read error: " + input.errorString() : QString("Unexpected end of input file");
+                stop();
+                break;
+            }
+            position += read;
+            filled.push(index);
+        }
+        filled.close();
+    });
+
+    StageThread writer([&]() {
+        QElapsedTimer timer;
+        int index;
+        while (processed.pop(index)) {
+            const Buffer& buffer = buffers[index];
+            timer.start();
+            const qint64 written = output->write(buffer.data.constData(), buffer.size);
+            writeNs.fetch_add(timer.nsecsElapsed(), std::memory_order_relaxed);
+            if (written != buffer.size) {
+                writeError = "Write error: " + output->errorString();
+                stop();
+                break;
+            }
+            freeBuffers.push(index);
+        }
+    });
+
+    QElapsedTimer timer;
+    timer.start();
+    auto snapshot = [&]() {
+        lastStats.elapsedNs = timer.nsecsElapsed();
+        lastStats.readNs = readNs.load(std::memory_order_relaxed);
+        lastStats.writeNs = writeNs.load(std::memory_order_relaxed);
+        return lastStats;
+    };
+
+    reader.start();
+    if (output) {
+        writer.start();
+    }
+
+    // Обработка — в вызывающем потоке, по порядку
+    QElapsedTimer processTimer;
+    qint64 nextReportNs = qint64(progressIntervalMs) * 1000000;
+    int index;
+    while (filled.pop(index)) {
+        if (cancelled.load()) {
+            stop();
+            break;
+        }
+        Buffer& buffer = buffers[index];
+        processTimer.start();
+        const bool ok = process(buffer.data.data(), buffer.size, buffer.offset);
+        lastStats.processNs += processTimer.nsecsElapsed();
+        if (!ok) {
+            stop();
+            break;
+        }
+        lastStats.bytes += buffer.size;
+        if (output) {
+            processed.push(index);
+        } else {
+            freeBuffers.push(index);
+        }
+
+        if (progressCallback && timer.nsecsElapsed() >= nextReportNs) {
+            progressCallback(snapshot());
+            nextReportNs = timer.nsecsElapsed() + qint64(progressIntervalMs) * 1000000;
+        }
+    }
+    processed.close();
+    reader.wait();
+    if (output) {
+        writer.wait();
+    }
+
+    snapshot();
+    // Запрос отмены снимается здесь: прерывает только этот запуск, а не следующий
+    lastCancelled = cancelled.exchange(false) && failed.load();
+    if (failed.load() && lastError.isEmpty()) {
+        if (lastCancelled) {
+            lastError = "Cancelled";
+        } else if (!readError.isEmpty()) {
+            lastError = readError;
+        } else if (!writeError.isEmpty()) {
+            lastError = writeError;
+        } else {
+            lastError = "Processing failed";
+        }
+    }
+    if (progressCallback) {
+        progressCallback(lastStats);
+    }
+    return !failed.load() && lastStats.bytes == length;
+}
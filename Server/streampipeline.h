@@ -0,0 +1,161 @@
+/**
+ * @file streampipeline.h
+ * @brief Конвейер чтение → обработка → запись с ограниченной памятью
+ * @date 2024
+ *
+ * @details
+ * Поток чтения заполняет буферы фиксированного размера, вызывающий
+ * поток обрабатывает их, поток записи пишет результат. Буферы ходят
+ * по кругу через три очереди (свободные → прочитанные → обработанные →
+ * свободные) на QMutex и QWaitCondition, поэтому память ограничена
+ * bufferCount × bufferSize байт при любом размере файла. Уже при двух
+ * буферах чтение следующего фрагмента идёт одновременно с обработкой
+ * текущего (двойная буферизация); больше буферов сглаживают
+ * неравномерную скорость диска.
+ *
+ * Для каждой стадии измеряется время работы (без ожидания очередей),
+ * так что по StreamPipelineStats видно, какая стадия ограничивает
+ * скорость. Обработчик прогресса вызывается из вызывающего потока;
+ * cancel() можно вызвать из любого потока.
+ *
+ * @example
+ * @code
+ * StreamPipeline pipeline(1 << 20, 4);
+ * pipeline.run(in, 0, in.size(), &out, 0, [](char* data, qint64 size, qint64 offset) {
+ *     // обработка фрагмента [offset, offset + size)
+ *     return true;
+ * });
+ * @endcode
+ *
+ * @see wavembed.h
+ */
+
+#ifndef STREAMPIPELINE_H
+#define STREAMPIPELINE_H
+
+#include <QString>
+#include <atomic>
+#include <functional>
+
+class QIODevice;
+
+/// Размер буфера по умолчанию, байт
+const qint64 PIPELINE_BUFFER_SIZE = 1 << 20;
+
+/// Число буферов по умолчанию
+const int PIPELINE_BUFFER_COUNT = 4;
+
+/**
+ * @brief Состояние и скорость стадий конвейера
+ */
+struct StreamPipelineStats {
+    qint64 bytes = 0;           ///< Обработано байт
+    qint64 total = 0;           ///< Всего байт
+    qint64 elapsedNs = 0;       ///< Прошло времени, нс
+    qint64 readNs = 0;          ///< Время чтения, нс
+    qint64 processNs = 0;       ///< Время обработки, нс
+    qint64 writeNs = 0;         ///< Время записи, нс
+    qint64 memory = 0;          ///< Память под буферы, байт
+
+    /// Доля выполненной работы (0–1)
+    double fraction() const { return total > 0 ? double(bytes) / total : 1.0; }
+
+    /// Общая скорость, МБ/с
+    double megabytesPerSecond() const { return rate(elapsedNs); }
+
+    /// Скорость чтения без учёта ожидания, МБ/с
+    double readMegabytesPerSecond() const { return rate(readNs); }
+
+    /// Скорость обработки без учёта ожидания, МБ/с
+    double processMegabytesPerSecond() const { return rate(processNs); }
+
+    /// Скорость записи без учёта ожидания, МБ/с (0, если записи не было)
+    double writeMegabytesPerSecond() const { return rate(writeNs); }
+
+private:
+    double rate(qint64 ns) const { return ns > 0 ? bytes * 1e3 / ns : 0.0; }
+};
+
+/**
+ * @brief Конвейер потоковой обработки файла
+ */
+class StreamPipeline {
+public:
+    /**
+     * @brief Обработчик фрагмента
+     * @details Получает буфер, его размер и смещение от начала диапазона;
+     * false останавливает конвейер с ошибкой (текст — setError()).
+     */
+    typedef std::function<bool(char* data, qint64 size, qint64 offset)> Processor;
+
+    /**
+     * @brief Конструктор
+     * @param bufferSize Размер буфера, байт
+     * @param bufferCount Число буферов (не меньше 2)
+     */
+    explicit StreamPipeline(qint64 bufferSize = PIPELINE_BUFFER_SIZE, int bufferCount = PIPELINE_BUFFER_COUNT);
+
+    /// Задаёт размер (1 байт – 1 ГБ) и число (не меньше 2) буферов
+    void setBuffers(qint64 bufferSize, int bufferCount);
+
+    /// Размер буфера, байт
+    qint64 bufferSize() const { return size; }
+
+    /// Число буферов
+    int bufferCount() const { return count; }
+
+    /**
+     * @brief Задаёт обработчик прогресса
+     * @param callback Функция, получающая текущее состояние
+     * @param intervalMs Минимальный интервал между вызовами, мс
+     *
+     * @note Обработчик вызывается из потока, выполняющего run().
+     */
+    void setProgressCallback(std::function<void(const StreamPipelineStats&)> callback, int intervalMs = 1000);
+
+    /**
+     * @brief Прерывает текущий запуск (можно вызывать из другого потока)
+     *
+     * @details Запрос, сделанный до run(), не теряется: ближайший запуск
+     * сразу завершается с ошибкой "Cancelled". Запуск снимает запрос при
+     * завершении, поэтому на следующие запуски он не переходит.
+     */
+    void cancel() { cancelled.store(true); }
+
+    /// Был ли прерван последний запуск
+    bool isCancelled() const { return lastCancelled; }
+
+    /**
+     * @brief Читает диапазон, обрабатывает его фрагментами и пишет результат
+     * @param input Источник, открытый на чтение
+     * @param inputOffset Начало диапазона в источнике
+     * @param length Длина диапазона, байт
+     * @param output Приёмник, открытый на запись (nullptr — без записи); не должен совпадать с input
+     * @param outputOffset Позиция записи в приёмнике
+     * @param process Обработчик фрагментов; вызывается по порядку в вызывающем потоке
+     * @return true если диапазон обработан полностью
+     */
+    bool run(QIODevice& input, qint64 inputOffset, qint64 length, QIODevice* output, qint64 outputOffset,
+             const Processor& process);
+
+    /// Задаёт текст ошибки (для обработчика фрагментов)
+    void setError(const QString& error) { lastError = error; }
+
+    /// Описание ошибки последнего запуска (пустое при успехе)
+    QString errorString() const { return lastError; }
+
+    /// Итоговая статистика последнего запуска
+    StreamPipelineStats stats() const { return lastStats; }
+
+private:
+    qint64 size;
+    int count;
+    std::function<void(const StreamPipelineStats&)> progressCallback;
+    int progressIntervalMs = 1000;
+    std::atomic<bool> cancelled;   // запрос отмены, снимается запуском
+    bool lastCancelled = false;     // последний запуск прерван
+    QString lastError;
+    StreamPipelineStats lastStats;
+};
+
+#endif // STREAMPIPELINE_H
@@ -10,66 +10,385 @@
  */
 
 #include "vigenere.h"
-#include <QDebug>
+#include "cipherkernel.h"
+#include <QVector>
+#include <cstring>
 
-QString encryptVigenere(const QString& text, const QString& key)
+namespace {
+
+// Байтов в одном регистре AVX2
+const int BYTE_SIMD_WIDTH = 32;
+
+// Размеры алфавитов
+const int LATIN_LETTERS = 26;
+const int CYRILLIC_LETTERS = 33;
+
+// Кириллица занимает U+0400..U+045F
+const ushort CYRILLIC_FIRST = 0x400;
+const int CYRILLIC_RANGE = 0x60;
+
+// Код символа, не являющегося буквой алфавита; иначе номер буквы и флаг строчной
+const quint8 NOT_LETTER = 0xFF;
+const quint8 LOWER_FLAG = 0x40;
+const quint8 INDEX_MASK = 0x3F;
+
+/**
+ * Таблицы алфавита: класс символа по смещению от начала диапазона,
+ * буквы по номеру и таблица Виженера.
+ */
+struct AlphabetTables {
+    int size = 0;
+    QVector<quint8> classes;
+    QVector<ushort> upper;
+    QVector<ushort> lower;
+    QVector<quint8> tabula;
+
+    AlphabetTables(int range, const QVector<ushort>& upperLetters, ushort first)
+        : size(upperLetters.size()), classes(range, NOT_LETTER), upper(upperLetters), lower(size), tabula(size * size)
+    {
+        for (int i = 0; i < size; ++i) {
+            lower[i] = QChar(upper[i]).toLower().unicode();
+            classes[upper[i] - first] = quint8(i);
+            classes[lower[i] - first] = quint8(i) | LOWER_FLAG;
+        }
+        for (int shift = 0; shift < size; ++shift) {
+            for (int letter = 0; letter < size; ++letter) {
+                tabula[shift * size + letter] = quint8((letter + shift) % size);
+            }
+        }
+    }
+};
+
+const AlphabetTables& latinTables()
+{
+    static const AlphabetTables tables = [] {
+        QVector<ushort> letters;
+        for (ushort c = 'A'; c <= 'Z'; ++c) {
+            letters.append(c);
+        }
+        return AlphabetTables(0x80, letters, 0);
+    }();
+    return tables;
+}
+
+const AlphabetTables& cyrillicTables()
+{
+    static const AlphabetTables tables = [] {
+        // А..Е, Ё, Ж..Я
+        QVector<ushort> letters;
+        for (ushort c = 0x410; c <= 0x415; ++c) {
+            letters.append(c);
+        }
+        letters.append(0x401);
+        for (ushort c = 0x416; c <= 0x42F; ++c) {
+            letters.append(c);
+        }
+        return AlphabetTables(CYRILLIC_RANGE, letters, CYRILLIC_FIRST);
+    }();
+    return tables;
+}
+
+/**
+ * Кириллица VigenereKey для CipherKernel: буквы не идут подряд (Ё),
+ * поэтому номер и символ берутся из таблиц; base — признак строчной.
+ */
+struct CyrillicAlphabet {
+    static const int SIZE = CYRILLIC_LETTERS;
+
+    static int letter(uint c, uint& base)
+    {
+        const uint offset = c - CYRILLIC_FIRST;
+        if (offset >= uint(CYRILLIC_RANGE)) {
+            return -1;
+        }
+        const quint8 cls = cyrillicTables().classes[int(offset)];
+        if (cls == NOT_LETTER) {
+            return -1;
+        }
+        base = cls & LOWER_FLAG;
+        return cls & INDEX_MASK;
+    }
+
+    static uint symbol(int index, uint base)
+    {
+        const AlphabetTables& tables = cyrillicTables();
+        return base ? tables.lower[index] : tables.upper[index];
+    }
+};
+
+/**
+ * Прежние правила encryptVigenere(), когда ключ не из латинских букв
+ * или в блоке есть символы вне ASCII: любая буква Unicode сдвигается от
+ * 'A'/'a' по модулю 26, сдвиг — код буквы ключа минус 'A'. Номер буквы
+ * неотрицателен: все буквы ниже 'a' — это 'A'..'Z'.
+ */
+struct UnicodeLetters {
+    static const int SIZE = LATIN_LETTERS;
+
+    static int letter(uint c, uint& base)
+    {
+        const QChar ch = QChar(ushort(c));
+        if (!ch.isLetter()) {
+            return -1;
+        }
+        base = ch.isUpper() ? 'A' : 'a';
+        return int(c - base);
+    }
+
+    static uint symbol(int index, uint base) { return base + uint(index); }
+};
+
+/// Сдвиг (p + k) % size без приведения k к алфавиту
+struct ModuloShift {
+    static int apply(int letter, int shift, int size) { return (letter + shift) % size; }
+};
+
+/**
+ * Сдвиги ключа для encryptVigenere()/decryptVigenere(). Для
+ * расшифрования хранится 26 - s: (c - s + 26) % 26 == (c + (26 - s)) % 26,
+ * поэтому оба направления сводятся к сложению.
+ */
+struct KeySchedule {
+    QVector<int> shifts;  ///< Сдвиг каждой позиции ключа
+    QByteArray window;    ///< Сдвиги, повторённые на length + KEY_WINDOW_PADDING позиций; пусто, если ключ не из латинских букв
+};
+
+KeySchedule compilePositionalKey(const QString& key, bool decrypt)
 {
-    QString result;
-    int keyLength = key.length();
-    
-    // Шифруем каждый символ текста
-    for (int i = 0; i < text.length(); ++i) {
-        // Получаем текущий символ текста и ключа
-        QChar textChar = text[i];
-        QChar keyChar = key[i % keyLength];
-        
-        // Проверяем, является ли символ буквой
-        if (textChar.isLetter()) {
-            // Определяем базовый код для текущего регистра
-            int base = textChar.isUpper() ? 'A' : 'a';
-            
-            // Вычисляем сдвиг для текущего символа ключа
-            int shift = keyChar.toUpper().unicode() - 'A';
-            
-            // Применяем шифр Виженера
-            int encrypted = ((textChar.unicode() - base + shift) % 26) + base;
-            result.append(QChar(encrypted));
-        } else {
-            // Оставляем небуквенные символы без изменений
-            result.append(textChar);
+    KeySchedule schedule;
+    const int length = key.length();
+    schedule.shifts.resize(length);
+
+    bool latin = true;
+    for (int i = 0; i < length; ++i) {
+        const int shift = key[i].toUpper().unicode() - 'A';
+        latin = latin && shift >= 0 && shift < LATIN_LETTERS;
+        schedule.shifts[i] = decrypt ? LATIN_LETTERS - shift : shift;
+    }
+
+    if (latin && length > 0) {
+        // Окно сдвигов от любой позиции ключа читается одной загрузкой
+        schedule.window.resize(length + KEY_WINDOW_PADDING);
+        for (int i = 0; i < schedule.window.size(); ++i) {
+            schedule.window[i] = char(schedule.shifts[i % length]);
         }
     }
-    
+    return schedule;
+}
+
+// Ключ сдвигается только на буквах (VigenereKey) или по позиции (encryptVigenere())
+typedef CipherKernel<AddShift, PeriodicKey> VigenereKernel;
+typedef CipherKernel<AddShift, PeriodicKey, KeyAdvance::ByPosition> PositionalVigenereKernel;
+
+// Кириллица VigenereKey; только скалярный путь
+typedef CipherKernel<AddShift, PeriodicKey, KeyAdvance::ByLetter, CyrillicAlphabet> CyrillicVigenereKernel;
+
+// Скалярный путь encryptVigenere() по прежним правилам
+typedef CipherKernel<ModuloShift, PeriodicKey, KeyAdvance::ByPosition, UnicodeLetters> UnicodePositionalKernel;
+
+// Скалярный путь encryptVigenere() для символов [begin, end); phase — позиция в ключе
+void transformPositional(const ushort* in, ushort* out, int begin, int end, const KeySchedule& key, int& phase)
+{
+    UnicodePositionalKernel::scalar(in, out, begin, end, key.shifts.constData(), key.shifts.size(), phase);
+}
+
+// Буква ASCII: 'A'..'Z' или 'a'..'z'
+inline bool isLatinLetter(uchar c)
+{
+    return uchar((c | 0x20) - 'a') < LATIN_LETTERS;
+}
+
+#if HAVE_X86_SIMD
+
+TARGET_AVX2 qint64 countLatinLettersAvx2(const uchar* data, qint64 size, qint64& done)
+{
+    qint64 count = 0;
+    qint64 i = 0;
+    for (; i + BYTE_SIMD_WIDTH <= size; i += BYTE_SIMD_WIDTH) {
+        __m256i base;
+        const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        count += __builtin_popcount(quint32(_mm256_movemask_epi8(LatinAlphabet::letters8(c, base))));
+    }
+    done = i;
+    return count;
+}
+
+#endif // HAVE_X86_SIMD
+
+QString transformByPosition(const QString& text, const QString& key, bool decrypt)
+{
+    if (key.isEmpty()) {
+        return text;
+    }
+
+    const KeySchedule schedule = compilePositionalKey(key, decrypt);
+    QString result(text.size(), Qt::Uninitialized);
+    const ushort* in = text.utf16();
+    ushort* out = reinterpret_cast<ushort*>(result.data());
+    const int count = text.size();
+
+    int phase = 0;
+    int done = 0;
+#if HAVE_X86_SIMD
+    if (!schedule.window.isEmpty() && useAvx2()) {
+        const quint8* window = reinterpret_cast<const quint8*>(schedule.window.constData());
+        done = PositionalVigenereKernel::avx2(in, out, count, window, schedule.shifts.size(), phase,
+                                              [&](int begin, int end) {
+            transformPositional(in, out, begin, end, schedule, phase);
+        });
+    }
+#endif
+    transformPositional(in, out, done, count, schedule, phase);
     return result;
 }
 
-QString decryptVigenere(const QString& text, const QString& key)
+} // namespace
+
+VigenereKey::VigenereKey(const QString& key)
 {
-    QString result;
-    int keyLength = key.length();
-
-    // Расшифровываем каждый символ текста
-    for (int i = 0; i < text.length(); ++i) {
-        // Получаем текущий символ текста и ключа
-        QChar textChar = text[i];
-        QChar keyChar = key[i % keyLength];
-        
-        // Проверяем, является ли символ буквой
-        if (textChar.isLetter()) {
-            // Определяем базовый код для текущего регистра
-            int base = textChar.isUpper() ? 'A' : 'a';
-            
-            // Вычисляем сдвиг для текущего символа ключа
-            int shift = keyChar.toUpper().unicode() - 'A';
-
-            // Применяем обратный шифр Виженера
-            int decrypted = ((textChar.unicode() - base - shift + 26) % 26) + base;
-            result.append(QChar(decrypted));
-        } else {
-            // Оставляем небуквенные символы без изменений
-            result.append(textChar);
+    const AlphabetTables& latin = latinTables();
+    const AlphabetTables& cyrillic = cyrillicTables();
+
+    QVector<int> shifts;
+    for (QChar c : key) {
+        const ushort u = c.unicode();
+        if (u < 0x80 && latin.classes[u] != NOT_LETTER) {
+            shifts.append(latin.classes[u] & INDEX_MASK);
+        } else if (ushort(u - CYRILLIC_FIRST) < CYRILLIC_RANGE && cyrillic.classes[u - CYRILLIC_FIRST] != NOT_LETTER) {
+            shifts.append(cyrillic.classes[u - CYRILLIC_FIRST] & INDEX_MASK);
         }
     }
 
+    keyLength = shifts.size();
+    if (keyLength == 0) {
+        return;
+    }
+    encryption.latin.resize(keyLength + KEY_WINDOW_PADDING);
+    decryption.latin.resize(keyLength + KEY_WINDOW_PADDING);
+    for (int i = 0; i < keyLength + KEY_WINDOW_PADDING; ++i) {
+        const int shift = shifts[i % keyLength] % LATIN_LETTERS;
+        encryption.latin[i] = char(shift);
+        decryption.latin[i] = char((LATIN_LETTERS - shift) % LATIN_LETTERS);
+    }
+    encryption.cyrillic.resize(keyLength);
+    decryption.cyrillic.resize(keyLength);
+    for (int i = 0; i < keyLength; ++i) {
+        const int shift = shifts[i] % CYRILLIC_LETTERS;
+        encryption.cyrillic[i] = char(shift);
+        decryption.cyrillic[i] = char((CYRILLIC_LETTERS - shift) % CYRILLIC_LETTERS);
+    }
+}
+
+QString VigenereKey::encrypt(const QString& text) const
+{
+    return transform(text, encryption);
+}
+
+QString VigenereKey::decrypt(const QString& text) const
+{
+    return transform(text, decryption);
+}
+
+int VigenereKey::alphabetSize(VigenereAlphabet alphabet)
+{
+    return alphabet == VigenereAlphabet::Latin ? LATIN_LETTERS : CYRILLIC_LETTERS;
+}
+
+const quint8* VigenereKey::tabulaRecta(VigenereAlphabet alphabet)
+{
+    return alphabet == VigenereAlphabet::Latin ? latinTables().tabula.constData()
+                                               : cyrillicTables().tabula.constData();
+}
+
+QString VigenereKey::transform(const QString& text, const Schedule& schedule) const
+{
+    if (keyLength == 0) {
+        return text;
+    }
+
+    const quint8* latinShifts = reinterpret_cast<const quint8*>(schedule.latin.constData());
+    const quint8* cyrillicShifts = reinterpret_cast<const quint8*>(schedule.cyrillic.constData());
+
+    QString result(text.size(), Qt::Uninitialized);
+    const ushort* in = text.utf16();
+    ushort* out = reinterpret_cast<ushort*>(result.data());
+    const int count = text.size();
+    int phase = 0;
+
+    // Латиница и кириллица с общей фазой; ключ сдвигается только на буквах
+    auto scalar = [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            out[i] = ushort(in[i] < 0x80 ? VigenereKernel::character(in[i], latinShifts, keyLength, phase)
+                                         : CyrillicVigenereKernel::character(in[i], cyrillicShifts, keyLength, phase));
+        }
+    };
+
+    int done = 0;
+#if HAVE_X86_SIMD
+    if (useAvx2()) {
+        done = VigenereKernel::avx2(in, out, count, latinShifts, keyLength, phase, scalar);
+    }
+#endif
+    scalar(done, count);
     return result;
 }
+
+int VigenereKey::transformBytes(const char* in, char* out, qint64 size, int phase, bool decrypt) const
+{
+    const uchar* src = reinterpret_cast<const uchar*>(in);
+    uchar* dst = reinterpret_cast<uchar*>(out);
+    if (keyLength == 0) {
+        if (dst != src) {
+            std::memmove(dst, src, size_t(size));
+        }
+        return phase;
+    }
+
+    const quint8* shifts = reinterpret_cast<const quint8*>((decrypt ? decryption : encryption).latin.constData());
+    return VigenereKernel::runBytes(src, dst, size, shifts, keyLength, phase % keyLength);
+}
+
+const VigenereKey& Vigenere::compiled(const QString& key)
+{
+    if (key != lastKey) {
+        lastCompiled = VigenereKey(key);
+        lastKey = key;
+    }
+    return lastCompiled;
+}
+
+QString Vigenere::encrypt(const QString& text, const QString& key)
+{
+    return compiled(key).encrypt(text);
+}
+
+QString Vigenere::decrypt(const QString& text, const QString& key)
+{
+    return compiled(key).decrypt(text);
+}
+
+QString encryptVigenere(const QString& text, const QString& key)
+{
+    return transformByPosition(text, key, false);
+}
+
+QString decryptVigenere(const QString& text, const QString& key)
+{
+    return transformByPosition(text, key, true);
+}
+
+qint64 countLatinLetters(const char* data, qint64 size)
+{
+    const uchar* bytes = reinterpret_cast<const uchar*>(data);
+    qint64 count = 0;
+    qint64 done = 0;
+#if HAVE_X86_SIMD
+    if (useAvx2()) {
+        count = countLatinLettersAvx2(bytes, size, done);
+    }
+#endif
+    for (qint64 i = done; i < size; ++i) {
+        count += isLatinLetter(bytes[i]) ? 1 : 0;
+    }
+    return count;
+}
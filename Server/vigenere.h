@@ -8,15 +8,139 @@
  * Реализует функции для шифрования и дешифрования текста
  * с использованием шифра Виженера.
  * Используется в задаче 4 для криптографических операций.
+ *
+ * Текст из латинских букв ASCII обрабатывается векторным ядром AVX2
+ * по 16 кодовых единиц UTF-16 за шаг: буквы выделяются масками
+ * сравнения, сдвиги берутся из заранее развёрнутого ключа, а остаток
+ * по модулю 26 получается сравнением и вычитанием. Блоки с символами
+ * вне ASCII обрабатываются скалярно с тем же результатом.
+ *
+ * VigenereKey компилирует ключ один раз: сдвиги для латиницы и
+ * кириллицы хранятся массивами. Таблица Виженера (tabula recta)
+ * доступна через tabulaRecta().
+ *
+ * Скалярные и векторные пути — экземпляры общего ядра шифров сдвига
+ * CipherKernel (cipherkernel.h) с политиками латиницы, кириллицы и
+ * прежних правил encryptVigenere() для ключей вне латиницы; Бофор,
+ * Гронсфельд и автоключ собраны из того же ядра в classicalciphers.h.
  */
 
 #ifndef VIGENERE_H
 #define VIGENERE_H
 
+#include <QByteArray>
 #include <QString>
 
+/**
+ * @brief Алфавит шифра Виженера
+ */
+enum class VigenereAlphabet {
+    Latin,    ///< A–Z, 26 букв
+    Cyrillic  ///< А–Я с Ё после Е, 33 буквы
+};
+
+/**
+ * @brief Ключ шифра Виженера, скомпилированный для многократного использования
+ *
+ * @details
+ * Каждая буква ключа (латинская или кириллическая, регистр не важен)
+ * превращается в сдвиг — номер в своём алфавите; прочие символы ключа
+ * пропускаются. Для букв текста сдвиг берётся по модулю размера их
+ * алфавита. Ключ сдвигается только на буквах текста, символы вне
+ * обоих алфавитов копируются без изменений.
+ *
+ * Объект неизменяем после создания, поэтому один ключ можно
+ * использовать из нескольких потоков.
+ *
+ * @example
+ * @code
+ * VigenereKey key("KEY");
+ * QString encrypted = key.encrypt("HELLO");  // "RIJVS"
+ * QString decrypted = key.decrypt(encrypted); // "HELLO"
+ * @endcode
+ */
+class VigenereKey {
+public:
+    /// Пустой ключ: текст не меняется
+    VigenereKey() = default;
+
+    /**
+     * @brief Компилирует ключ
+     * @param key Ключ шифрования
+     */
+    explicit VigenereKey(const QString& key);
+
+    /// Есть ли в ключе хотя бы одна буква
+    bool isValid() const { return keyLength > 0; }
+
+    /// Число букв ключа
+    int length() const { return keyLength; }
+
+    /**
+     * @brief Шифрует текст
+     * @param text Исходный текст
+     * @return Зашифрованный текст
+     */
+    QString encrypt(const QString& text) const;
+
+    /**
+     * @brief Дешифрует текст
+     * @param text Зашифрованный текст
+     * @return Расшифрованный текст
+     */
+    QString decrypt(const QString& text) const;
+
+    /**
+     * @brief Шифрует или дешифрует латинские буквы в байтовом буфере
+     * @param in Входные байты (ASCII или UTF-8)
+     * @param out Выходной буфер того же размера; может совпадать с in
+     * @param size Размер в байтах
+     * @param phase Позиция в ключе перед первым байтом
+     * @param decrypt true для расшифрования
+     * @return Позиция в ключе после последнего байта
+     *
+     * @details
+     * Меняются только байты A–Z и a–z; остальные, включая многобайтовые
+     * последовательности UTF-8, копируются и не сдвигают ключ. С AVX2
+     * обрабатывается 32 байта за шаг. Используется потоковым режимом
+     * (vigenerestream.h).
+     */
+    int transformBytes(const char* in, char* out, qint64 size, int phase, bool decrypt) const;
+
+    /// Число букв алфавита
+    static int alphabetSize(VigenereAlphabet alphabet);
+
+    /**
+     * @brief Таблица Виженера алфавита
+     * @param alphabet Алфавит
+     * @return Таблица size×size построчно: элемент [shift·size + letter] —
+     *         номер буквы letter, сдвинутой на shift
+     */
+    static const quint8* tabulaRecta(VigenereAlphabet alphabet);
+
+private:
+    /// Сдвиги ключа для одного направления
+    struct Schedule {
+        QByteArray latin;     ///< По модулю 26, повторены на length + 32 позиции для векторных ядер
+        QByteArray cyrillic;  ///< По модулю 33
+    };
+
+    QString transform(const QString& text, const Schedule& schedule) const;
+
+    Schedule encryption;
+    Schedule decryption;
+    int keyLength = 0;
+};
+
 /**
  * @brief Класс для работы с шифром Виженера
+ *
+ * @details
+ * В отличие от encryptVigenere() ключ сдвигается только на буквах
+ * текста: пробелы и знаки препинания не расходуют символы ключа.
+ * Шифрует латиницу и кириллицу (см. VigenereKey); последний
+ * использованный ключ хранится скомпилированным. Пустой ключ
+ * возвращает текст без изменений.
  */
 class Vigenere {
 public:
@@ -26,31 +150,7 @@ public:
      * @param key Ключ шифрования
      * @return Зашифрованный текст
      */
-    QString encrypt(const QString& text, const QString& key) {
-        QString result;
-        QString upperKey = key.toUpper();
-        int keyLength = upperKey.length();
-        int keyIndex = 0;
-
-        for (QChar c : text) {
-            if (c.isLetter()) {
-                bool isUpper = c.isUpper();
-                QChar base = isUpper ? 'A' : 'a';
-                QChar keyChar = upperKey[keyIndex % keyLength];
-                int shift = keyChar.toLatin1() - 'A';
-                
-                int charValue = c.toLatin1() - base.toLatin1();
-                charValue = (charValue + shift) % 26;
-                result.append(QChar(base.toLatin1() + charValue));
-                
-                keyIndex++;
-            } else {
-                result.append(c);
-            }
-        }
-        
-        return result;
-    }
+    QString encrypt(const QString& text, const QString& key);
 
     /**
      * @brief Дешифрует текст, зашифрованный шифром Виженера
@@ -58,33 +158,24 @@ public:
      * @param key Ключ шифрования
      * @return Расшифрованный текст
      */
-    QString decrypt(const QString& text, const QString& key) {
-        QString result;
-        QString upperKey = key.toUpper();
-        int keyLength = upperKey.length();
-        int keyIndex = 0;
-
-        for (QChar c : text) {
-            if (c.isLetter()) {
-                bool isUpper = c.isUpper();
-                QChar base = isUpper ? 'A' : 'a';
-                QChar keyChar = upperKey[keyIndex % keyLength];
-                int shift = keyChar.toLatin1() - 'A';
-                
-                int charValue = c.toLatin1() - base.toLatin1();
-                charValue = (charValue - shift + 26) % 26;
-                result.append(QChar(base.toLatin1() + charValue));
-                
-                keyIndex++;
-            } else {
-                result.append(c);
-            }
-        }
-        
-        return result;
-    }
+    QString decrypt(const QString& text, const QString& key);
+
+private:
+    /// Ключ, скомпилированный при последнем вызове
+    const VigenereKey& compiled(const QString& key);
+
+    QString lastKey;
+    VigenereKey lastCompiled;
 };
 
+/**
+ * @brief Считает латинские буквы A–Z и a–z в байтовом буфере
+ * @param data Байты (ASCII или UTF-8)
+ * @param size Размер в байтах
+ * @return Число букв
+ */
+qint64 countLatinLetters(const char* data, qint64 size);
+
 /**
  * @brief Шифрует текст с использованием шифра Виженера
  * @param text Исходный текст для шифрования
@@ -104,7 +195,7 @@ public:
  * 
  * @note
  * Ключ должен содержать только буквы. Регистр букв в ключе
- * не имеет значения.
+ * не имеет значения. Пустой ключ возвращает текст без изменений.
  */
 QString encryptVigenere(const QString& text, const QString& key);
 
@@ -0,0 +1,319 @@
+/**
+ * @file vigenereanalysis.cpp
+ * @brief Реализация криптоанализа шифра Виженера
+ * @date 2024
+ */
+
+#include "vigenereanalysis.h"
+#include "cpufeatures.h"
+#include "parallel.h"
+#include <QElapsedTimer>
+#include <algorithm>
+
+namespace {
+
+const int LETTERS = 26;
+
+// Индекс совпадений английского текста и равномерно случайных букв
+const double ENGLISH_IOC = 0.0667;
+const double RANDOM_IOC = 1.0 / LETTERS;
+
+// Вклад метода Касиски в итоговую оценку длины
+const double KASISKI_WEIGHT = 0.3;
+
+// Делитель лучшей длины выбирается, если его индекс совпадений не ниже этой доли
+const double DIVISOR_IOC_RATIO = 0.95;
+
+// Повторяющиеся n-граммы для метода Касиски
+const int KASISKI_GRAM = 3;
+
+// Частоты букв английского языка, A..Z
+const double ENGLISH_FREQUENCIES[LETTERS] = {
+    0.08167, 0.01492, 0.02782, 0.04253, 0.12702, 0.02228, 0.02015, 0.06094, 0.06966,
+    0.00153, 0.00772, 0.04025, 0.02406, 0.06749, 0.07507, 0.01929, 0.00095, 0.05987,
+    0.06327, 0.09056, 0.02758, 0.00978, 0.02360, 0.00150, 0.01974, 0.00074
+};
+
+// Буквы текста строчными ASCII без прочих символов
+template <typename Char>
+QByteArray extractLetters(const Char* text, qint64 size)
+{
+    QByteArray letters(int(size), Qt::Uninitialized);
+    char* out = letters.data();
+    int count = 0;
+    for (qint64 i = 0; i < size; ++i) {
+        const unsigned c = unsigned(text[i]) | 0x20;
+        if (c - 'a' < unsigned(LETTERS)) {
+            out[count++] = char(c);
+        }
+    }
+    letters.resize(count);
+    return letters;
+}
+
+// Число позиций i, где триграмма с i повторяется с позиции i + distance
+qint64 trigramRepeatsScalar(const uchar* a, qint64 begin, qint64 limit, int distance)
+{
+    qint64 repeats = 0;
+    for (qint64 i = begin; i < limit; ++i) {
+        repeats += (a[i] == a[i + distance] && a[i + 1] == a[i + distance + 1]
+                    && a[i + 2] == a[i + distance + 2]) ? 1 : 0;
+    }
+    return repeats;
+}
+
+#if HAVE_X86_SIMD
+
+TARGET_AVX2 qint64 trigramRepeatsAvx2(const uchar* a, qint64 limit, int distance, qint64& done)
+{
+    qint64 repeats = 0;
+    qint64 i = 0;
+    for (; i + 32 <= limit; i += 32) {
+        __m256i equal = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+                                          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + distance)));
+        for (int k = 1; k < KASISKI_GRAM; ++k) {
+            equal = _mm256_and_si256(equal, _mm256_cmpeq_epi8(
+                        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + k)),
+                        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + k + distance))));
+        }
+        repeats += __builtin_popcount(quint32(_mm256_movemask_epi8(equal)));
+    }
+    done = i;
+    return repeats;
+}
+
+TARGET_AVX2 qint64 latinHistogramAvx2(const uchar* data, qint64 size, quint64* counts)
+{
+    const __m256i fold = _mm256_set1_epi8(0x20);
+    const __m256i firstLetter = _mm256_set1_epi8('a');
+    const __m256i zero = _mm256_setzero_si256();
+
+    qint64 i = 0;
+    while (i + 32 <= size) {
+        // Байтовые счётчики переполнятся после 255 шагов
+        const qint64 blockEnd = qMin(size, i + 255 * 32);
+        __m256i acc[LETTERS];
+        for (int k = 0; k < LETTERS; ++k) {
+            acc[k] = zero;
+        }
+        for (; i + 32 <= blockEnd; i += 32) {
+            const __m256i c = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            const __m256i index = _mm256_sub_epi8(_mm256_or_si256(c, fold), firstLetter);
+            for (int k = 0; k < LETTERS; ++k) {
+                acc[k] = _mm256_sub_epi8(acc[k], _mm256_cmpeq_epi8(index, _mm256_set1_epi8(char(k))));
+            }
+        }
+        for (int k = 0; k < LETTERS; ++k) {
+            const __m256i sums = _mm256_sad_epu8(acc[k], zero);
+            counts[k] += quint64(_mm256_extract_epi64(sums, 0)) + quint64(_mm256_extract_epi64(sums, 1))
+                       + quint64(_mm256_extract_epi64(sums, 2)) + quint64(_mm256_extract_epi64(sums, 3));
+        }
+    }
+    return i;
+}
+
+#endif // HAVE_X86_SIMD
+
+qint64 trigramRepeats(const QByteArray& letters, int distance)
+{
+    const uchar* a = reinterpret_cast<const uchar*>(letters.constData());
+    const qint64 limit = qint64(letters.size()) - distance - (KASISKI_GRAM - 1);
+    if (limit <= 0) {
+        return 0;
+    }
+    qint64 done = 0;
+    qint64 repeats = 0;
+#if HAVE_X86_SIMD
+    if (useAvx2()) {
+        repeats = trigramRepeatsAvx2(a, limit, distance, done);
+    }
+#endif
+    return repeats + trigramRepeatsScalar(a, done, limit, distance);
+}
+
+// Средний индекс совпадений столбцов при длине ключа length
+double columnIndexOfCoincidence(const QByteArray& letters, int length)
+{
+    QVector<quint32> histograms(length * LETTERS, 0);
+    quint32* h = histograms.data();
+    int column = 0;
+    for (char c : letters) {
+        ++h[column * LETTERS + (c - 'a')];
+        column = column + 1 == length ? 0 : column + 1;
+    }
+
+    double sum = 0.0;
+    int columns = 0;
+    for (int c = 0; c < length; ++c) {
+        double pairs = 0.0;
+        double total = 0.0;
+        for (int k = 0; k < LETTERS; ++k) {
+            const double n = h[c * LETTERS + k];
+            pairs += n * (n - 1);
+            total += n;
+        }
+        if (total > 1) {
+            sum += pairs / (total * (total - 1));
+            ++columns;
+        }
+    }
+    return columns > 0 ? sum / columns : 0.0;
+}
+
+// Сдвиг столбца с минимальным хи-квадрат относительно английских частот
+int bestShift(const quint64* counts, double& chiSquared)
+{
+    quint64 total = 0;
+    for (int k = 0; k < LETTERS; ++k) {
+        total += counts[k];
+    }
+
+    int best = 0;
+    chiSquared = 0.0;
+    for (int shift = 0; shift < LETTERS; ++shift) {
+        double chi = 0.0;
+        for (int k = 0; k < LETTERS; ++k) {
+            const double expected = total * ENGLISH_FREQUENCIES[k];
+            const double difference = double(counts[(k + shift) % LETTERS]) - expected;
+            chi += difference * difference / expected;
+        }
+        if (shift == 0 || chi < chiSquared) {
+            chiSquared = chi;
+            best = shift;
+        }
+    }
+    return best;
+}
+
+VigenereAnalysis analyzeLetters(const QByteArray& letters, const VigenereAnalysisOptions& options, QElapsedTimer& timer)
+{
+    VigenereAnalysis result;
+    result.letters = letters.size();
+    const int count = letters.size();
+    if (count == 0) {
+        result.elapsedNs = timer.nsecsElapsed();
+        return result;
+    }
+
+    // Длина оценивается по началу текста: статистики устойчивы уже
+    // на десятках тысяч букв; ключ затем восстанавливается по всему тексту
+    const QByteArray sample = options.sampleLetters > 0 && count > options.sampleLetters
+            ? QByteArray::fromRawData(letters.constData(), options.sampleLetters) : letters;
+    const int sampleCount = sample.size();
+
+    // Каждый столбец должен содержать хотя бы две буквы
+    const int maxLength = qMax(1, qMin(options.maxKeyLength, sampleCount / 2));
+
+    // Метод Касиски: повторы триграмм на всех расстояниях параллельно
+    const int maxDistance = qMax(1, qMin(options.kasiskiFactor * maxLength, sampleCount - KASISKI_GRAM));
+    QVector<qint64> repeats(maxDistance + 1, 0);
+    result.threads = parallelFor(maxDistance, [&](int i) {
+        repeats[i + 1] = trigramRepeats(sample, i + 1);
+    }, options.maxThreads);
+    double averageRepeats = 0.0;
+    for (int d = 1; d <= maxDistance; ++d) {
+        averageRepeats += repeats[d];
+    }
+    averageRepeats /= maxDistance;
+
+    // Индекс совпадений столбцов для всех длин параллельно
+    result.candidates.resize(maxLength);
+    const int threads = parallelFor(maxLength, [&](int i) {
+        const int length = i + 1;
+        VigenereLengthScore& candidate = result.candidates[i];
+        candidate.length = length;
+        candidate.indexOfCoincidence = columnIndexOfCoincidence(sample, length);
+
+        double multiples = 0.0;
+        int multipleCount = 0;
+        for (int d = length; d <= maxDistance; d += length) {
+            multiples += repeats[d];
+            ++multipleCount;
+        }
+        candidate.kasiski = multipleCount > 0 && averageRepeats > 0 ? multiples / multipleCount / averageRepeats : 0.0;
+
+        // Кратные истинной длины дают тот же индекс, но меньшую нормированную
+        // долю Касиски, поэтому итоговая оценка выбирает наименьшую из них
+        const double ioc = qMax(0.0, (candidate.indexOfCoincidence - RANDOM_IOC) / (ENGLISH_IOC - RANDOM_IOC));
+        const double kasiski = length > 1 ? qBound(0.0, (candidate.kasiski - 1.0) / (length - 1), 1.0) : 0.0;
+        candidate.score = (1.0 - KASISKI_WEIGHT) * ioc + KASISKI_WEIGHT * kasiski;
+    }, options.maxThreads);
+    result.threads = qMax(result.threads, threads);
+
+    std::stable_sort(result.candidates.begin(), result.candidates.end(),
+                     [](const VigenereLengthScore& a, const VigenereLengthScore& b) { return a.score > b.score; });
+
+    // Столбцы кратной длины тоже одноалфавитные. Если делитель лучшей
+    // длины даёт почти тот же индекс совпадений, ключ короче (в том числе
+    // длины 1, для которой метод Касиски ничего не говорит)
+    const VigenereLengthScore best = result.candidates.first();
+    for (int i = 1; i < result.candidates.size(); ++i) {
+        const VigenereLengthScore& candidate = result.candidates[i];
+        if (candidate.length < result.candidates.first().length && best.length % candidate.length == 0
+                && candidate.indexOfCoincidence >= DIVISOR_IOC_RATIO * best.indexOfCoincidence) {
+            std::rotate(result.candidates.begin(), result.candidates.begin() + i, result.candidates.begin() + i + 1);
+        }
+    }
+
+    // Хи-квадрат по каждому столбцу найденной длины
+    const int length = result.candidates.first().length;
+    QByteArray column;
+    column.reserve(count / length + 1);
+    for (int c = 0; c < length; ++c) {
+        column.resize(0);
+        for (int i = c; i < count; i += length) {
+            column.append(letters[i]);
+        }
+        quint64 counts[LETTERS] = {};
+        latinHistogram(column.constData(), column.size(), counts);
+        double chi = 0.0;
+        result.key.append(QChar('A' + bestShift(counts, chi)));
+        result.chiSquared += chi / length;
+    }
+
+    // На коротком тексте может победить кратная длина: ключ "AAAA"
+    // сокращается до "A", "KEYKEY" — до "KEY"
+    for (int period = 1; period < length; ++period) {
+        if (length % period == 0 && result.key.mid(period) == result.key.left(length - period)) {
+            result.key.truncate(period);
+            break;
+        }
+    }
+
+    result.elapsedNs = timer.nsecsElapsed();
+    return result;
+}
+
+} // namespace
+
+void latinHistogram(const char* data, qint64 size, quint64* counts)
+{
+    const uchar* bytes = reinterpret_cast<const uchar*>(data);
+    qint64 done = 0;
+#if HAVE_X86_SIMD
+    if (useAvx2()) {
+        done = latinHistogramAvx2(bytes, size, counts);
+    }
+#endif
+    for (qint64 i = done; i < size; ++i) {
+        const unsigned index = unsigned(bytes[i] | 0x20) - 'a';
+        if (index < unsigned(LETTERS)) {
+            ++counts[index];
+        }
+    }
+}
+
+VigenereAnalysis analyzeVigenere(const QString& ciphertext, const VigenereAnalysisOptions& options)
+{
+    QElapsedTimer timer;
+    timer.start();
+    return analyzeLetters(extractLetters(ciphertext.utf16(), ciphertext.size()), options, timer);
+}
+
+VigenereAnalysis analyzeVigenere(const QByteArray& ciphertext, const VigenereAnalysisOptions& options)
+{
+    QElapsedTimer timer;
+    timer.start();
+    return analyzeLetters(extractLetters(reinterpret_cast<const uchar*>(ciphertext.constData()), ciphertext.size()),
+                          options, timer);
+}
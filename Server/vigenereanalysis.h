@@ -0,0 +1,108 @@
+/**
+ * @file vigenereanalysis.h
+ * @brief Криптоанализ шифра Виженера: длина ключа и восстановление ключа
+ * @date 2024
+ *
+ * @details
+ * Восстанавливает латинский ключ по шифротексту без знания ключа —
+ * для упражнения «взломай шифр» и для проверки заданий задачи 4.
+ * Как и в VigenereKey, ключ считается сдвигающимся только на буквах,
+ * поэтому анализ ведётся по последовательности букв A–Z без учёта
+ * регистра.
+ *
+ * 1. Метод Касиски: для каждого расстояния d векторно считается, сколько
+ *    триграмм повторяется через d букв (три сравнения по 32 байта и
+ *    popcount маски). У истинной длины ключа L повторы на кратных L
+ *    расстояниях встречаются чаще среднего.
+ * 2. Индекс совпадений столбцов: текст делится на L столбцов, и для
+ *    каждого считается вероятность совпадения двух случайных букв.
+ *    У верной длины столбцы зашифрованы одним сдвигом, и индекс близок
+ *    к английскому (~0.066), иначе — к случайному (~0.038).
+ *    Кандидаты 1..maxKeyLength оцениваются параллельно.
+ *    Кратные истинной длины тоже дают одноалфавитные столбцы; из них
+ *    выбирается наименьшая.
+ * 3. Буква ключа для каждого столбца выбирается по минимуму хи-квадрат
+ *    между гистограммой столбца и частотами букв английского языка.
+ *
+ * Гистограммы считает векторное ядро latinHistogram().
+ *
+ * @example
+ * @code
+ * VigenereKey key("LEMON");
+ * VigenereAnalysis result = analyzeVigenere(key.encrypt(longEnglishText));
+ * // result.key == "LEMON"
+ * @endcode
+ *
+ * @see vigenere.h
+ */
+
+#ifndef VIGENEREANALYSIS_H
+#define VIGENEREANALYSIS_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Параметры анализа
+ */
+struct VigenereAnalysisOptions {
+    int maxKeyLength = 40;        ///< Наибольшая проверяемая длина ключа
+    int kasiskiFactor = 8;        ///< Повторы ищутся на расстояниях до kasiskiFactor·maxKeyLength
+    int sampleLetters = 1 << 16;  ///< Длина оценивается по стольким первым буквам (0 — по всем)
+    int maxThreads = 0;           ///< Максимальное число потоков (0 — по числу ядер)
+};
+
+/**
+ * @brief Оценка одной длины ключа
+ */
+struct VigenereLengthScore {
+    int length = 0;                   ///< Длина ключа
+    double indexOfCoincidence = 0.0;  ///< Средний индекс совпадений столбцов
+    double kasiski = 0.0;             ///< Доля повторов на кратных длине расстояниях относительно среднего
+    double score = 0.0;               ///< Итоговая оценка, больше — лучше
+};
+
+/**
+ * @brief Результат анализа
+ */
+struct VigenereAnalysis {
+    QString key;                              ///< Восстановленный ключ (заглавные буквы); пустой, если букв нет
+    QVector<VigenereLengthScore> candidates;  ///< Оценки длин, лучшие первыми
+    double chiSquared = 0.0;                  ///< Средний хи-квадрат столбцов для найденного ключа
+    qint64 letters = 0;                       ///< Число букв в шифротексте
+    qint64 elapsedNs = 0;                     ///< Время анализа, нс
+    int threads = 0;                          ///< Использовано потоков
+};
+
+/**
+ * @brief Восстанавливает ключ шифра Виженера по шифротексту
+ * @param ciphertext Шифротекст (латиница; прочие символы пропускаются)
+ * @param options Параметры анализа
+ * @return Найденный ключ и оценки длин
+ *
+ * @details
+ * Надёжен, когда на каждую букву ключа приходится хотя бы
+ * несколько десятков букв текста.
+ */
+VigenereAnalysis analyzeVigenere(const QString& ciphertext,
+                                 const VigenereAnalysisOptions& options = VigenereAnalysisOptions());
+
+/// То же для текста в ASCII/UTF-8
+VigenereAnalysis analyzeVigenere(const QByteArray& ciphertext,
+                                 const VigenereAnalysisOptions& options = VigenereAnalysisOptions());
+
+/**
+ * @brief Гистограмма латинских букв без учёта регистра
+ * @param data Байты (ASCII или UTF-8)
+ * @param size Размер в байтах
+ * @param counts Сюда прибавляется число каждой буквы (26 элементов, A..Z)
+ *
+ * @details
+ * С AVX2 буквы приводятся к номеру 0..25 и сравниваются с каждым
+ * номером по 32 байта; байтовые счётчики сбрасываются в общие каждые
+ * 255 шагов.
+ */
+void latinHistogram(const char* data, qint64 size, quint64* counts);
+
+#endif // VIGENEREANALYSIS_H
@@ -0,0 +1,443 @@
+/**
+ * @file vigenereattack.cpp
+ * @brief Реализация подбора ключей шифра Виженера
+ * @date 2024
+ */
+
+#include "vigenereattack.h"
+#include "vigenere.h"
+#include "parallel.h"
+#include <QFile>
+#include <QMutexLocker>
+#include <QRandomGenerator>
+#include <QSet>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+const int LETTERS = 26;
+const int TRIGRAMS = LETTERS * LETTERS * LETTERS;
+
+// Веса смеси: квадграмма, триграмма × буква, произведение букв
+const double QUADGRAM_WEIGHT = 0.6;
+const double TRIGRAM_WEIGHT = 0.3;
+const double UNIGRAM_WEIGHT = 0.1;
+
+// Штраф за букву ключа: log10(26), цена случайной буквы. Более длинный
+// ключ подгоняет текст под английский лучше, но выигрывает, только если
+// улучшение больше штрафа. Одинаков для словаря и восхождения, иначе
+// ключи двух методов нельзя сравнивать
+const float KEY_LETTER_PENALTY = 1.415f;
+
+// Слов словаря на одно задание
+const int WORDS_PER_TASK = 64;
+
+// Встроенный обучающий текст: английская проза на темы курса и задач
+// сервера. Из него строятся таблица квадграмм и словарь по умолчанию
+const char* const ENGLISH_TEXT =
+    "The students meet every week to work on small problems in programming and cryptography. "
+    "Each task starts with a short question from the server, and the answer is checked at once. "
+    "In the first task you compute a hash of a message and compare it with the value that the "
+    "teacher has given. In the second task you find the root of a number with the method of Newton, "
+    "which starts from a good guess and then improves it again and again until the change is very "
+    "small. In the third task you hide a secret message inside a sound file, so that nobody can hear "
+    "the difference. In the fourth task you encrypt a word with the cipher of Vigenere, using a key "
+    "that the server has chosen for you. "
+    "Hello world is the first program that most people write when they learn a new language. "
+    "The secret message was written in a letter and sent to a friend who lived far away in the north. "
+    "She read the message twice, then she put it into the fire and watched it burn. "
+    "A cipher is a method for turning a readable text into a text that looks like nonsense. "
+    "The person who knows the key can turn it back, and everyone else sees only a string of letters. "
+    "For many years the cipher of Vigenere was called the indecipherable cipher, because the simple "
+    "counting of letters that breaks a single shift does not work when the shift keeps changing. "
+    "Later it was shown that the length of the key can be found from repeated groups of letters, and "
+    "once the length is known, every column is only a simple shift that is easy to break. "
+    "This is why a long key is safer than a short one, and a key that is as long as the message and "
+    "never used again cannot be broken at all. "
+    "Keep the key in a safe place, lock the door when you leave, and never tell the password to "
+    "anyone. Change your password often and do not use the same code for every account. "
+    "The old man sat by the window and looked at the rain falling on the garden. He thought about "
+    "the years when he was young and worked on the railway, when the trains were slow and the "
+    "winters were long and cold. His daughter came home in the evening and they had dinner together "
+    "in the kitchen, talking about the weather, the children, and the news from the city. "
+    "There is nothing more important than to know what you want and to work hard for it every day. "
+    "We should always tell the truth, help our neighbours, and be kind to those who are weaker "
+    "than we are. The best time to plant a tree was twenty years ago, and the second best time is now. "
+    "The quick brown fox jumps over the lazy dog, and the dog does not even open its eyes. "
+    "Attack at dawn, said the general, and the soldiers prepared their weapons during the night. "
+    "The enemy could read the orders because the code had been stolen, and the attack failed. "
+    "After the war the story of the broken code became famous, and many books were written about "
+    "the people who had worked in secret to read the messages of the other side. "
+    "Mathematics is the language in which the book of nature is written, and numbers are its letters. "
+    "A computer does exactly what it is told, which is not always what the programmer wanted. "
+    "When the program runs too slowly, first measure where the time goes, and only then change the "
+    "code. Most of the time is often spent in a small loop that is called millions of times, and a "
+    "better algorithm there is worth more than any clever trick elsewhere. "
+    "The server listens for new connections, reads a request from each client, performs the "
+    "requested task, and sends the answer back. Every user has a login and a password, and the "
+    "database keeps the statistics of correct and wrong answers for every task. "
+    "The morning was bright and clear, and the children ran out of the house to play in the snow. "
+    "They built a big snowman with a carrot for a nose and two black stones for eyes, and their "
+    "mother took a picture of them standing next to it. "
+    "Reading is to the mind what exercise is to the body. A good book is a friend that never leaves "
+    "you, and every page opens a door to another world. "
+    "Write the answer in capital letters, without spaces, and press enter to send it to the server. "
+    "If the answer is right, the server will say so and give you the next question. If it is wrong, "
+    "it will show the correct answer so that you can learn from the mistake and try again. "
+    "The ship sailed across the ocean for many weeks, and the sailors were glad to see the land "
+    "again. The captain wrote in his journal every evening, describing the wind, the waves, and the "
+    "strange birds that followed the ship. "
+    "Knowledge is power, but only when it is shared. The teacher explained the lesson slowly and "
+    "patiently, and at the end of the hour every student could solve the problem alone.";
+
+// Номер латинской буквы 0..25 или -1
+inline int letterIndex(ushort c)
+{
+    const unsigned index = unsigned(c | 0x20) - 'a';
+    return c < 0x80 && index < unsigned(LETTERS) ? int(index) : -1;
+}
+
+} // namespace
+
+QuadgramTable::QuadgramTable()
+    : table(SIZE, float(4 * std::log10(1.0 / LETTERS)))
+{
+}
+
+QuadgramTable QuadgramTable::fromText(const QByteArray& text)
+{
+    QVector<quint64> counts(SIZE, 0);
+    quint32 index = 0;
+    int run = 0;
+    for (char c : text) {
+        const int letter = letterIndex(uchar(c));
+        if (letter < 0) {
+            continue;
+        }
+        index = (index % TRIGRAMS) * LETTERS + letter;
+        if (++run >= 4) {
+            ++counts[int(index)];
+        }
+    }
+
+    QuadgramTable result;
+    result.build(counts);
+    return result;
+}
+
+bool QuadgramTable::load(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return false;
+    }
+
+    QVector<quint64> counts(SIZE, 0);
+    bool any = false;
+    while (!file.atEnd()) {
+        const QList<QByteArray> fields = file.readLine().simplified().split(' ');
+        if (fields.size() != 2 || fields[0].size() != 4) {
+            continue;
+        }
+        int index = 0;
+        bool valid = true;
+        for (char c : fields[0]) {
+            const int letter = letterIndex(uchar(c));
+            valid = valid && letter >= 0;
+            index = index * LETTERS + qMax(0, letter);
+        }
+        bool ok = false;
+        const quint64 count = fields[1].toULongLong(&ok);
+        if (valid && ok) {
+            counts[index] += count;
+            any = any || count > 0;
+        }
+    }
+    if (any) {
+        build(counts);
+    }
+    return any;
+}
+
+void QuadgramTable::build(const QVector<quint64>& counts)
+{
+    // Частоты триграмм и букв получаются суммированием частот квадграмм
+    QVector<quint64> trigrams(TRIGRAMS, 0);
+    quint64 unigrams[LETTERS] = {};
+    quint64 total = 0;
+    for (int i = 0; i < SIZE; ++i) {
+        trigrams[i / LETTERS] += counts[i];
+        unigrams[i % LETTERS] += counts[i];
+        total += counts[i];
+    }
+    if (total == 0) {
+        return;
+    }
+
+    // Буквы, которых не было в тексте, получают половину наименьшей частоты
+    double letterProbability[LETTERS];
+    for (int k = 0; k < LETTERS; ++k) {
+        letterProbability[k] = (unigrams[k] > 0 ? double(unigrams[k]) : 0.5) / total;
+    }
+
+    table.resize(SIZE);
+    for (int i = 0; i < SIZE; ++i) {
+        const int d = i % LETTERS;
+        const int c = i / LETTERS % LETTERS;
+        const int b = i / (LETTERS * LETTERS) % LETTERS;
+        const int a = i / TRIGRAMS;
+        const double probability = QUADGRAM_WEIGHT * counts[i] / total
+                + TRIGRAM_WEIGHT * double(trigrams[i / LETTERS]) / total * letterProbability[d]
+                + UNIGRAM_WEIGHT * letterProbability[a] * letterProbability[b] * letterProbability[c]
+                                 * letterProbability[d];
+        table[i] = float(std::log10(probability));
+    }
+}
+
+const QuadgramTable& QuadgramTable::english()
+{
+    static const QuadgramTable table = fromText(QByteArray(ENGLISH_TEXT));
+    return table;
+}
+
+VigenereKeySearch::VigenereKeySearch(const QString& ciphertext, const QuadgramTable& quadgrams)
+    : ciphertext(ciphertext), table(quadgrams.data()), maxKeyLength(12), prefixLength(300),
+      threadCount(0), bestScore(-std::numeric_limits<float>::infinity()), keysTried(0)
+{
+    letters.reserve(ciphertext.size());
+    for (QChar c : ciphertext) {
+        const int letter = letterIndex(c.unicode());
+        if (letter >= 0) {
+            letters.append(char(letter));
+        }
+    }
+}
+
+float VigenereKeySearch::scoreKey(const quint8* shifts, int length, float bound) const
+{
+    const int count = qMin(letters.size(), prefixLength);
+    const quint8* text = reinterpret_cast<const quint8*>(letters.constData());
+    float score = -KEY_LETTER_PENALTY * length;
+    quint32 index = 0;
+    int phase = 0;
+    for (int i = 0; i < count; ++i) {
+        int plain = int(text[i]) - shifts[phase];
+        plain += plain < 0 ? LETTERS : 0;
+        phase = phase + 1 == length ? 0 : phase + 1;
+        index = (index % TRIGRAMS) * LETTERS + plain;
+        if (i >= 3) {
+            score += table[index];
+            // Логарифмы отрицательны: сумма уже не догонит лучшую
+            if (score < bound) {
+                return score;
+            }
+        }
+    }
+    return score;
+}
+
+void VigenereKeySearch::offer(const quint8* shifts, int length, float score)
+{
+    if (score < bestScore.load(std::memory_order_relaxed)) {
+        return;
+    }
+    QMutexLocker locker(&bestMutex);
+    const float current = bestScore.load(std::memory_order_relaxed);
+    // При равной оценке (например, KEY и KEYKEY) выбирается более короткий ключ
+    const bool better = score > current || bestShifts.isEmpty()
+            || (score == current && (length < bestShifts.size()
+                                     || (length == bestShifts.size()
+                                         && std::memcmp(shifts, bestShifts.constData(), length) < 0)));
+    if (better) {
+        bestShifts = QByteArray(reinterpret_cast<const char*>(shifts), length);
+        bestScore.store(score, std::memory_order_relaxed);
+    }
+}
+
+void VigenereKeySearch::start()
+{
+    keysTried.store(0);
+    timer.start();
+}
+
+void VigenereKeySearch::finish(int threads)
+{
+    lastStats.keysTried = keysTried.load();
+    lastStats.elapsedNs = timer.nsecsElapsed();
+    lastStats.threads = threads;
+}
+
+bool VigenereKeySearch::dictionary(const QStringList& words, int mutations)
+{
+    start();
+    if (letters.size() < 4) {
+        finish(0);
+        return false;
+    }
+
+    const int tasks = (words.size() + WORDS_PER_TASK - 1) / WORDS_PER_TASK;
+    const int threads = parallelFor(tasks, [&](int task) {
+        const int end = qMin(words.size(), (task + 1) * WORDS_PER_TASK);
+        quint64 tried = 0;
+        QByteArray shifts;
+        auto tryKey = [&](const QByteArray& key) {
+            const quint8* data = reinterpret_cast<const quint8*>(key.constData());
+            offer(data, key.size(), scoreKey(data, key.size(), bestScore.load(std::memory_order_relaxed)));
+            ++tried;
+        };
+
+        for (int i = task * WORDS_PER_TASK; i < end; ++i) {
+            shifts.clear();
+            for (QChar c : words[i]) {
+                const int letter = letterIndex(c.unicode());
+                if (letter >= 0) {
+                    shifts.append(char(letter));
+                }
+            }
+            if (shifts.isEmpty() || shifts.size() > maxKeyLength) {
+                continue;
+            }
+
+            if (mutations & AsIs) {
+                tryKey(shifts);
+            }
+            if (mutations & Reverse) {
+                QByteArray reversed(shifts.size(), Qt::Uninitialized);
+                std::reverse_copy(shifts.constBegin(), shifts.constEnd(), reversed.begin());
+                tryKey(reversed);
+            }
+            if (mutations & SingleLetter) {
+                QByteArray mutated = shifts;
+                for (int position = 0; position < mutated.size(); ++position) {
+                    for (int letter = 0; letter < LETTERS; ++letter) {
+                        if (letter != shifts[position]) {
+                            mutated[position] = char(letter);
+                            tryKey(mutated);
+                        }
+                    }
+                    mutated[position] = shifts[position];
+                }
+            }
+        }
+        keysTried.fetch_add(tried, std::memory_order_relaxed);
+    }, threadCount);
+
+    finish(threads);
+    QMutexLocker locker(&bestMutex);
+    return !bestShifts.isEmpty();
+}
+
+bool VigenereKeySearch::hillClimb(int restarts)
+{
+    start();
+    const int count = qMin(letters.size(), prefixLength);
+    const int lengths = qMin(maxKeyLength, count / MIN_LETTERS_PER_KEY_LETTER);
+    restarts = qMax(1, restarts);
+    if (lengths <= 0) {
+        finish(0);
+        return false;
+    }
+
+    QByteArray seed;
+    {
+        QMutexLocker locker(&bestMutex);
+        seed = bestShifts;
+    }
+
+    const int threads = parallelFor(lengths * restarts, [&](int task) {
+        const int length = 1 + task / restarts;
+        const int restart = task % restarts;
+        quint64 tried = 0;
+
+        // Старты воспроизводимы: генератор зависит только от номера задания
+        QByteArray key(length, Qt::Uninitialized);
+        if (restart == 0 && seed.size() == length) {
+            key = seed;
+        } else {
+            QRandomGenerator random(quint32(task) + 1);
+            for (int position = 0; position < length; ++position) {
+                key[position] = char(random.bounded(LETTERS));
+            }
+        }
+        quint8* shifts = reinterpret_cast<quint8*>(key.data());
+
+        float current = scoreKey(shifts, length, -std::numeric_limits<float>::infinity());
+        ++tried;
+        bool improved = true;
+        while (improved) {
+            improved = false;
+            for (int position = 0; position < length; ++position) {
+                const quint8 original = shifts[position];
+                quint8 best = original;
+                for (int letter = 0; letter < LETTERS; ++letter) {
+                    if (letter == original) {
+                        continue;
+                    }
+                    shifts[position] = quint8(letter);
+                    const float score = scoreKey(shifts, length, current);
+                    ++tried;
+                    if (score > current) {
+                        current = score;
+                        best = quint8(letter);
+                        improved = true;
+                    }
+                }
+                shifts[position] = best;
+            }
+        }
+
+        offer(shifts, length, current);
+        keysTried.fetch_add(tried, std::memory_order_relaxed);
+    }, threadCount);
+
+    finish(threads);
+    QMutexLocker locker(&bestMutex);
+    return !bestShifts.isEmpty();
+}
+
+QString VigenereKeySearch::key() const
+{
+    QMutexLocker locker(&bestMutex);
+    QString result;
+    for (char shift : bestShifts) {
+        result.append(QChar('A' + shift));
+    }
+    return result;
+}
+
+double VigenereKeySearch::score() const
+{
+    QMutexLocker locker(&bestMutex);
+    return bestShifts.isEmpty() ? -std::numeric_limits<double>::infinity() : double(bestScore.load());
+}
+
+QString VigenereKeySearch::plaintext() const
+{
+    return VigenereKey(key()).decrypt(ciphertext);
+}
+
+QStringList VigenereKeySearch::defaultDictionary()
+{
+    QStringList words;
+    QSet<QString> seen;
+    QString word;
+    for (const char* c = ENGLISH_TEXT; ; ++c) {
+        const int letter = letterIndex(uchar(*c));
+        if (letter >= 0) {
+            word.append(QChar('A' + letter));
+            continue;
+        }
+        if (!word.isEmpty() && !seen.contains(word)) {
+            seen.insert(word);
+            words.append(word);
+        }
+        word.clear();
+        if (!*c) {
+            break;
+        }
+    }
+    return words;
+}
@@ -0,0 +1,207 @@
+/**
+ * @file vigenereattack.h
+ * @brief Словарная атака и поиск восхождением для ключей шифра Виженера
+ * @date 2024
+ *
+ * @details
+ * Для коротких шифротекстов (как в задаче 4: «HELLO» ключом «KEY»)
+ * метод Касиски и индекс совпадений не работают — статистики слишком
+ * мало. Здесь ключ подбирается перебором: ключи из словаря и их
+ * модификации, затем поиск восхождением (hill climbing) по буквам
+ * ключа со случайных стартов.
+ *
+ * Кандидат оценивается суммой логарифмов вероятностей квадграмм
+ * расшифрованного текста. Расшифровывается только начало текста,
+ * нужное для оценки, и сразу на лету: буквы открытого текста не
+ * сохраняются. Таблица квадграмм — плоский массив 26^4 float,
+ * индексируемый скользящим номером квадграммы.
+ *
+ * Перебор делится на задания для всех ядер. Лучшая оценка общая для
+ * потоков: так как логарифмы отрицательны, частичная сумма только
+ * убывает, и кандидат отбрасывается, как только она опускается ниже
+ * лучшей.
+ *
+ * @see vigenereanalysis.h
+ */
+
+#ifndef VIGENEREATTACK_H
+#define VIGENEREATTACK_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
+
+/**
+ * @brief Таблица логарифмов вероятностей квадграмм
+ *
+ * @details
+ * Элемент [((a·26 + b)·26 + c)·26 + d] — log10 вероятности квадграммы
+ * abcd (буквы 0..25). Вероятность сглаживается смесью частот
+ * квадграммы, триграммы с частотой последней буквы и произведения
+ * частот букв, поэтому невстречавшиеся квадграммы не получают
+ * одинаковый штраф и оценка остаётся осмысленной даже для таблицы,
+ * построенной по небольшому тексту.
+ */
+class QuadgramTable {
+public:
+    /// Число квадграмм
+    static const int SIZE = 26 * 26 * 26 * 26;
+
+    /// Пустая таблица: все квадграммы равновероятны
+    QuadgramTable();
+
+    /**
+     * @brief Строит таблицу по тексту
+     * @param text Обучающий текст; учитываются латинские буквы без учёта регистра
+     */
+    static QuadgramTable fromText(const QByteArray& text);
+
+    /**
+     * @brief Загружает таблицу из файла частот
+     * @param path Файл со строками вида "TION 13168375"
+     * @return true если прочитана хотя бы одна квадграмма
+     */
+    bool load(const QString& path);
+
+    /// Таблица, построенная по встроенному английскому тексту (строится один раз)
+    static const QuadgramTable& english();
+
+    /// Плоский массив SIZE логарифмов
+    const float* data() const { return table.constData(); }
+
+private:
+    void build(const QVector<quint64>& counts);
+
+    QVector<float> table;
+};
+
+/**
+ * @brief Статистика перебора
+ */
+struct VigenereSearchStats {
+    quint64 keysTried = 0;  ///< Оценено ключей
+    qint64 elapsedNs = 0;   ///< Время перебора, нс
+    int threads = 0;        ///< Использовано потоков
+
+    /// Общая скорость, ключей/с
+    double keysPerSecond() const { return elapsedNs > 0 ? keysTried * 1e9 / elapsedNs : 0.0; }
+
+    /// Скорость в пересчёте на одно ядро
+    double keysPerSecondPerCore() const { return threads > 0 ? keysPerSecond() / threads : 0.0; }
+};
+
+/**
+ * @brief Подбор ключа шифра Виженера по оценке квадграмм
+ *
+ * @details
+ * Ключ сдвигается только на буквах, как в VigenereKey. Результаты
+ * последовательных вызовов dictionary() и hillClimb() накапливаются:
+ * ключ меняется, только если найден кандидат с лучшей оценкой.
+ *
+ * @example
+ * @code
+ * VigenereKeySearch search(ciphertext);
+ * search.dictionary(VigenereKeySearch::defaultDictionary());
+ * search.hillClimb();
+ * QString key = search.key();
+ * @endcode
+ */
+class VigenereKeySearch {
+public:
+    /// Модификации слов словаря (можно комбинировать)
+    enum Mutation {
+        AsIs         = 0x01,  ///< Слово без изменений
+        Reverse      = 0x02,  ///< Слово задом наперёд
+        SingleLetter = 0x04,  ///< Одна буква заменена любой другой
+        AllMutations = 0x07
+    };
+
+    /**
+     * @brief Конструктор
+     * @param ciphertext Шифротекст (латиница; прочие символы пропускаются)
+     * @param quadgrams Таблица оценки; должна жить дольше объекта
+     */
+    explicit VigenereKeySearch(const QString& ciphertext,
+                               const QuadgramTable& quadgrams = QuadgramTable::english());
+
+    /// Максимальная длина ключа (по умолчанию 12)
+    void setMaxKeyLength(int length) { maxKeyLength = qMax(1, length); }
+
+    /// Сколько первых букв шифротекста расшифровывается для оценки (по умолчанию 300)
+    void setPrefixLength(int letters) { prefixLength = qMax(4, letters); }
+
+    /// Число потоков (0 — по числу ядер)
+    void setThreadCount(int count) { threadCount = qMax(0, count); }
+
+    /**
+     * @brief Перебирает ключи из словаря
+     * @param words Слова; берутся латинские буквы, регистр не важен
+     * @param mutations Комбинация флагов Mutation
+     * @return true если найден хотя бы один ключ
+     *
+     * @details Оценка та же, что в hillClimb(), со штрафом за длину ключа,
+     * поэтому восхождение после словаря может заменить найденный ключ.
+     */
+    bool dictionary(const QStringList& words, int mutations = AsIs | Reverse);
+
+    /**
+     * @brief Поиск восхождением по буквам ключа
+     * @param restarts Число случайных стартов на каждую длину ключа
+     * @return true если найден хотя бы один ключ
+     *
+     * @details
+     * Пробуются длины, при которых на букву ключа приходится не меньше
+     * MIN_LETTERS_PER_KEY_LETTER букв текста, иначе подходит почти любой
+     * открытый текст. К оценке ключа длины L добавляется штраф
+     * L·log10(26), поэтому ключ, повторяющий более короткий, не
+     * выигрывает. Один из стартов каждой длины — лучший уже найденный
+     * ключ этой длины.
+     */
+    bool hillClimb(int restarts = 8);
+
+    /// Найденный ключ (заглавные буквы; пустой, если ничего не найдено)
+    QString key() const;
+
+    /// Оценка найденного ключа: сумма log10 вероятностей квадграмм минус штраф за длину ключа
+    double score() const;
+
+    /// Шифротекст, расшифрованный найденным ключом
+    QString plaintext() const;
+
+    /// Статистика последнего запуска
+    VigenereSearchStats stats() const { return lastStats; }
+
+    /// Слова встроенного английского текста, из которого строится таблица квадграмм
+    static QStringList defaultDictionary();
+
+    /// Меньше букв текста на букву ключа поиск восхождением не пробует
+    static const int MIN_LETTERS_PER_KEY_LETTER = 8;
+
+private:
+    float scoreKey(const quint8* shifts, int length, float bound) const;
+    void offer(const quint8* shifts, int length, float score);
+    void start();
+    void finish(int threads);
+
+    QString ciphertext;
+    const float* table;
+    QByteArray letters;
+
+    int maxKeyLength;
+    int prefixLength;
+    int threadCount;
+
+    std::atomic<float> bestScore;
+    std::atomic<quint64> keysTried;
+    mutable QMutex bestMutex;
+    QByteArray bestShifts;
+
+    QElapsedTimer timer;
+    VigenereSearchStats lastStats;
+};
+
+#endif // VIGENEREATTACK_H
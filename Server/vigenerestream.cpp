@@ -0,0 +1,180 @@
+/**
+ * @file vigenerestream.cpp
+ * @brief Реализация потокового и многопоточного шифра Виженера
+ * @date 2024
+ */
+
+#include "vigenerestream.h"
+#include "parallel.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QVector>
+
+namespace {
+
+// Наибольшее число фрагментов параллельного прохода
+const qint64 MAX_PARALLEL_CHUNKS = 1 << 16;
+
+qint64 clampChunkSize(qint64 chunkSize)
+{
+    return qBound<qint64>(1, chunkSize, VIGENERE_MAX_CHUNK_SIZE);
+}
+
+bool samePath(const QString& a, const QString& b)
+{
+    const QFileInfo first(a);
+    const QFileInfo second(b);
+    return first.exists() && second.exists() ? first.canonicalFilePath() == second.canonicalFilePath()
+                                             : first.absoluteFilePath() == second.absoluteFilePath();
+}
+
+} // namespace
+
+VigenereStream::VigenereStream(const VigenereKey& key, bool decrypt)
+    : key(key), decrypt(decrypt)
+{
+}
+
+void VigenereStream::process(const char* in, char* out, qint64 size)
+{
+    keyPhase = key.transformBytes(in, out, size, keyPhase, decrypt);
+}
+
+VigenereFileResult transformVigenereFile(const QString& inputPath, const QString& outputPath,
+                                         const VigenereKey& key, bool decrypt, qint64 chunkSize)
+{
+    VigenereFileResult result;
+    result.threads = 1;
+    if (samePath(inputPath, outputPath)) {
+        result.error = "Input and output must differ";
+        return result;
+    }
+
+    QFile input(inputPath);
+    if (!input.open(QIODevice::ReadOnly)) {
+        result.error = "Cannot open input file: " + input.errorString();
+        return result;
+    }
+    QFile output(outputPath);
+    if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        result.error = "Cannot open output file: " + output.errorString();
+        return result;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // Буфер не больше файла: большой chunkSize не выделяет лишнюю память
+    chunkSize = clampChunkSize(chunkSize);
+    if (!input.isSequential()) {
+        chunkSize = qMin(chunkSize, qMax<qint64>(1, input.size()));
+    }
+
+    VigenereStream stream(key, decrypt);
+    QByteArray buffer(int(chunkSize), Qt::Uninitialized);
+    for (;;) {
+        const qint64 read = input.read(buffer.data(), buffer.size());
+        if (read < 0) {
+            result.error = "Read error: " + input.errorString();
+            return result;
+        }
+        if (read == 0) {
+            break;
+        }
+        stream.process(buffer.constData(), buffer.data(), read);
+        if (output.write(buffer.constData(), read) != read) {
+            result.error = "Write error: " + output.errorString();
+            return result;
+        }
+        result.bytes += read;
+    }
+
+    result.elapsedNs = timer.nsecsElapsed();
+    result.success = true;
+    return result;
+}
+
+VigenereFileResult transformVigenereFileParallel(const QString& inputPath, const QString& outputPath,
+                                                 const VigenereKey& key, bool decrypt, int maxThreads,
+                                                 qint64 chunkSize)
+{
+    VigenereFileResult result;
+    const bool inPlace = samePath(inputPath, outputPath);
+
+    QFile input(inputPath);
+    if (!input.open(inPlace ? QIODevice::ReadWrite : QIODevice::ReadOnly)) {
+        result.error = "Cannot open input file: " + input.errorString();
+        return result;
+    }
+    const qint64 size = input.size();
+
+    QFile output(outputPath);
+    if (!inPlace) {
+        if (!output.open(QIODevice::ReadWrite | QIODevice::Truncate) || !output.resize(size)) {
+            result.error = "Cannot open output file: " + output.errorString();
+            return result;
+        }
+    }
+    if (size == 0) {
+        result.success = true;
+        return result;
+    }
+
+    uchar* source = input.map(0, size);
+    uchar* target = inPlace ? source : output.map(0, size);
+    if (!source || !target) {
+        // Отображение недоступно (например, на некоторых файловых системах)
+        if (source) {
+            input.unmap(source);
+        }
+        input.close();
+        output.close();
+        if (inPlace) {
+            result.error = "Cannot map file for in-place processing";
+            return result;
+        }
+        return transformVigenereFile(inputPath, outputPath, key, decrypt, chunkSize);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    chunkSize = qMax(clampChunkSize(chunkSize), (size + MAX_PARALLEL_CHUNKS - 1) / MAX_PARALLEL_CHUNKS);
+    const qint64 chunkCount = (size + chunkSize - 1) / chunkSize;
+    const int chunks = int(chunkCount);  // не больше MAX_PARALLEL_CHUNKS
+    const char* in = reinterpret_cast<const char*>(source);
+    char* out = reinterpret_cast<char*>(target);
+
+    // Проход 1: буквы каждого фрагмента
+    QVector<qint64> letters(chunks, 0);
+    parallelFor(chunks, [&](int chunk) {
+        const qint64 begin = chunk * chunkSize;
+        letters[chunk] = countLatinLetters(in + begin, qMin(chunkSize, size - begin));
+    }, maxThreads);
+
+    // Префиксная сумма: фаза ключа в начале каждого фрагмента
+    QVector<int> phases(chunks, 0);
+    const int length = qMax(1, key.length());
+    qint64 total = 0;
+    for (int chunk = 0; chunk < chunks; ++chunk) {
+        phases[chunk] = int(total % length);
+        total += letters[chunk];
+    }
+
+    // Проход 2: фрагменты шифруются независимо
+    result.threads = parallelFor(chunks, [&](int chunk) {
+        const qint64 begin = chunk * chunkSize;
+        key.transformBytes(in + begin, out + begin, qMin(chunkSize, size - begin), phases[chunk], decrypt);
+    }, maxThreads);
+
+    result.elapsedNs = timer.nsecsElapsed();
+    result.bytes = size;
+
+    input.unmap(source);
+    if (!inPlace) {
+        output.unmap(target);
+    }
+    result.success = true;
+    return result;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file vigenerestream.h
+ * @brief Потоковый и многопоточный шифр Виженера для больших файлов
+ * @date 2024
+ *
+ * @details
+ * Шифрует текстовые файлы (журналы, корпуса) без загрузки целиком
+ * в память. Меняются латинские буквы ASCII; остальные байты, включая
+ * многобайтовые символы UTF-8, копируются, поэтому размер файла
+ * не меняется. Ключ, как в VigenereKey, сдвигается только на буквах.
+ *
+ * - VigenereStream обрабатывает данные фрагментами произвольного
+ *   размера и переносит позицию в ключе между вызовами.
+ * - Последовательный режим читает файл фрагментами по chunkSize.
+ * - Параллельный режим отображает файл в память (QFile::map) и делит
+ *   его на фрагменты. Сначала все потоки считают буквы своих
+ *   фрагментов, затем префиксная сумма этих чисел по модулю длины
+ *   ключа даёт начальную фазу каждого фрагмента, и фрагменты
+ *   шифруются одновременно. Результат побайтно совпадает
+ *   с последовательным.
+ *
+ * @example
+ * @code
+ * VigenereKey key("LEMON");
+ * VigenereFileResult r = transformVigenereFileParallel("corpus.txt", "corpus.enc", key, false);
+ * if (!r.success) qWarning() << r.error;
+ * @endcode
+ *
+ * @see vigenere.h
+ */
+
+#ifndef VIGENERESTREAM_H
+#define VIGENERESTREAM_H
+
+#include "vigenere.h"
+#include <QByteArray>
+#include <QString>
+
+/// Размер фрагмента по умолчанию, байт
+const qint64 VIGENERE_CHUNK_SIZE = 1 << 20;
+
+/// Наибольший размер фрагмента, байт: больший chunkSize уменьшается до него
+const qint64 VIGENERE_MAX_CHUNK_SIZE = 1 << 30;
+
+/**
+ * @brief Шифрование потока фрагментами с сохранением фазы ключа
+ */
+class VigenereStream {
+public:
+    /**
+     * @brief Конструктор
+     * @param key Скомпилированный ключ
+     * @param decrypt true для расшифрования
+     */
+    VigenereStream(const VigenereKey& key, bool decrypt);
+
+    /**
+     * @brief Обрабатывает очередной фрагмент потока
+     * @param in Входные байты
+     * @param out Выходной буфер того же размера; может совпадать с in
+     * @param size Размер фрагмента
+     */
+    void process(const char* in, char* out, qint64 size);
+
+    /// Обрабатывает фрагмент на месте
+    void process(QByteArray& chunk) { process(chunk.constData(), chunk.data(), chunk.size()); }
+
+    /// Текущая позиция в ключе
+    int phase() const { return keyPhase; }
+
+    /// Возвращает поток к началу ключа
+    void reset() { keyPhase = 0; }
+
+private:
+    VigenereKey key;
+    bool decrypt;
+    int keyPhase = 0;
+};
+
+/**
+ * @brief Результат обработки файла
+ */
+struct VigenereFileResult {
+    bool success = false;   ///< Файл обработан полностью
+    QString error;          ///< Сообщение об ошибке, пустое при успехе
+    qint64 bytes = 0;       ///< Размер файла
+    qint64 elapsedNs = 0;   ///< Время обработки, нс
+    int threads = 0;        ///< Использовано потоков
+
+    /// Скорость обработки, МБ/с
+    double megabytesPerSecond() const { return elapsedNs > 0 ? bytes * 1e3 / elapsedNs : 0.0; }
+};
+
+/**
+ * @brief Шифрует или дешифрует файл последовательно, фрагментами
+ * @param inputPath Входной файл
+ * @param outputPath Выходной файл (перезаписывается; не должен совпадать с входным)
+ * @param key Скомпилированный ключ
+ * @param decrypt true для расшифрования
+ * @param chunkSize Размер фрагмента чтения, байт (от 1 до VIGENERE_MAX_CHUNK_SIZE,
+ *                  но не больше размера файла)
+ * @return Результат обработки
+ */
+VigenereFileResult transformVigenereFile(const QString& inputPath, const QString& outputPath,
+                                         const VigenereKey& key, bool decrypt,
+                                         qint64 chunkSize = VIGENERE_CHUNK_SIZE);
+
+/**
+ * @brief Шифрует или дешифрует файл в нескольких потоках через отображение в память
+ * @param inputPath Входной файл
+ * @param outputPath Выходной файл; если совпадает с входным, файл меняется на месте
+ * @param key Скомпилированный ключ
+ * @param decrypt true для расшифрования
+ * @param maxThreads Максимальное число потоков (0 — по числу ядер)
+ * @param chunkSize Размер фрагмента одного задания, байт
+ * @return Результат обработки
+ *
+ * @details
+ * Если файл не удаётся отобразить в память, выполняется
+ * transformVigenereFile() в одном потоке. Слишком мелкие фрагменты
+ * укрупняются, чтобы число заданий оставалось ограниченным.
+ */
+VigenereFileResult transformVigenereFileParallel(const QString& inputPath, const QString& outputPath,
+                                                 const VigenereKey& key, bool decrypt, int maxThreads = 0,
+                                                 qint64 chunkSize = VIGENERE_CHUNK_SIZE);
+
+#endif // VIGENERESTREAM_H
@@ -4,10 +4,179 @@
  */
 
 #include "wavembed.h"
+#include "wavformat.h"
+#include "stegcontainer.h"
+#include "lsbkernels.h"
+#include "keyedscatter.h"
+#include "parallel.h"
 #include <QFile>
-#include <QDataStream>
-#include <QDebug>
-#include <QBitArray>
+#include <QFileInfo>
+#include <QVector>
+#include <limits>
+
+namespace {
+
+// Размер фрагмента чтения, байт
+const qint64 WAV_CHUNK_SIZE = 1 << 20;
+
+// Сколько байт сообщения старого формата проверяется за раз при поиске нулевого байта
+const qint64 LEGACY_SCAN_BYTES = 4096;
+
+bool samePath(const QString& a, const QString& b)
+{
+    const QFileInfo first(a);
+    const QFileInfo second(b);
+    return first.exists() && second.exists() ? first.canonicalFilePath() == second.canonicalFilePath()
+                                             : first.absoluteFilePath() == second.absoluteFilePath();
+}
+
+// Отсчёты, занятые заголовком контейнера: он всегда встраивается по биту на отсчёт
+const qint64 HEADER_SAMPLES = qint64(STEG_HEADER_SIZE) * 8;
+
+// Расположение bits битов сообщения в отсчётах файла. У целых отсчётов
+// с неполной разрядностью (EXTENSIBLE) младшие биты контейнера — всегда
+// нули, поэтому используются младшие значащие биты; у float — младшие
+// биты мантиссы
+LsbLayout sampleLayout(const WavInfo& info, int bits)
+{
+    LsbLayout layout;
+    layout.stride = info.blockAlign / info.channels;
+    layout.shift = info.isFloat ? 0 : qMax(0, layout.stride * 8 - info.validBits);
+    layout.bits = bits;
+    return layout;
+}
+
+// Сколько отсчётов занимает контейнер длиной containerSize байт
+qint64 usedSamples(qint64 containerSize, int bits)
+{
+    return HEADER_SAMPLES + ((containerSize - STEG_HEADER_SIZE) * 8 + bits - 1) / bits;
+}
+
+// Сообщение читается в QByteArray и декодируется в QString; их размер
+// ограничен int, а каждый байт UTF-8 может дать символ в два байта
+const qint64 MAX_MESSAGE_BYTES = std::numeric_limits<int>::max() / 2;
+
+// Проверяет длину сообщения из заголовка до выделения памяти; пустая строка — длина допустима
+QString checkMessageLength(qint64 length, int bits, qint64 sampleCount)
+{
+    if (usedSamples(STEG_HEADER_SIZE + length, bits) > sampleCount) {
+        return "Container length exceeds data chunk";
+    }
+    if (length > MAX_MESSAGE_BYTES) {
+        return "Container length is too large";
+    }
+    return QString();
+}
+
+// Наибольшая длина сообщения, байт
+qint64 messageCapacity(const WavInfo& info, int bits)
+{
+    const qint64 samples = info.dataSize / sampleLayout(info, bits).stride;
+    return samples > HEADER_SAMPLES ? (samples - HEADER_SAMPLES) * bits / 8 : 0;
+}
+
+// Встраивает контейнер в отсчёты [first, first + count); samples указывает на отсчёт first
+void embedContainer(char* samples, qint64 first, qint64 count, const LsbLayout& layout, const QByteArray& payload)
+{
+    LsbLayout headerLayout = layout;
+    headerLayout.bits = 1;
+    const qint64 headerCount = qBound<qint64>(0, HEADER_SAMPLES - first, count);
+    if (headerCount > 0) {
+        embedSampleBits(samples, headerCount, headerLayout, payload.constData(), STEG_HEADER_SIZE, first);
+    }
+    if (count > headerCount) {
+        embedSampleBits(samples + headerCount * layout.stride, count - headerCount, layout,
+                        payload.constData() + STEG_HEADER_SIZE, payload.size() - STEG_HEADER_SIZE,
+                        first + headerCount - HEADER_SAMPLES);
+    }
+}
+
+// Отсчётов сообщения в блоке рассеянного встраивания; кратно восьми,
+// поэтому каждый блок тела начинается на границе байта сообщения
+const qint64 SCATTER_BLOCK = 1 << 14;
+
+// Обходит отсчёты сообщения [first, end) блоками в нескольких потоках:
+// отсчёты блока собираются по перестановке в буфер подряд, fn(begin, count, buffer)
+// обрабатывает их, и при write буфер раскладывается обратно
+template <typename Fn>
+int forEachScatterBlock(char* samples, const LsbLayout& layout, const ScatterPermutation& permutation,
+                        qint64 first, qint64 end, bool write, int threads, Fn fn)
+{
+    const int blocks = int((end - first + SCATTER_BLOCK - 1) / SCATTER_BLOCK);
+    return parallelFor(blocks, [&](int block) {
+        const qint64 begin = first + block * SCATTER_BLOCK;
+        const qint64 count = qMin(SCATTER_BLOCK, end - begin);
+        QVector<quint64> indices(static_cast<int>(count));
+        for (int i = 0; i < count; ++i) {
+            indices[i] = permutation.map(quint64(begin + i));
+        }
+        QByteArray buffer(int(count * layout.stride), Qt::Uninitialized);
+        gatherSamples(samples, layout.stride, indices.constData(), count, buffer.data());
+        fn(begin, count, buffer.data());
+        if (write) {
+            scatterSamples(samples, layout.stride, indices.constData(), count, buffer.constData());
+        }
+    }, threads);
+}
+
+// Произвольный доступ к байтам, встроенным в блок "data": через отображение
+// в память или чтением только нужных отсчётов
+class LsbSource {
+public:
+    LsbSource(QFile& file, const WavInfo& info, bool map)
+        : file(file), dataOffset(info.dataOffset), dataSize(info.dataSize)
+    {
+        mapped = map && dataSize > 0 ? file.map(dataOffset, dataSize) : nullptr;
+    }
+
+    ~LsbSource()
+    {
+        if (mapped) {
+            file.unmap(mapped);
+        }
+    }
+
+    /// Отображённый блок "data" или nullptr
+    char* mappedData() const { return reinterpret_cast<char*>(mapped); }
+
+    /// Число отсчётов в блоке "data" при данном расположении
+    qint64 sampleCount(const LsbLayout& layout) const { return dataSize / layout.stride; }
+
+    /// Читает count байт, встроенных начиная с отсчёта firstSample; false при ошибке чтения
+    bool read(const LsbLayout& layout, qint64 firstSample, qint64 count, QByteArray& bytes)
+    {
+        bytes.resize(int(count));
+        if (mapped) {
+            extractSampleBits(reinterpret_cast<const char*>(mapped) + firstSample * layout.stride, layout, 0,
+                              bytes.data(), count);
+            return true;
+        }
+        const qint64 partBytes = qMax<qint64>(1, WAV_CHUNK_SIZE / layout.stride * layout.bits / 8);
+        for (qint64 done = 0; done < count; ) {
+            const qint64 part = qMin(count - done, partBytes);
+            const qint64 bit = done * 8;
+            const int skip = int(bit % layout.bits);
+            const qint64 samples = (skip + part * 8 + layout.bits - 1) / layout.bits;
+            buffer.resize(int(samples * layout.stride));
+            if (!file.seek(dataOffset + (firstSample + bit / layout.bits) * layout.stride)
+                    || file.read(buffer.data(), buffer.size()) != buffer.size()) {
+                return false;
+            }
+            extractSampleBits(buffer.constData(), layout, skip, bytes.data() + done, part);
+            done += part;
+        }
+        return true;
+    }
+
+private:
+    QFile& file;
+    qint64 dataOffset;
+    qint64 dataSize;
+    uchar* mapped;
+    QByteArray buffer;
+};
+
+} // namespace
 
 WavEmbed::WavEmbed(QObject *parent) : QObject(parent)
 {
@@ -15,123 +184,407 @@ WavEmbed::WavEmbed(QObject *parent) : QObject(parent)
 
 bool WavEmbed::embedMessage(const QString& inputFile, const QString& outputFile, const QString& message)
 {
-    // Открываем входной файл
+    lastError.clear();
+    const bool inPlace = QFileInfo::exists(inputFile) && samePath(inputFile, outputFile);
+
+    // Открываем входной файл и находим блок отсчётов
     QFile file(inputFile);
-    if (!file.open(QIODevice::ReadOnly)) {
+    if (!file.open(inPlace ? QIODevice::ReadWrite : QIODevice::ReadOnly)) {
+        lastError = "Cannot open input file: " + file.errorString();
         return false;
     }
-
-    // Читаем заголовок WAV
-    QByteArray header = file.read(44); // Стандартный размер заголовка WAV
-    if (header.size() != 44) {
-        file.close();
+    const WavInfo info = readWavInfo(file);
+    if (!info.valid) {
+        lastError = info.error;
         return false;
     }
 
-    // Проверяем, что это WAV файл
-    if (header.mid(0, 4) != "RIFF" || header.mid(8, 4) != "WAVE") {
-        file.close();
+    // Контейнер: заголовок с длиной и CRC, затем сообщение; биты идут от старшего к младшему
+    const QByteArray payload = packStegContainer(message.toUtf8(), stegFlagsForBits(lsbCount));
+
+    // Проверяем, достаточно ли места для сообщения
+    const qint64 available = messageCapacity(info, lsbCount);
+    if (payload.size() - STEG_HEADER_SIZE > available) {
+        lastError = QString("Message is %1 bytes, capacity is %2 bytes")
+                .arg(payload.size() - STEG_HEADER_SIZE).arg(available);
         return false;
     }
 
-    // Читаем данные
-    QByteArray data = file.readAll();
-    file.close();
+    const LsbLayout layout = sampleLayout(info, lsbCount);
+    if (!scatterKey.isEmpty()) {
+        return embedScattered(file, info, layout, payload, inPlace ? QString() : outputFile);
+    }
+    if (inPlace) {
+        return embedInPlace(file, info.dataOffset, layout, payload);
+    }
+    return embedCopy(file, info.dataOffset, layout, payload, outputFile);
+}
+
+qint64 WavEmbed::capacity(const QString& inputFile)
+{
+    lastError.clear();
+    const WavInfo info = readWavInfo(inputFile);
+    if (!info.valid) {
+        lastError = info.error;
+        return -1;
+    }
+    return messageCapacity(info, lsbCount);
+}
 
-    // Конвертируем сообщение в биты
-    QBitArray messageBits;
-    QByteArray messageBytes = message.toUtf8();
-    messageBits.resize(messageBytes.size() * 8);
-    
-    // Заполняем биты сообщения
-    for (int i = 0; i < messageBytes.size(); ++i) {
-        for (int j = 0; j < 8; ++j) {
-            messageBits.setBit(i * 8 + j, messageBytes[i] & (1 << (7 - j)));
+bool WavEmbed::embedInPlace(QFile& file, qint64 dataOffset, const LsbLayout& layout, const QByteArray& payload)
+{
+    const qint64 samples = usedSamples(payload.size(), layout.bits);
+
+    // Конвейер читает отсчёты с сообщением одним дескриптором и пишет их обратно другим
+    if (mode == Pipelined) {
+        QFile outFile(file.fileName());
+        if (!outFile.open(QIODevice::ReadWrite)) {
+            lastError = "Cannot open output file: " + outFile.errorString();
+            return false;
         }
+        return embedPipelined(file, dataOffset, samples * layout.stride, outFile, layout, payload);
     }
 
-    // Добавляем маркер конца сообщения (8 нулевых бит)
-    messageBits.resize(messageBits.size() + 8);
-    for (int i = 0; i < 8; ++i) {
-        messageBits.setBit(messageBits.size() - 8 + i, false);
+    // Отображение общее: на диск вернутся только изменённые страницы
+    if (mode == Mapped) {
+        if (uchar* data = file.map(dataOffset, samples * layout.stride)) {
+            embedContainer(reinterpret_cast<char*>(data), 0, samples, layout, payload);
+            file.unmap(data);
+            return true;
+        }
     }
 
-    // Проверяем, достаточно ли места для сообщения
-    if (messageBits.size() > data.size()) {
-        return false;
+    // Перезаписываются только отсчёты, несущие сообщение
+    const qint64 chunkSamples = qMax<qint64>(1, WAV_CHUNK_SIZE / layout.stride);
+    QByteArray buffer;
+    for (qint64 done = 0; done < samples; ) {
+        const qint64 count = qMin(samples - done, chunkSamples);
+        const qint64 position = dataOffset + done * layout.stride;
+        if (!file.seek(position)) {
+            lastError = "Cannot seek in input file";
+            return false;
+        }
+        buffer = file.read(count * layout.stride);
+        if (buffer.size() != count * layout.stride) {
+            lastError = "Read error: " + file.errorString();
+            return false;
+        }
+        embedContainer(buffer.data(), done, count, layout, payload);
+        if (!file.seek(position) || file.write(buffer) != buffer.size()) {
+            lastError = "Write error: " + file.errorString();
+            return false;
+        }
+        done += count;
     }
+    return true;
+}
 
-    // Встраиваем сообщение
-    for (int i = 0; i < messageBits.size(); ++i) {
-        // Устанавливаем младший бит байта данных
-        data[i] = (data[i] & 0xFE) | (messageBits[i] ? 1 : 0);
-    }
+bool WavEmbed::embedCopy(QFile& file, qint64 dataOffset, const LsbLayout& layout, const QByteArray& payload,
+                         const QString& outputFile)
+{
+    const qint64 samples = usedSamples(payload.size(), layout.bits);
+    const qint64 size = file.size();
 
-    // Записываем результат
     QFile outFile(outputFile);
-    if (!outFile.open(QIODevice::WriteOnly)) {
+    if (!outFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        lastError = "Cannot open output file: " + outFile.errorString();
         return false;
     }
 
-    outFile.write(header);
-    outFile.write(data);
-    outFile.close();
+    // Частное отображение (copy-on-write): копируются в память только
+    // страницы с сообщением, остальные пишутся прямо из кэша файла
+    if (mode == Mapped) {
+        if (uchar* mapped = file.map(0, size, QFileDevice::MapPrivateOption)) {
+            char* data = reinterpret_cast<char*>(mapped);
+            embedContainer(data + dataOffset, 0, samples, layout, payload);
+            const bool written = outFile.write(data, size) == size;
+            file.unmap(mapped);
+            if (!written) {
+                lastError = "Write error: " + outFile.errorString();
+            }
+            return written;
+        }
+    }
+
+    // Байты до блока "data" копируются сразу, отсчёты и всё после них — через конвейер
+    if (mode == Pipelined) {
+        if (!file.seek(0)) {
+            lastError = "Cannot seek in input file";
+            return false;
+        }
+        for (qint64 done = 0; done < dataOffset; ) {
+            const QByteArray head = file.read(qMin(WAV_CHUNK_SIZE, dataOffset - done));
+            if (head.isEmpty()) {
+                lastError = "Read error: " + file.errorString();
+                return false;
+            }
+            if (outFile.write(head) != head.size()) {
+                lastError = "Write error: " + outFile.errorString();
+                return false;
+            }
+            done += head.size();
+        }
+        return embedPipelined(file, dataOffset, size - dataOffset, outFile, layout, payload);
+    }
+
+    // Файл копируется фрагментами; байты до блока "data" читаются отдельно,
+    // чтобы фрагменты отсчётов начинались на границе отсчёта
+    if (!file.seek(0)) {
+        lastError = "Cannot seek in input file";
+        return false;
+    }
+    const qint64 embedEnd = dataOffset + samples * layout.stride;
+    const qint64 chunkSize = qMax<qint64>(1, WAV_CHUNK_SIZE / layout.stride) * layout.stride;
+    QByteArray buffer(int(chunkSize), Qt::Uninitialized);
+    qint64 position = 0;
+    for (;;) {
+        const qint64 want = position < dataOffset ? qMin(chunkSize, dataOffset - position) : chunkSize;
+        const qint64 read = file.read(buffer.data(), want);
+        if (read < 0) {
+            lastError = "Read error: " + file.errorString();
+            return false;
+        }
+        if (read == 0) {
+            break;
+        }
+        const qint64 begin = qMax(position, dataOffset);
+        const qint64 end = qMin(position + read, embedEnd);
+        if (begin < end) {
+            embedContainer(buffer.data() + (begin - position), (begin - dataOffset) / layout.stride,
+                           (end - begin) / layout.stride, layout, payload);
+        }
+        if (outFile.write(buffer.constData(), read) != read) {
+            lastError = "Write error: " + outFile.errorString();
+            return false;
+        }
+        position += read;
+    }
 
     return true;
 }
 
+bool WavEmbed::embedScattered(QFile& file, const WavInfo& info, const LsbLayout& layout,
+                              const QByteArray& payload, const QString& outputFile)
+{
+    // Отсчёты сообщения разбросаны по всему блоку "data": нужен произвольный
+    // доступ, поэтому файл отображается в память при любом IoMode. На месте —
+    // общее отображение блока, для копии — частное отображение всего файла
+    const bool inPlace = outputFile.isEmpty();
+    const qint64 size = file.size();
+    uchar* mapped = inPlace ? file.map(info.dataOffset, info.dataSize)
+                            : file.map(0, size, QFileDevice::MapPrivateOption);
+    if (!mapped) {
+        lastError = "Cannot map input file: " + file.errorString();
+        return false;
+    }
+    char* samples = reinterpret_cast<char*>(mapped) + (inPlace ? 0 : info.dataOffset);
+
+    const ScatterPermutation permutation(quint64(info.dataSize / layout.stride), scatterKey);
+    forEachScatterBlock(samples, layout, permutation, 0, usedSamples(payload.size(), layout.bits), true, threadCount,
+                        [&](qint64 first, qint64 count, char* buffer) {
+        embedContainer(buffer, first, count, layout, payload);
+    });
+
+    bool written = true;
+    if (!inPlace) {
+        QFile outFile(outputFile);
+        written = outFile.open(QIODevice::WriteOnly | QIODevice::Truncate)
+                && outFile.write(reinterpret_cast<const char*>(mapped), size) == size;
+        if (!written) {
+            lastError = "Write error: " + outFile.errorString();
+        }
+    }
+    file.unmap(mapped);
+    return written;
+}
+
+QString WavEmbed::extractScattered(QFile& file, const WavInfo& info)
+{
+    LsbSource source(file, info, true);
+    char* samples = source.mappedData();
+    if (!samples) {
+        lastError = "Cannot map input file: " + file.errorString();
+        return QString();
+    }
+    LsbLayout layout = sampleLayout(info, 1);
+    const qint64 sampleCount = source.sampleCount(layout);
+    if (sampleCount < HEADER_SAMPLES) {
+        lastError = "No message found";
+        return QString();
+    }
+    const ScatterPermutation permutation(quint64(sampleCount), scatterKey);
+
+    // Заголовок: первые 112 отсчётов сообщения, по биту на отсчёт
+    QByteArray bytes(STEG_HEADER_SIZE, Qt::Uninitialized);
+    forEachScatterBlock(samples, layout, permutation, 0, HEADER_SAMPLES, false, 1,
+                        [&](qint64, qint64, char* buffer) {
+        extractSampleBits(buffer, layout, 0, bytes.data(), STEG_HEADER_SIZE);
+    });
+    if (!hasStegSignature(bytes)) {
+        lastError = "No message found for this key";
+        return QString();
+    }
+    StegHeader header;
+    lastError = parseStegHeader(bytes, header);
+    if (!lastError.isEmpty()) {
+        return QString();
+    }
+    layout.bits = stegBitsFromFlags(header.flags);
+    const qint64 length = header.length;
+    lastError = checkMessageLength(length, layout.bits, sampleCount);
+    if (!lastError.isEmpty()) {
+        return QString();
+    }
+    const qint64 used = usedSamples(STEG_HEADER_SIZE + length, layout.bits);
+
+    // Тело: каждый блок даёт свой отрезок байт сообщения
+    bytes.resize(int(length));
+    forEachScatterBlock(samples, layout, permutation, HEADER_SAMPLES, used, false, threadCount,
+                        [&](qint64 first, qint64 count, char* buffer) {
+        const qint64 begin = (first - HEADER_SAMPLES) * layout.bits / 8;
+        extractSampleBits(buffer, layout, 0, bytes.data() + begin, qMin(length - begin, count * layout.bits / 8));
+    });
+    if (crc32(bytes.constData(), bytes.size()) != header.crc) {
+        lastError = "Container CRC mismatch";
+        return QString();
+    }
+    return QString::fromUtf8(bytes);
+}
+
+void WavEmbed::setPipelineBuffers(qint64 bufferSize, int bufferCount)
+{
+    pipelineBufferSize = qMax<qint64>(1, bufferSize);
+    pipelineBufferCount = qMax(2, bufferCount);
+}
+
+void WavEmbed::preparePipeline(const LsbLayout& layout)
+{
+    // Буфер — целое число групп из восьми отсчётов: каждый начинается
+    // на границе байта сообщения
+    const qint64 group = 8 * layout.stride;
+    pipeline.setBuffers(qMax(group, pipelineBufferSize / group * group), pipelineBufferCount);
+}
+
+bool WavEmbed::embedPipelined(QFile& file, qint64 dataOffset, qint64 length, QFile& outFile,
+                              const LsbLayout& layout, const QByteArray& payload)
+{
+    const qint64 samples = usedSamples(payload.size(), layout.bits);
+    preparePipeline(layout);
+    const bool done = pipeline.run(file, dataOffset, length, &outFile, dataOffset,
+                                   [&](char* data, qint64 size, qint64 offset) {
+        const qint64 first = offset / layout.stride;
+        const qint64 count = qBound<qint64>(0, samples - first, size / layout.stride);
+        if (count > 0) {
+            embedContainer(data, first, count, layout, payload);
+        }
+        return true;
+    });
+    if (!done) {
+        lastError = pipeline.errorString();
+    }
+    return done;
+}
+
+bool WavEmbed::extractPipelined(QFile& file, qint64 dataOffset, const LsbLayout& layout, qint64 length,
+                                QByteArray& bytes)
+{
+    bytes.resize(int(length));
+    const qint64 samples = (length * 8 + layout.bits - 1) / layout.bits;
+    preparePipeline(layout);
+    const bool done = pipeline.run(file, dataOffset + HEADER_SAMPLES * layout.stride, samples * layout.stride,
+                                   nullptr, 0, [&](char* data, qint64 size, qint64 offset) {
+        const qint64 begin = offset / layout.stride * layout.bits / 8;
+        const qint64 count = qMin(length - begin, size / layout.stride * layout.bits / 8);
+        extractSampleBits(data, layout, 0, bytes.data() + begin, count);
+        return true;
+    });
+    if (!done) {
+        lastError = pipeline.errorString();
+    }
+    return done;
+}
+
 QString WavEmbed::extractMessage(const QString& inputFile)
 {
-    // Открываем файл
+    lastError.clear();
+
+    // Открываем файл и находим блок отсчётов
     QFile file(inputFile);
     if (!file.open(QIODevice::ReadOnly)) {
+        lastError = "Cannot open input file: " + file.errorString();
+        return QString();
+    }
+    const WavInfo info = readWavInfo(file);
+    if (!info.valid) {
+        lastError = info.error;
         return QString();
     }
 
-    // Пропускаем заголовок
-    file.seek(44);
-
-    // Читаем данные
-    QByteArray data = file.readAll();
-    file.close();
-
-    // Извлекаем биты
-    QBitArray messageBits;
-    messageBits.resize(data.size());
-    
-    for (int i = 0; i < data.size(); ++i) {
-        messageBits.setBit(i, data[i] & 1);
+    if (!scatterKey.isEmpty()) {
+        return extractScattered(file, info);
     }
 
-    // Ищем конец сообщения (8 нулевых бит)
-    int messageEnd = 0;
-    for (int i = 0; i < messageBits.size() - 8; ++i) {
-        bool isEnd = true;
-        for (int j = 0; j < 8; ++j) {
-            if (messageBits[i + j]) {
-                isEnd = false;
-                break;
+    // Читаются только заголовок и сообщение; при отображении в память
+    // с диска подгружаются только эти страницы. Заголовок ищется сначала
+    // в отсчётах, затем в байтах, как встраивали прежние версии
+    LsbSource source(file, info, mode == Mapped);
+    const LsbLayout byteLayout;
+    const LsbLayout layouts[] = {sampleLayout(info, 1), byteLayout};
+    const int layoutCount = layouts[0].stride == 1 && layouts[0].shift == 0 ? 1 : 2;
+    QByteArray bytes;
+    for (int i = 0; i < layoutCount; ++i) {
+        LsbLayout layout = layouts[i];
+        if (source.sampleCount(layout) < HEADER_SAMPLES) {
+            continue;
+        }
+        if (!source.read(layout, 0, STEG_HEADER_SIZE, bytes)) {
+            lastError = "Read error: " + file.errorString();
+            return QString();
+        }
+        if (!hasStegSignature(bytes)) {
+            continue;
+        }
+        StegHeader header;
+        lastError = parseStegHeader(bytes, header);
+        if (!lastError.isEmpty()) {
+            return QString();
+        }
+        layout.bits = stegBitsFromFlags(header.flags);
+        lastError = checkMessageLength(header.length, layout.bits, source.sampleCount(layout));
+        if (!lastError.isEmpty()) {
+            return QString();
+        }
+        if (mode == Pipelined) {
+            if (!extractPipelined(file, info.dataOffset, layout, header.length, bytes)) {
+                return QString();
             }
+        } else if (!source.read(layout, HEADER_SAMPLES, header.length, bytes)) {
+            lastError = "Read error: " + file.errorString();
+            return QString();
         }
-        if (isEnd) {
-            messageEnd = i;
-            break;
+        if (crc32(bytes.constData(), bytes.size()) != header.crc) {
+            lastError = "Container CRC mismatch";
+            return QString();
         }
+        return QString::fromUtf8(bytes);
     }
 
-    // Конвертируем биты в байты
-    QByteArray messageBytes;
-    messageBytes.resize(messageEnd / 8);
-    
-    for (int i = 0; i < messageEnd; i += 8) {
-        char byte = 0;
-        for (int j = 0; j < 8; ++j) {
-            if (messageBits[i + j]) {
-                byte |= (1 << (7 - j));
-            }
+    // Старый формат: текст UTF-8 до нулевого байта. Маркер записывался
+    // на границе байта, поэтому ищется только там
+    const qint64 legacyCapacity = source.sampleCount(byteLayout) / 8;
+    QByteArray message;
+    for (qint64 offset = 0; offset < legacyCapacity; offset += LEGACY_SCAN_BYTES) {
+        if (!source.read(byteLayout, offset * 8, qMin(LEGACY_SCAN_BYTES, legacyCapacity - offset), bytes)) {
+            lastError = "Read error: " + file.errorString();
+            return QString();
+        }
+        const int end = bytes.indexOf('\0');
+        if (end >= 0) {
+            message.append(bytes.left(end));
+            return QString::fromUtf8(message);
         }
-        messageBytes[i / 8] = byte;
+        message.append(bytes);
     }
-
-    return QString::fromUtf8(messageBytes);
-} 
\ No newline at end of file
+    lastError = "No message found";
+    return QString();
+}
@@ -1,31 +1,172 @@
 /**
  * @file wavembed.h
  * @brief Заголовочный файл для стеганографии в WAV файлах
- * 
+ *
  * Реализует функции для встраивания и извлечения скрытых сообщений
  * в WAV аудиофайлах с использованием LSB-метода.
  * Используется в задаче 3 для стеганографических операций.
+ *
+ * Положение отсчётов определяется разбором блоков RIFF (wavformat.h),
+ * поэтому поддерживаются файлы с блоками LIST, fact и другими,
+ * а также WAVE_FORMAT_EXTENSIBLE. Меняются только байты блока "data";
+ * блоки до и после него копируются без изменений.
+ *
+ * Сообщение встраивается в контейнере с длиной и CRC-32
+ * (stegcontainer.h), поэтому извлечение читает только отсчёты
+ * заголовка и сообщения. Файлы старого формата (текст и нулевой байт)
+ * по-прежнему читаются.
+ *
+ * Биты сообщения записываются в k младших битов каждого отсчёта
+ * (setSampleBits(), 1–4) при любой разрядности и числе каналов:
+ * целые 8/16/24/32 бита, float32 и float64. У целых отсчётов
+ * с неполной разрядностью (EXTENSIBLE) используются младшие значащие
+ * биты. Заголовок контейнера всегда занимает один бит отсчёта, а k
+ * хранится в его флагах, так что извлечение не требует настройки.
+ * Вместимость до встраивания сообщает capacity().
+ *
+ * В режиме Mapped (по умолчанию) файл отображается в память
+ * (QFile::map): при встраивании в копию используется частное
+ * отображение (copy-on-write), так что в память копируются только
+ * страницы с сообщением, а извлечение читает младшие биты прямо
+ * из отображения. Если выходной файл совпадает с входным, сообщение
+ * встраивается на месте и на диск записываются только изменённые
+ * страницы. Если файл не удаётся отобразить, используется режим
+ * Streamed — чтение фрагментами по 1 МБ.
+ *
+ * Режим Pipelined рассчитан на многогигабайтные записи: файл проходит
+ * через StreamPipeline (streampipeline.h) — чтение, встраивание или
+ * извлечение и запись идут в разных потоках через небольшой пул
+ * буферов, так что память не зависит от размера файла. В этом режиме
+ * доступны прогресс, отмена и скорость каждой стадии.
+ *
+ * Если задан ключ (setKey()), отсчёты сообщения рассеиваются по всему
+ * блоку "data" перестановкой ScatterPermutation (keyedscatter.h),
+ * которая вычисляется на лету без таблицы индексов. Отсчёты сообщения
+ * делятся на блоки, обрабатываемые в нескольких потоках. Извлечь такое
+ * сообщение можно только с тем же ключом. Рассеянному встраиванию
+ * нужен произвольный доступ, поэтому файл всегда отображается в память.
  */
 
 #ifndef WAVEMBED_H
 #define WAVEMBED_H
 
+#include "streampipeline.h"
+#include <QByteArray>
+#include <QObject>
 #include <QString>
 
-/**
- * @brief Встраивает сообщение в WAV файл
- * @param inputFile Путь к исходному WAV файлу
- * @param outputFile Путь для сохранения файла с сообщением
- * @param message Сообщение для встраивания
- * @return true если встраивание успешно
- */
-bool embedMessage(const QString& inputFile, const QString& outputFile, const QString& message);
+class QFile;
+struct LsbLayout;
+struct WavInfo;
 
 /**
- * @brief Извлекает скрытое сообщение из WAV файла
- * @param inputFile Путь к WAV файлу с сообщением
- * @return Извлеченное сообщение или пустую строку в случае ошибки
+ * @brief Встраивание сообщений в младшие биты отсчётов WAV
  */
-QString extractMessage(const QString& inputFile);
+class WavEmbed : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// Способ доступа к файлу
+    enum IoMode {
+        Streamed,   ///< Чтение и запись фрагментами
+        Mapped,     ///< Отображение в память; при неудаче — Streamed
+        Pipelined   ///< Чтение, обработка и запись в разных потоках через пул буферов
+    };
+
+    explicit WavEmbed(QObject *parent = nullptr);
+
+    /// Устанавливает способ доступа к файлу (по умолчанию Mapped)
+    void setIoMode(IoMode ioMode) { mode = ioMode; }
+
+    /// Текущий способ доступа к файлу
+    IoMode ioMode() const { return mode; }
+
+    /// Устанавливает число младших битов отсчёта для сообщения (1–4, по умолчанию 1)
+    void setSampleBits(int bits) { lsbCount = qBound(1, bits, 4); }
+
+    /// Число младших битов отсчёта для сообщения
+    int sampleBits() const { return lsbCount; }
+
+    /// Задаёт ключ рассеянного встраивания; пустой ключ — последовательное встраивание
+    void setKey(const QByteArray& key) { scatterKey = key; }
+
+    /// Число потоков рассеянного встраивания (0 — по числу ядер)
+    void setThreadCount(int count) { threadCount = qMax(0, count); }
+
+    /**
+     * @brief Задаёт буферы режима Pipelined
+     * @param bufferSize Размер буфера, байт (округляется до целого числа групп отсчётов)
+     * @param bufferCount Число буферов (не меньше 2)
+     */
+    void setPipelineBuffers(qint64 bufferSize, int bufferCount);
+
+    /**
+     * @brief Задаёт обработчик прогресса режима Pipelined
+     * @param callback Функция, получающая состояние и скорость стадий
+     * @param intervalMs Минимальный интервал между вызовами, мс
+     *
+     * @note Обработчик вызывается из потока, выполняющего встраивание или извлечение.
+     */
+    void setProgressCallback(std::function<void(const StreamPipelineStats&)> callback, int intervalMs = 1000)
+    {
+        pipeline.setProgressCallback(std::move(callback), intervalMs);
+    }
+
+    /// Прерывает текущую операцию в режиме Pipelined (можно вызывать из другого потока);
+    /// вызов до начала операции прерывает ближайший проход конвейера
+    void cancel() { pipeline.cancel(); }
+
+    /// Статистика последнего прохода конвейера
+    StreamPipelineStats pipelineStats() const { return pipeline.stats(); }
+
+    /**
+     * @brief Вычисляет, сколько байт сообщения вмещает файл
+     * @param inputFile Путь к WAV файлу
+     * @return Наибольшая длина сообщения в UTF-8, байт, при текущем sampleBits(); -1 при ошибке
+     */
+    qint64 capacity(const QString& inputFile);
+
+    /**
+     * @brief Встраивает сообщение в WAV файл
+     * @param inputFile Путь к исходному WAV файлу
+     * @param outputFile Путь для сохранения файла с сообщением; если совпадает с исходным, файл меняется на месте
+     * @param message Сообщение для встраивания
+     * @return true если встраивание успешно
+     */
+    bool embedMessage(const QString& inputFile, const QString& outputFile, const QString& message);
+
+    /**
+     * @brief Извлекает скрытое сообщение из WAV файла
+     * @param inputFile Путь к WAV файлу с сообщением
+     * @return Извлеченное сообщение или пустую строку в случае ошибки
+     */
+    QString extractMessage(const QString& inputFile);
+
+    /// Описание ошибки последней операции (пустое при успехе)
+    QString errorString() const { return lastError; }
+
+private:
+    bool embedInPlace(QFile& file, qint64 dataOffset, const LsbLayout& layout, const QByteArray& payload);
+    bool embedCopy(QFile& file, qint64 dataOffset, const LsbLayout& layout, const QByteArray& payload,
+                   const QString& outputFile);
+
+    bool embedPipelined(QFile& file, qint64 dataOffset, qint64 length, QFile& outFile, const LsbLayout& layout,
+                        const QByteArray& payload);
+    bool extractPipelined(QFile& file, qint64 dataOffset, const LsbLayout& layout, qint64 length, QByteArray& bytes);
+    void preparePipeline(const LsbLayout& layout);
+    bool embedScattered(QFile& file, const WavInfo& info, const LsbLayout& layout, const QByteArray& payload,
+                        const QString& outputFile);
+    QString extractScattered(QFile& file, const WavInfo& info);
+
+    IoMode mode = Mapped;
+    int lsbCount = 1;
+    qint64 pipelineBufferSize = PIPELINE_BUFFER_SIZE;
+    int pipelineBufferCount = PIPELINE_BUFFER_COUNT;
+    StreamPipeline pipeline;
+    QByteArray scatterKey;
+    int threadCount = 0;
+    QString lastError;
+};
 
 #endif // WAVEMBED_H
@@ -0,0 +1,170 @@
+/**
+ * @file wavformat.cpp
+ * @brief Реализация разбора заголовка RIFF/WAVE
+ * @date 2024
+ */
+
+#include "wavformat.h"
+#include <QByteArray>
+#include <QFile>
+
+namespace {
+
+// Подформат WAVE_FORMAT_EXTENSIBLE — GUID xxxx0000-0000-0010-8000-00AA00389B71,
+// где xxxx — обычный код формата; здесь общий хвост после кода
+const char EXTENSIBLE_GUID_TAIL[] = "\x00\x00\x00\x00\x10\x00\x80\x00\x00\xAA\x00\x38\x9B\x71";
+const int EXTENSIBLE_GUID_TAIL_SIZE = 14;
+
+// Длина блока "fmt " для WAVE_FORMAT_EXTENSIBLE; длиннее не читается
+const int FMT_EXTENSIBLE_SIZE = 40;
+
+quint16 readLe16(const QByteArray& bytes, int offset)
+{
+    const uchar* p = reinterpret_cast<const uchar*>(bytes.constData()) + offset;
+    return quint16(p[0] | (p[1] << 8));
+}
+
+quint32 readLe32(const QByteArray& bytes, int offset)
+{
+    const uchar* p = reinterpret_cast<const uchar*>(bytes.constData()) + offset;
+    return quint32(p[0]) | (quint32(p[1]) << 8) | (quint32(p[2]) << 16) | (quint32(p[3]) << 24);
+}
+
+// Разбирает и проверяет тело блока "fmt "; возвращает текст ошибки или пустую строку
+QString parseFormat(const QByteArray& fmt, WavInfo& info)
+{
+    info.formatTag = readLe16(fmt, 0);
+    info.channels = readLe16(fmt, 2);
+    info.sampleRate = readLe32(fmt, 4);
+    info.blockAlign = readLe16(fmt, 12);
+    info.bitsPerSample = readLe16(fmt, 14);
+    info.validBits = info.bitsPerSample;
+
+    quint16 sampleFormat = info.formatTag;
+    if (info.formatTag == WAV_FORMAT_EXTENSIBLE) {
+        if (fmt.size() < FMT_EXTENSIBLE_SIZE || readLe16(fmt, 16) < FMT_EXTENSIBLE_SIZE - 18) {
+            return "Extensible fmt chunk is too short";
+        }
+        if (fmt.mid(26, EXTENSIBLE_GUID_TAIL_SIZE) != QByteArray::fromRawData(EXTENSIBLE_GUID_TAIL,
+                                                                             EXTENSIBLE_GUID_TAIL_SIZE)) {
+            return "Unsupported extensible sub-format";
+        }
+        sampleFormat = readLe16(fmt, 24);
+        const int validBits = readLe16(fmt, 18);
+        if (validBits > info.bitsPerSample) {
+            return QString("Valid bits %1 exceed container size %2").arg(validBits).arg(info.bitsPerSample);
+        }
+        // Ноль пишут программы, не заполняющие поле: все биты значащие
+        if (validBits > 0) {
+            info.validBits = validBits;
+        }
+    }
+
+    if (sampleFormat == WAV_FORMAT_PCM) {
+        if (info.bitsPerSample != 8 && info.bitsPerSample != 16 && info.bitsPerSample != 24
+                && info.bitsPerSample != 32) {
+            return QString("Unsupported PCM bit depth %1").arg(info.bitsPerSample);
+        }
+    } else if (sampleFormat == WAV_FORMAT_IEEE_FLOAT) {
+        if (info.bitsPerSample != 32 && info.bitsPerSample != 64) {
+            return QString("Unsupported float bit depth %1").arg(info.bitsPerSample);
+        }
+        info.isFloat = true;
+    } else {
+        return QString("Unsupported WAV format tag 0x%1").arg(sampleFormat, 4, 16, QChar('0'));
+    }
+
+    if (info.channels < 1) {
+        return "WAV file has no channels";
+    }
+    if (info.sampleRate == 0) {
+        return "WAV file has zero sample rate";
+    }
+    if (info.blockAlign != info.channels * info.bytesPerSample()) {
+        return QString("Block align %1 does not match %2 channels of %3 bits")
+                .arg(info.blockAlign).arg(info.channels).arg(info.bitsPerSample);
+    }
+    return QString();
+}
+
+} // namespace
+
+WavInfo readWavInfo(QIODevice& device)
+{
+    WavInfo info;
+    info.fileSize = device.size();
+    if (!device.seek(0)) {
+        info.error = "Cannot seek in WAV file";
+        return info;
+    }
+
+    const QByteArray riff = device.read(12);
+    if (riff.size() < 12 || !riff.startsWith("RIFF") || riff.mid(8, 4) != "WAVE") {
+        info.error = riff.startsWith("RF64") ? "RF64 files are not supported" : "Not a RIFF/WAVE file";
+        return info;
+    }
+
+    // Обход блоков: читаются только заголовки и "fmt ", остальное пропускается
+    bool haveFormat = false;
+    bool haveData = false;
+    qint64 position = 12;
+    while (!(haveFormat && haveData) && position + 8 <= info.fileSize) {
+        if (!device.seek(position)) {
+            info.error = "Cannot seek in WAV file";
+            return info;
+        }
+        const QByteArray header = device.read(8);
+        if (header.size() < 8) {
+            break;
+        }
+        const QByteArray id = header.left(4);
+        const quint32 size = readLe32(header, 4);
+        const qint64 body = position + 8;
+
+        if (id == "fmt ") {
+            if (haveFormat) {
+                info.error = "Duplicate fmt chunk";
+                return info;
+            }
+            if (size < 16) {
+                info.error = "fmt chunk is too short";
+                return info;
+            }
+            const QByteArray fmt = device.read(qMin<qint64>(size, FMT_EXTENSIBLE_SIZE));
+            if (fmt.size() < 16) {
+                info.error = "Truncated fmt chunk";
+                return info;
+            }
+            info.error = parseFormat(fmt, info);
+            if (!info.error.isEmpty()) {
+                return info;
+            }
+            haveFormat = true;
+        } else if (id == "data" && !haveData) {
+            info.dataOffset = body;
+            info.dataSize = qBound<qint64>(0, size, info.fileSize - body);
+            haveData = true;
+        }
+        position = body + size + (size & 1);
+    }
+
+    if (!haveFormat) {
+        info.error = "Missing fmt chunk";
+    } else if (!haveData) {
+        info.error = "Missing data chunk";
+    } else {
+        info.valid = true;
+    }
+    return info;
+}
+
+WavInfo readWavInfo(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        WavInfo info;
+        info.error = "Cannot open WAV file: " + file.errorString();
+        return info;
+    }
+    return readWavInfo(file);
+}
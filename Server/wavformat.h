@@ -0,0 +1,88 @@
+/**
+ * @file wavformat.h
+ * @brief Потоковый разбор заголовка RIFF/WAVE
+ * @date 2024
+ *
+ * @details
+ * Файл WAV — последовательность блоков RIFF (ID из 4 байт, 32-битная
+ * длина, данные, байт выравнивания при нечётной длине). Кроме "fmt "
+ * и "data" в нём бывают "LIST", "fact", "bext" и другие блоки, в том
+ * числе после "data", поэтому фиксированный заголовок в 44 байта
+ * подходит не всем файлам.
+ *
+ * readWavInfo() обходит блоки, читая только их заголовки и блок
+ * "fmt "; остальные блоки, включая сами отсчёты, пропускаются через
+ * seek(). Проверяются формат (PCM, IEEE float и WAVE_FORMAT_EXTENSIBLE
+ * с подформатом PCM или float), разрядность, число каналов
+ * и выравнивание блока. Результат — точное смещение и длина блока
+ * "data" в файле.
+ *
+ * @example
+ * @code
+ * WavInfo info = readWavInfo("speech.wav");
+ * if (!info.valid) qWarning() << info.error;
+ * else file.seek(info.dataOffset);
+ * @endcode
+ *
+ * @see wavembed.h
+ */
+
+#ifndef WAVFORMAT_H
+#define WAVFORMAT_H
+
+#include <QIODevice>
+#include <QString>
+
+/// Коды формата в блоке "fmt "
+enum WavFormatTag : quint16 {
+    WAV_FORMAT_PCM = 0x0001,
+    WAV_FORMAT_IEEE_FLOAT = 0x0003,
+    WAV_FORMAT_EXTENSIBLE = 0xFFFE
+};
+
+/**
+ * @brief Формат и расположение отсчётов WAV-файла
+ */
+struct WavInfo {
+    bool valid = false;         ///< Файл разобран и формат поддерживается
+    QString error;              ///< Сообщение об ошибке, пустое при успехе
+
+    quint16 formatTag = 0;      ///< Код формата из "fmt " (для EXTENSIBLE — 0xFFFE)
+    bool isFloat = false;       ///< Отсчёты IEEE float (иначе целые PCM)
+    int channels = 0;           ///< Число каналов
+    quint32 sampleRate = 0;     ///< Частота дискретизации, Гц
+    int bitsPerSample = 0;      ///< Разрядность контейнера отсчёта
+    int validBits = 0;          ///< Значащие биты (для EXTENSIBLE могут быть меньше)
+    int blockAlign = 0;         ///< Размер кадра (отсчёты всех каналов), байт
+
+    qint64 dataOffset = 0;      ///< Смещение отсчётов от начала файла
+    qint64 dataSize = 0;        ///< Длина блока "data", байт
+    qint64 fileSize = 0;        ///< Размер файла
+
+    /// Размер одного отсчёта, байт
+    int bytesPerSample() const { return bitsPerSample / 8; }
+
+    /// Число полных кадров в блоке "data"
+    qint64 frameCount() const { return blockAlign > 0 ? dataSize / blockAlign : 0; }
+};
+
+/**
+ * @brief Разбирает заголовок WAV из открытого устройства
+ * @param device Устройство с произвольным доступом, открытое на чтение
+ * @return Формат и положение блока "data"; позиция устройства не определена
+ *
+ * @details
+ * Длина блока "data", выходящая за конец файла (так пишут программы
+ * записи, прерванные до обновления заголовка), обрезается по концу
+ * файла.
+ */
+WavInfo readWavInfo(QIODevice& device);
+
+/**
+ * @brief Разбирает заголовок WAV-файла
+ * @param path Путь к файлу
+ * @return Формат и положение блока "data"
+ */
+WavInfo readWavInfo(const QString& path);
+
+#endif // WAVFORMAT_H
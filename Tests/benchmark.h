@@ -0,0 +1,152 @@
+/**
+ * @file benchmark.h
+ * @brief Общие средства замера скорости для бенчмарков тестов
+ * @date 2024
+ *
+ * @details
+ * Результат макроса QBENCHMARK тесту недоступен, поэтому бенчмарки
+ * замеряют время одним циклом measureBenchmark(): действие повторяется,
+ * пока не наберётся минимальное время, а итог передаётся в QtTest через
+ * QTest::setBenchmarkResult() и печатается reportThroughput()/reportRate().
+ * Отдельный QBENCHMARK рядом с ним не нужен.
+ *
+ * По умолчанию бенчмарки работают на небольших данных, чтобы обычный
+ * прогон тестов оставался быстрым. Большие размеры включаются переменной
+ * окружения BENCHMARK_LARGE=1 или переменной конкретного бенчмарка
+ * (см. benchmarkSize()).
+ *
+ * @example
+ * @code
+ * const qint64 bytes = benchmarkSize("VIGENERE_FILE_MB", 4, 64) << 20;
+ * const BenchmarkResult simd = measureBenchmark([&]() { encrypted = vigenere.encrypt(text, key); });
+ * reportThroughput("1 МБ", bytes, {{"AVX2", simd}});
+ * @endcode
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QTest>
+#include <initializer_list>
+
+/// Минимальное время замера по умолчанию, нс
+const qint64 BENCHMARK_MIN_NS = 100 * 1000 * 1000;
+
+/**
+ * @brief Итог замера: число повторов и затраченное время
+ */
+struct BenchmarkResult {
+    qint64 iterations = 0;  ///< Число повторов
+    qint64 elapsedNs = 0;   ///< Общее время, нс
+
+    /// Время одного повтора, нс
+    double nsPerIteration() const { return iterations > 0 ? double(elapsedNs) / iterations : 0.0; }
+
+    /// Единиц в секунду при units единицах за повтор
+    double perSecond(double units = 1.0) const { return elapsedNs > 0 ? units * iterations * 1e9 / elapsedNs : 0.0; }
+
+    /// МБ/с при bytes байт за повтор
+    double megabytesPerSecond(double bytes) const { return perSecond(bytes) / 1e6; }
+};
+
+/// Именованный результат для строки отчёта
+typedef QPair<QString, BenchmarkResult> NamedBenchmarkResult;
+
+/**
+ * @brief Однократный замер без передачи результата в QtTest
+ * @param function Замеряемое действие
+ *
+ * @details Для опорных вариантов (скалярный путь, прежняя реализация),
+ * с которыми сравнивается основной замер.
+ */
+template <typename Function>
+BenchmarkResult measureOnce(Function function)
+{
+    QElapsedTimer timer;
+    timer.start();
+    function();
+    BenchmarkResult result;
+    result.iterations = 1;
+    result.elapsedNs = qMax<qint64>(1, timer.nsecsElapsed());
+    return result;
+}
+
+/**
+ * @brief Основной замер бенчмарка
+ * @param function Замеряемое действие
+ * @param minNs Минимальное суммарное время, нс
+ * @return Число повторов и время; время повтора передаётся в QtTest
+ *
+ * @details Действие выполняется хотя бы один раз и повторяется, пока не
+ * пройдёт minNs. Долгие действия (файлы в сотни мегабайт) замеряются
+ * одним повтором.
+ */
+template <typename Function>
+BenchmarkResult measureBenchmark(Function function, qint64 minNs = BENCHMARK_MIN_NS)
+{
+    QElapsedTimer timer;
+    timer.start();
+    BenchmarkResult result;
+    do {
+        function();
+        ++result.iterations;
+        result.elapsedNs = timer.nsecsElapsed();
+    } while (result.elapsedNs < minNs);
+    result.elapsedNs = qMax<qint64>(1, result.elapsedNs);
+    QTest::setBenchmarkResult(result.nsPerIteration(), QTest::WalltimeNanoseconds);
+    return result;
+}
+
+/// Включены ли большие размеры бенчмарков (BENCHMARK_LARGE)
+inline bool largeBenchmarks()
+{
+    return !qEnvironmentVariableIsEmpty("BENCHMARK_LARGE") && qEnvironmentVariable("BENCHMARK_LARGE") != "0";
+}
+
+/**
+ * @brief Размер данных бенчмарка
+ * @param variable Переменная окружения, задающая размер явно
+ * @param small Размер по умолчанию
+ * @param large Размер при BENCHMARK_LARGE
+ * @return Значение переменной, если оно задано и положительно, иначе small или large
+ */
+inline qint64 benchmarkSize(const char* variable, qint64 small, qint64 large)
+{
+    bool ok = false;
+    const qint64 value = qgetenv(variable).toLongLong(&ok);
+    if (ok && value > 0) {
+        return value;
+    }
+    return largeBenchmarks() ? large : small;
+}
+
+/**
+ * @brief Печатает строку скоростей вида «метка: имя N единица, ...»
+ * @param label Начало строки
+ * @param unit Единица скорости («корней/с», «МБ/с»)
+ * @param units Единиц за повтор
+ * @param results Результаты по именам (пустое имя не печатается)
+ */
+inline void reportRate(const QString& label, const QString& unit, double units,
+                       std::initializer_list<NamedBenchmarkResult> results)
+{
+    QStringList parts;
+    for (const NamedBenchmarkResult& result : results) {
+        const QString rate = QString("%1 %2").arg(qRound64(result.second.perSecond(units))).arg(unit);
+        parts << (result.first.isEmpty() ? rate : result.first + " " + rate);
+    }
+    qInfo().noquote() << label + ":" << parts.join(", ");
+}
+
+/// Печатает строку скоростей в МБ/с при bytes байт за повтор
+inline void reportThroughput(const QString& label, double bytes, std::initializer_list<NamedBenchmarkResult> results)
+{
+    reportRate(label, "МБ/с", bytes / 1e6, results);
+}
+
+#endif // BENCHMARK_H
@@ -1,6 +1,119 @@
 #include "tst_newton.h"
 #include <QElapsedTimer>
 #include <QtMath>
+#include <QRandomGenerator>
+#include <QStringList>
+#include <algorithm>
+#include <complex>
+#include <limits>
+#include "benchmark.h"
+#include "cpufeatures.h"
+
+namespace {
+
+// Производная центральной разностью — эталон для сравнения с AD
+double finiteDifference(const Expression& f, double x)
+{
+    const double h = std::cbrt(std::numeric_limits<double>::epsilon()) * qMax(1.0, qAbs(x));
+    return (f.evaluate(x + h) - f.evaluate(x - h)) / (2 * h);
+}
+
+// Метод Ньютона с выбранным способом вычисления производной
+int newtonIterations(const Expression& f, double x, bool useFiniteDifference, double& root)
+{
+    int iterations = 0;
+    for (; iterations < 100; ++iterations) {
+        double fx, dfx;
+        if (useFiniteDifference) {
+            fx = f.evaluate(x);
+            dfx = finiteDifference(f, x);
+        } else {
+            Dual y = f.evaluate(Dual(x, 1.0));
+            fx = y.value;
+            dfx = y.derivative;
+        }
+        double next = x - fx / dfx;
+        if (qAbs(next - x) < 1e-13 * qMax(1.0, qAbs(x))) {
+            x = next;
+            ++iterations;
+            break;
+        }
+        x = next;
+    }
+    root = x;
+    return iterations;
+}
+
+// Случайный пакет задач: числа от 0.5 до 1e6, степени от 0 до 12
+RootBatch randomRootBatch(int count, quint32 seed)
+{
+    QRandomGenerator random(seed);
+    RootBatch batch;
+    batch.resize(count);
+    for (int i = 0; i < count; ++i) {
+        batch.numbers[i] = 0.5 + random.generateDouble() * 1e6;
+        batch.powers[i] = random.bounded(13);
+    }
+    return batch;
+}
+
+// Многочлен степени degree в виде произведения (x-0.1)(x-0.2)...
+QString productPolynomial(int degree)
+{
+    QStringList factors;
+    for (int k = 1; k <= degree; ++k) {
+        factors << QString("(x-%1)").arg(k / 10.0);
+    }
+    return factors.join("*");
+}
+
+// Многочлен со случайными коэффициентами из [-1, 1]
+QVector<double> randomPolynomial(int degree, QRandomGenerator& random)
+{
+    QVector<double> coefficients(degree + 1);
+    for (double& c : coefficients) {
+        c = random.generateDouble() * 2.0 - 1.0;
+    }
+    return coefficients;
+}
+
+// Наибольшая обратная ошибка |p(z)| / Σ|c_k|·|z|^k по всем корням
+double polynomialBackwardError(const QVector<double>& coefficients, const PolynomialRoots& roots)
+{
+    double worst = 0.0;
+    for (int i = 0; i < roots.size(); ++i) {
+        const std::complex<double> z(roots.re[i], roots.im[i]);
+        std::complex<double> value = 0.0;
+        double scale = 0.0;
+        for (int k = coefficients.size() - 1; k >= 0; --k) {
+            value = value * z + coefficients[k];
+            scale = scale * std::abs(z) + std::abs(coefficients[k]);
+        }
+        worst = qMax(worst, std::abs(value) / scale);
+    }
+    return worst;
+}
+
+// Плотная система F_i = x_i^3 + Σ_j a_ij·x_j - b_i с решением x = (1, ..., 1);
+// a_ij = 1 / (1 + |i - j|) с преобладающей диагональю
+void denseTestSystem(int n, const double* x, double* f, double* jacobian)
+{
+    for (int i = 0; i < n; ++i) {
+        double sum = x[i] * x[i] * x[i];
+        double rhs = 1.0;
+        for (int j = 0; j < n; ++j) {
+            const double a = 1.0 / (1 + qAbs(i - j)) + (i == j ? n : 0);
+            sum += a * x[j];
+            rhs += a;
+            if (jacobian) {
+                jacobian[i * n + j] = a + (i == j ? 3 * x[i] * x[i] : 0.0);
+            }
+        }
+        f[i] = sum - rhs;
+    }
+}
+
+} // namespace
 
 void TestNewton::testSimpleCase()
 {
@@ -34,4 +147,848 @@ void TestNewton::testPerformance()
     QVERIFY(elapsed < 100); // Проверяем, что решение находится быстро
 }
 
+void TestNewton::testSolveNewtonEquation_data()
+{
+    QTest::addColumn<QString>("equation");
+    QTest::addColumn<double>("initialGuess");
+    QTest::addColumn<double>("expected");
+
+    QTest::newRow("square") << "x^2 - 4" << 3.0 << 2.0;
+    QTest::newRow("cubic") << "x^3 - 2x - 5" << 2.0 << 2.0945514815;
+    QTest::newRow("equation") << "x**2 = 2" << 1.0 << qSqrt(2.0);
+    QTest::newRow("cosine") << "cos(x) = x" << 1.0 << 0.7390851332;
+    QTest::newRow("exponent") << "exp(x) - 3" << 1.0 << qLn(3.0);
+    QTest::newRow("implicit") << "2x(x - 1) - 1" << 2.0 << (1.0 + qSqrt(3.0)) / 2.0;
+}
+
+void TestNewton::testSolveNewtonEquation()
+{
+    QFETCH(QString, equation);
+    QFETCH(double, initialGuess);
+    QFETCH(double, expected);
+
+    QString result = solveNewton(equation, initialGuess, 1e-9);
+    bool ok = false;
+    double root = result.toDouble(&ok);
+    QVERIFY2(ok, qPrintable(result));
+    QVERIFY(qAbs(root - expected) < 1e-6);
+}
+
+void TestNewton::testExpressionErrors()
+{
+    QVERIFY(solveNewton("x^", 1.0).startsWith("Error:"));
+    QVERIFY(solveNewton("foo(x)", 1.0).startsWith("Error:"));
+    QVERIFY(solveNewton("(x + 1", 1.0).startsWith("Error:"));
+    QVERIFY_EXCEPTION_THROWN(Expression::compile(""), std::runtime_error);
+
+    // Пробелы разделяют лексемы: «2e - 3» — это 2·e − 3, а не число 2e-3
+    QCOMPARE(Expression::compile("2e - 3").evaluate(0.0), 2 * M_E - 3);
+    QCOMPARE(Expression::compile("2e-3").evaluate(0.0), 0.002);
+    QCOMPARE(Expression::compile("2 x").evaluate(3.0), 6.0);
+    QVERIFY(solveNewton("si n(x)", 1.0).startsWith("Error:"));
+    QVERIFY(solveNewton("x * * 2", 1.0).startsWith("Error:"));
+    QCOMPARE(Expression::normalize(" 2E - 3 "), QString("2 e-3"));
+
+    // Глубокая вложенность — ошибка разбора, а не переполнение стека
+    const int deep = 100000;
+    QVERIFY(solveNewton(QString(deep, '(') + "x" + QString(deep, ')'), 1.0).contains("too deeply nested"));
+    QVERIFY(solveNewton(QString(deep, '-') + "x", 1.0).contains("too deeply nested"));
+    QVERIFY(solveNewton("x" + QString("^x").repeated(deep), 1.0).contains("too deeply nested"));
+    QVERIFY(solveNewton("x" + QString("+x").repeated(deep), 1.0).contains("too deeply nested"));
+    const int allowed = Expression::MAX_NESTING_DEPTH / 2;
+    QCOMPARE(Expression::compile(QString(allowed, '(') + "x" + QString(allowed, ')')).evaluate(7.0), 7.0);
+}
+
+void TestNewton::testExpressionCache()
+{
+    ExpressionCache cache(2);
+
+    std::shared_ptr<const Expression> a = cache.get("x^2 - 4");
+    std::shared_ptr<const Expression> b = cache.get(" X ^ 2-4 ");
+    QCOMPARE(a.get(), b.get()); // нормализованный текст совпадает
+    QCOMPARE(cache.hits(), quint64(1));
+    QCOMPARE(cache.misses(), quint64(1));
+
+    cache.get("x + 1");
+    cache.get("x + 2"); // вытесняет самое старое выражение
+    QCOMPARE(cache.size(), 2);
+    QCOMPARE(a->evaluate(3.0), 5.0); // вытесненная программа остаётся валидной
+
+    cache.get("x^2 - 4");
+    QCOMPARE(cache.misses(), quint64(4));
+}
+
+void TestNewton::benchmarkExpressionEvaluate()
+{
+    Expression f = Expression::compile("3x^5 - 2x^3 + sin(x) * exp(-x^2) - 7");
+
+    const int count = 100000;
+    double sum = 0.0;
+    const BenchmarkResult measured = measureBenchmark([&]() {
+        for (int i = 0; i < count; ++i) {
+            sum += f.evaluate(i * 1e-5);
+        }
+    });
+    reportRate("Вычисление выражения", "вычислений/с", count, {{QString(), measured}});
+    QVERIFY(qIsFinite(sum));
+}
+
+void TestNewton::testDualDerivative()
+{
+    Expression f = Expression::compile("x^3 sin(x) + exp(2x) - sqrt(x)/x^2");
+
+    double maxDualError = 0.0;
+    double maxDifferenceError = 0.0;
+    for (double x = 0.25; x < 4.0; x += 0.25) {
+        const double exact = 3 * x * x * qSin(x) + x * x * x * qCos(x) + 2 * qExp(2 * x)
+                + 1.5 * std::pow(x, -2.5);
+
+        Dual y = f.evaluate(Dual(x, 1.0));
+        QCOMPARE(y.value, f.evaluate(x));
+
+        maxDualError = qMax(maxDualError, qAbs(y.derivative - exact) / qAbs(exact));
+        maxDifferenceError = qMax(maxDifferenceError, qAbs(finiteDifference(f, x) - exact) / qAbs(exact));
+    }
+
+    qInfo() << "Относительная ошибка f': AD" << maxDualError << ", конечные разности" << maxDifferenceError;
+    QVERIFY(maxDualError < 1e-13);
+    QVERIFY(maxDualError < maxDifferenceError);
+
+    // Производная степени в корне Newton::calculateRoot
+    Newton n;
+    QVERIFY(qAbs(n.calculateRoot(27.0, 3) - 3.0) < 1e-10);
+}
+
+void TestNewton::benchmarkNewtonDerivative_data()
+{
+    QTest::addColumn<bool>("useFiniteDifference");
+
+    QTest::newRow("dual") << false;
+    QTest::newRow("finite-difference") << true;
+}
+
+void TestNewton::benchmarkNewtonDerivative()
+{
+    QFETCH(bool, useFiniteDifference);
+
+    struct Problem { const char* equation; double guess; double root; };
+    const Problem problems[] = {
+        {"x^2 - 2", 1.0, qSqrt(2.0)},
+        {"x^3 - 2x - 5", 2.0, 2.0945514815423265},
+        {"cos(x) - x", 1.0, 0.7390851332151607},
+        {"exp(x) - 3x^2", 4.0, 3.7330790286328144},
+        {"x^7 - 1000", 3.0, std::pow(1000.0, 1.0 / 7.0)}
+    };
+
+    QVector<Expression> programs;
+    for (const Problem& p : problems) {
+        programs.append(Expression::compile(p.equation));
+    }
+
+    // Итераций в секунду и точность сходимости
+    qint64 iterations = 0;
+    double maxError = 0.0;
+    const BenchmarkResult measured = measureBenchmark([&]() {
+        for (int i = 0; i < programs.size(); ++i) {
+            double root;
+            iterations += newtonIterations(programs[i], problems[i].guess, useFiniteDifference, root);
+            maxError = qMax(maxError, qAbs(root - problems[i].root) / problems[i].root);
+        }
+    });
+
+    reportRate(useFiniteDifference ? "Конечные разности" : "Дуальные числа", "итераций/с",
+               double(iterations) / measured.iterations, {{QString(), measured}});
+    qInfo() << "Максимальная относительная ошибка корня" << maxError;
+    QVERIFY(iterations > 0);
+    QVERIFY(maxError < 1e-8);
+}
+
+void TestNewton::testBatchMatchesScalar()
+{
+    RootBatch batch = randomRootBatch(10000, 42);
+    RootBatch reference = batch;
+
+    solveRootsBatch(batch);
+    solveRootsScalar(reference);
+
+    for (int i = 0; i < batch.size(); ++i) {
+        const double expected = reference.roots[i];
+        QVERIFY2(qAbs(batch.roots[i] - expected) <= 1e-9 * qMax(1.0, qAbs(expected)),
+                 qPrintable(QString("%1^(1/%2): %3 против %4").arg(batch.numbers[i])
+                            .arg(batch.powers[i]).arg(batch.roots[i]).arg(expected)));
+        QVERIFY(batch.iterations[i] >= 0 && batch.iterations[i] <= 100);
+    }
+
+    // Скалярный путь пакетного решателя даёт те же результаты
+    setSimdEnabled(false);
+    RootBatch scalar = randomRootBatch(1000, 42);
+    solveRootsBatch(scalar);
+    setSimdEnabled(true);
+    for (int i = 0; i < scalar.size(); ++i) {
+        QCOMPARE(scalar.roots[i], reference.roots[i]);
+        QCOMPARE(scalar.iterations[i], reference.iterations[i]);
+    }
+}
+
+void TestNewton::benchmarkBatchRoots()
+{
+    const int count = 1 << 20;
+    RootBatch batch = randomRootBatch(count, 7);
+    RootBatch reference = batch;
+
+    const BenchmarkResult scalar = measureOnce([&]() { solveRootsScalar(reference); });
+    RootBatchStats stats;
+    const BenchmarkResult batched = measureBenchmark([&]() { stats = solveRootsBatch(batch); });
+
+    reportRate(QString("%1 потоков, AVX2 %2").arg(stats.threads).arg(stats.simd ? "да" : "нет"), "корней/с", count,
+               {{"скалярный цикл", scalar}, {"пакетный решатель", batched}});
+    qInfo() << "Ускорение:" << scalar.nsPerIteration() / qMax(1.0, batched.nsPerIteration());
+    qInfo() << "Итераций на задачу: в среднем" << double(stats.totalIterations) / count
+            << ", максимум" << stats.maxIterations;
+
+    QVERIFY(stats.totalIterations > 0);
+}
+
+void TestNewton::testSpecializedPowersMatchGeneric()
+{
+    // Специализированные ядра дают тот же корень и то же число итераций,
+    // что и общий путь через std::pow
+    Newton newton;
+    const double numbers[] = {2.0, 27.0, 100.0, 1000.0};
+    for (int power = 2; power <= Newton::MAX_SPECIALIZED_POWER; ++power) {
+        for (double number : numbers) {
+            int fastIterations = 0;
+            int genericIterations = 0;
+            const double fast = newton.calculateRoot(number, power, &fastIterations);
+            const double generic = newton.calculateRootGeneric(number, power, &genericIterations);
+            QVERIFY2(qAbs(fast - generic) <= 1e-12 * generic,
+                     qPrintable(QString("power %1, number %2").arg(power).arg(number)));
+            QCOMPARE(fastIterations, genericIterations);
+            QVERIFY(qAbs(fast - std::pow(number, 1.0 / power)) < 1e-9);
+        }
+    }
+}
+
+void TestNewton::benchmarkRootByPower_data()
+{
+    QTest::addColumn<int>("power");
+    for (int power = 2; power <= Newton::MAX_SPECIALIZED_POWER; ++power) {
+        QTest::newRow(qPrintable(QString("n=%1").arg(power))) << power;
+    }
+    // Степень выше MAX_SPECIALIZED_POWER идёт общим путём
+    QTest::newRow("n=20 (generic)") << 20;
+}
+
+void TestNewton::benchmarkRootByPower()
+{
+    QFETCH(int, power);
+
+    Newton newton;
+    const int count = 20000;
+    qint64 totalIterations = 0;
+    double sum = 0.0;
+
+    // Общий путь делает столько же итераций (testSpecializedPowersMatchGeneric)
+    for (int i = 0; i < count; ++i) {
+        int used = 0;
+        sum += newton.calculateRoot(1.0 + i * 0.37, power, &used);
+        totalIterations += used;
+    }
+
+    const BenchmarkResult generic = measureOnce([&]() {
+        for (int i = 0; i < count; ++i) {
+            sum += newton.calculateRootGeneric(1.0 + i * 0.37, power);
+        }
+    });
+    const BenchmarkResult fast = measureBenchmark([&]() {
+        for (int i = 0; i < count; ++i) {
+            sum += newton.calculateRoot(1.0 + i * 0.37, power);
+        }
+    });
+
+    reportRate(QString("n = %1").arg(power), "итераций/с", totalIterations,
+               {{QString(), fast}, {"общий путь", generic}});
+    QVERIFY(sum > 0.0);
+}
+
+void TestNewton::testInitialGuessConvergence()
+{
+    // Числа от 1e-300 до 1e300: приближение по показателю даёт сходимость
+    // за несколько итераций при любом порядке числа, в том числе меньше 1
+    RootIterationStats::instance().reset();
+    QRandomGenerator random(11);
+    Newton newton;
+    for (int i = 0; i < 20000; ++i) {
+        const double number = std::pow(10.0, random.generateDouble() * 600.0 - 300.0);
+        const int power = 2 + random.bounded(Newton::MAX_SPECIALIZED_POWER + 4);
+        const double root = newton.calculateRoot(number, power);
+        const double expected = std::pow(number, 1.0 / power);
+        QVERIFY2(qAbs(root - expected) <= 1e-9 * expected,
+                 qPrintable(QString("number %1, power %2").arg(number).arg(power)));
+    }
+
+    const RootIterationHistogram histogram = RootIterationStats::instance().histogram();
+    QCOMPARE(histogram.total(), quint64(20000));
+    QVERIFY(histogram.percentile(0.99) <= 5);
+    qInfo() << "Решений за 3-5 итераций:" << histogram.fractionWithin(3, 5)
+            << ", 99-й перцентиль:" << histogram.percentile(0.99);
+
+    // Отрицательное число: нечётная степень даёт отрицательный корень
+    QVERIFY(qAbs(newton.calculateRoot(-0.001, 3) + 0.1) < 1e-12);
+    QVERIFY(qIsNaN(newton.calculateRoot(-0.001, 2)));
+}
+
+void TestNewton::testExactPerfectPowers()
+{
+    // Точные целые степени возвращаются точным целым без итераций
+    Newton newton;
+    int iterations = -1;
+    QCOMPARE(newton.calculateRoot(27.0, 3, &iterations), 3.0);
+    QCOMPARE(iterations, 0);
+    QCOMPARE(newton.calculateRoot(1e6, 6, &iterations), 10.0);
+    QCOMPARE(newton.calculateRoot(-32.0, 5, &iterations), -2.0);
+    QCOMPARE(newton.calculateRoot(99980001.0, 2), 9999.0);
+    QCOMPARE(newton.calculateRoot(std::pow(3.0, 33), 11), 27.0);
+
+    // Пакетный решатель использует тот же путь
+    RootBatch batch;
+    batch.resize(2);
+    batch.numbers[0] = 4096.0;
+    batch.powers[0] = 12;
+    batch.numbers[1] = 1e-300;
+    batch.powers[1] = 3;
+    solveRootsBatch(batch);
+    QCOMPARE(batch.roots[0], 2.0);
+    QCOMPARE(batch.iterations[0], 0);
+    QVERIFY(qAbs(batch.roots[1] - 1e-100) < 1e-109);
+}
+
+void TestNewton::testFindAllRoots_data()
+{
+    QTest::addColumn<QString>("equation");
+    QTest::addColumn<double>("a");
+    QTest::addColumn<double>("b");
+    QTest::addColumn<QVector<double>>("expected");
+
+    QTest::newRow("sine") << "sin(x)" << -1.0 << 10.0 << QVector<double>{0.0, M_PI, 2 * M_PI, 3 * M_PI};
+    QTest::newRow("grid point") << "x^3 - x" << -2.0 << 2.0 << QVector<double>{-1.0, 0.0, 1.0};
+    QTest::newRow("double root") << "(x - 0.5)^2" << 0.0 << 1.0 << QVector<double>{0.5};
+    QTest::newRow("close pair") << "(x - 1)(x - 1.00001)" << 0.0 << 2.0 << QVector<double>{1.0, 1.00001};
+    QTest::newRow("no roots") << "x^2 + 1" << -5.0 << 5.0 << QVector<double>();
+    QTest::newRow("degree 20") << productPolynomial(20) << 0.0 << 2.05
+                               << QVector<double>{0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9, 1.0,
+                                                  1.1, 1.2, 1.3, 1.4, 1.5, 1.6, 1.7, 1.8, 1.9, 2.0};
+    QTest::newRow("pole") << "1/x" << -1.0 << 1.0 << QVector<double>();
+    QTest::newRow("off-grid pole") << "1/(x - 0.3)" << -1.0 << 1.0 << QVector<double>();
+    QTest::newRow("root and pole") << "1/(x - 0.5) + 1" << -1.0 << 1.0 << QVector<double>{-0.5};
+    QTest::newRow("tangent poles") << "tan(x)" << -2.0 << 2.0 << QVector<double>{0.0};
+    QTest::newRow("log domain") << "log(x)" << -1.0 << 2.0 << QVector<double>{1.0};
+    QTest::newRow("sqrt domain") << "sqrt(x) - 0.5" << -1.0 << 1.0 << QVector<double>{0.25};
+}
+
+void TestNewton::testFindAllRoots()
+{
+    QFETCH(QString, equation);
+    QFETCH(double, a);
+    QFETCH(double, b);
+    QFETCH(QVector<double>, expected);
+
+    RootScanResult result = findAllRoots(equation, a, b);
+    for (double root : result.roots) {
+        QVERIFY(std::isfinite(root));
+    }
+    QVERIFY(std::is_sorted(result.roots.begin(), result.roots.end()));
+    QCOMPARE(result.roots.size(), expected.size());
+    for (int i = 0; i < expected.size(); ++i) {
+        QVERIFY2(qAbs(result.roots[i] - expected[i]) < 1e-9,
+                 qPrintable(QString("root %1: %2").arg(i).arg(result.roots[i], 0, 'g', 17)));
+    }
+}
+
+void TestNewton::benchmarkFindAllRoots_data()
+{
+    QTest::addColumn<int>("degree");
+    QTest::newRow("degree 5") << 5;
+    QTest::newRow("degree 10") << 10;
+    QTest::newRow("degree 20") << 20;
+    QTest::newRow("degree 50") << 50;
+}
+
+void TestNewton::benchmarkFindAllRoots()
+{
+    QFETCH(int, degree);
+
+    std::shared_ptr<const Expression> f = ExpressionCache::instance().get(productPolynomial(degree));
+    const double b = degree / 10.0 + 0.05;
+
+    RootScanOptions single;
+    single.maxThreads = 1;
+    RootScanResult sequential;
+    const BenchmarkResult singleTime = measureOnce([&]() { sequential = findAllRoots(*f, 0.0, b, single); });
+
+    RootScanResult result;
+    const BenchmarkResult parallelTime = measureBenchmark([&]() { result = findAllRoots(*f, 0.0, b); });
+
+    QCOMPARE(result.roots.size(), degree);
+    QCOMPARE(result.roots, sequential.roots);
+    reportRate(QString("Степень %1, потоков %2").arg(degree).arg(result.threads), "поисков/с", 1.0,
+               {{QString(), parallelTime}, {"один поток", singleTime}});
+    qInfo() << "Вычислений f:" << result.evaluations << ", скобок:" << result.brackets;
+}
+
+void TestNewton::testPolynomialRoots()
+{
+    // (x-1)(x-2)(x-3) = x^3 - 6x^2 + 11x - 6
+    PolynomialRoots roots = findPolynomialRoots({-6.0, 11.0, -6.0, 1.0});
+    QVERIFY(roots.converged);
+    QCOMPARE(roots.size(), 3);
+    QVector<double> real;
+    for (int i = 0; i < roots.size(); ++i) {
+        QVERIFY(qAbs(roots.im[i]) < 1e-12);
+        real << roots.re[i];
+    }
+    std::sort(real.begin(), real.end());
+    for (int i = 0; i < 3; ++i) {
+        QVERIFY(qAbs(real[i] - (i + 1)) < 1e-12);
+    }
+
+    // x^2 + 1: пара комплексно сопряжённых корней ±i
+    roots = findPolynomialRoots({1.0, 0.0, 1.0});
+    QCOMPARE(roots.size(), 2);
+    QVERIFY(qAbs(roots.re[0]) < 1e-12 && qAbs(roots.re[1]) < 1e-12);
+    QVERIFY(qAbs(roots.im[0] + roots.im[1]) < 1e-12 && qAbs(qAbs(roots.im[0]) - 1.0) < 1e-12);
+
+    // x^3 + x^2: двойной корень в нуле отделяется без итераций
+    roots = findPolynomialRoots({0.0, 0.0, 1.0, 1.0, 0.0});
+    QCOMPARE(roots.size(), 3);
+    QVERIFY(polynomialBackwardError({0.0, 0.0, 1.0, 1.0}, roots) < 1e-15);
+}
+
+void TestNewton::testPolynomialRootsAccuracy_data()
+{
+    QTest::addColumn<int>("degree");
+    QTest::addColumn<bool>("unity");
+
+    const int degrees[] = {10, 50, 100, 200};
+    for (int degree : degrees) {
+        QTest::newRow(qPrintable(QString("x^%1 - 1").arg(degree))) << degree << true;
+        QTest::newRow(qPrintable(QString("random %1").arg(degree))) << degree << false;
+    }
+}
+
+void TestNewton::testPolynomialRootsAccuracy()
+{
+    QFETCH(int, degree);
+    QFETCH(bool, unity);
+
+    QRandomGenerator random(degree);
+    QVector<double> coefficients;
+    if (unity) {
+        coefficients.fill(0.0, degree + 1);
+        coefficients[0] = -1.0;
+        coefficients[degree] = 1.0;
+    } else {
+        coefficients = randomPolynomial(degree, random);
+    }
+
+    PolynomialRoots roots = findPolynomialRoots(coefficients);
+    QVERIFY(roots.converged);
+    QCOMPARE(roots.size(), degree);
+    QVERIFY(polynomialBackwardError(coefficients, roots) < 1e-12);
+
+    if (unity) {
+        // Корни из единицы лежат на единичной окружности
+        for (int i = 0; i < degree; ++i) {
+            QVERIFY(qAbs(std::hypot(roots.re[i], roots.im[i]) - 1.0) < 1e-12);
+        }
+    }
+}
+
+void TestNewton::benchmarkPolynomialBatch_data()
+{
+    QTest::addColumn<int>("degree");
+    QTest::addColumn<int>("count");
+    QTest::newRow("degree 20") << 20 << 2000;
+    QTest::newRow("degree 50") << 50 << 500;
+    QTest::newRow("degree 200") << 200 << 50;
+}
+
+void TestNewton::benchmarkPolynomialBatch()
+{
+    QFETCH(int, degree);
+    QFETCH(int, count);
+
+    QRandomGenerator random(17);
+    PolynomialBatch batch;
+    for (int i = 0; i < count; ++i) {
+        batch.coefficients << randomPolynomial(degree, random);
+    }
+
+    PolynomialBatch single = batch;
+    const BenchmarkResult singleTime = measureOnce([&]() { solvePolynomialBatch(single, 1); });
+
+    PolynomialBatchStats stats;
+    const BenchmarkResult parallelTime = measureBenchmark([&]() { stats = solvePolynomialBatch(batch); });
+
+    QCOMPARE(stats.failed, 0);
+    QCOMPARE(stats.totalRoots, qint64(degree) * count);
+    reportRate(QString("Степень %1, потоков %2").arg(degree).arg(stats.threads), "корней/с", double(degree) * count,
+               {{QString(), parallelTime}, {"один поток", singleTime}});
+}
+
+void TestNewton::testJetDerivatives()
+{
+    Expression f = Expression::compile("x^3 sin(x) + exp(2x) + log(x) + sqrt(x) + x^2.5 + 1/(1 + x)");
+
+    double maxError = 0.0;
+    for (double x = 0.25; x < 3.0; x += 0.25) {
+        const double s = qSin(x);
+        const double c = qCos(x);
+        const double e = qExp(2 * x);
+        const double d1 = 3 * x * x * s + x * x * x * c + 2 * e + 1 / x + 0.5 * std::pow(x, -0.5)
+                + 2.5 * std::pow(x, 1.5) - 1 / ((1 + x) * (1 + x));
+        const double d2 = 6 * x * s + 6 * x * x * c - x * x * x * s + 4 * e - 1 / (x * x)
+                - 0.25 * std::pow(x, -1.5) + 3.75 * std::pow(x, 0.5) + 2 / std::pow(1 + x, 3);
+        const double d3 = 6 * s + 18 * x * c - 9 * x * x * s - x * x * x * c + 8 * e + 2 / (x * x * x)
+                + 0.375 * std::pow(x, -2.5) + 1.875 * std::pow(x, -0.5) - 6 / std::pow(1 + x, 4);
+
+        Jet<3> y = f.evaluate(Jet<3>::variable(x));
+        QVERIFY(qAbs(y.value() - f.evaluate(x)) <= 1e-14 * qAbs(y.value()));
+        maxError = qMax(maxError, qAbs(y.derivative(1) - d1) / qAbs(d1));
+        maxError = qMax(maxError, qAbs(y.derivative(2) - d2) / qAbs(d2));
+        maxError = qMax(maxError, qAbs(y.derivative(3) - d3) / qAbs(d3));
+
+        // Ряд второго порядка совпадает с началом ряда третьего
+        Jet<2> z = f.evaluate(Jet<2>::variable(x));
+        QCOMPARE(z.derivative(2), y.derivative(2));
+    }
+    QVERIFY2(maxError < 1e-12, qPrintable(QString::number(maxError)));
+}
+
+void TestNewton::testHigherOrderMethods_data()
+{
+    QTest::addColumn<QString>("equation");
+    QTest::addColumn<double>("initialGuess");
+    QTest::addColumn<double>("expected");
+
+    QTest::newRow("sqrt2") << "x^2 - 2" << 1.0 << qSqrt(2.0);
+    QTest::newRow("cubic") << "x^3 - 2x - 5" << 2.0 << 2.0945514815423265;
+    QTest::newRow("cosine") << "cos(x) - x" << 1.0 << 0.7390851332151607;
+    QTest::newRow("lambert") << "x exp(x) - 1" << 1.0 << 0.5671432904097838;
+    QTest::newRow("logarithm") << "log(x) - 1" << 2.0 << M_E;
+    QTest::newRow("power 10") << "x^10 - 1" << 1.5 << 1.0;
+    QTest::newRow("real power") << "x^2.5 - 7" << 2.0 << std::pow(7.0, 0.4);
+}
+
+void TestNewton::testHigherOrderMethods()
+{
+    QFETCH(QString, equation);
+    QFETCH(double, initialGuess);
+    QFETCH(double, expected);
+
+    std::shared_ptr<const Expression> f = ExpressionCache::instance().get(equation);
+    EquationSolution newton = solveEquation(*f, initialGuess, 1e-12, RootMethod::Newton);
+    EquationSolution halley = solveEquation(*f, initialGuess, 1e-12, RootMethod::Halley);
+    EquationSolution householder = solveEquation(*f, initialGuess, 1e-12, RootMethod::Householder3);
+
+    QVERIFY(newton.converged && halley.converged && householder.converged);
+    QVERIFY(qAbs(newton.root - expected) < 1e-10);
+    QVERIFY(qAbs(halley.root - expected) < 1e-10);
+    QVERIFY(qAbs(householder.root - expected) < 1e-10);
+
+    // Методы высших порядков не требуют больше вычислений, чем Ньютон
+    QVERIFY(halley.evaluations <= newton.evaluations);
+    QVERIFY(householder.evaluations <= halley.evaluations);
+
+    // Тот же выбор метода доступен через строковый интерфейс задачи 2
+    RootMethod method;
+    QVERIFY(parseRootMethod("Halley", method));
+    QCOMPARE(solveNewton(equation, initialGuess, 1e-9, method), QString::number(expected, 'f', 6));
+    QVERIFY(!parseRootMethod("secant", method));
+}
+
+void TestNewton::testSquareRootMethods()
+{
+    // Квадратный корень задачи 2 считается без разбора текста уравнения
+    const RootMethod methods[] = {RootMethod::Newton, RootMethod::Halley, RootMethod::Householder3};
+    for (RootMethod method : methods) {
+        for (double number : {0.25, 2.0, 49.0, 1e6}) {
+            EquationSolution solution = solveSquareRoot(number, 1e-12, method);
+            QVERIFY(solution.converged && solution.error.isEmpty());
+            QVERIFY(qAbs(solution.root - std::sqrt(number)) < 1e-10 * qMax(1.0, std::sqrt(number)));
+        }
+
+        // Любой порядок числа: шаг сравнивается относительно корня, x^2 не переполняется
+        QRandomGenerator random(35);
+        QVector<double> numbers = {1e15, 1e100, 1e200, std::numeric_limits<double>::max(),
+                                   std::numeric_limits<double>::min(), std::numeric_limits<double>::denorm_min()};
+        for (int exponent = -1070; exponent <= 1020; exponent += 10) {
+            numbers.append(std::ldexp(1.0 + random.generateDouble(), exponent));
+        }
+        for (int i = 0; i < 1000; ++i) {
+            numbers.append(std::pow(10.0, 7.0 + 5.0 * random.generateDouble()));
+        }
+        for (double number : numbers) {
+            EquationSolution solution = solveSquareRoot(number, 1e-12, method);
+            QVERIFY2(solution.converged && solution.error.isEmpty(), qPrintable(QString::number(number)));
+            QVERIFY(qAbs(solution.root - std::sqrt(number)) <= 1e-15 * std::sqrt(number));
+        }
+
+        // Бесконечность, NaN и отрицательное число — ошибка, а не «корень»
+        const double invalid[] = {std::numeric_limits<double>::infinity(),
+                                  std::numeric_limits<double>::quiet_NaN(), -4.0};
+        for (double number : invalid) {
+            EquationSolution solution = solveSquareRoot(number, 1e-12, method);
+            QVERIFY(!solution.converged);
+            QVERIFY(!solution.error.isEmpty());
+        }
+    }
+}
+
+void TestNewton::benchmarkRootMethods_data()
+{
+    QTest::addColumn<int>("method");
+    QTest::newRow("newton") << int(RootMethod::Newton);
+    QTest::newRow("halley") << int(RootMethod::Halley);
+    QTest::newRow("householder") << int(RootMethod::Householder3);
+}
+
+void TestNewton::benchmarkRootMethods()
+{
+    QFETCH(int, method);
+
+    // Стандартный набор: полиномы, трансцендентные уравнения, вещественная степень
+    struct Problem {
+        const char* equation;
+        double initialGuess;
+    };
+    const Problem suite[] = {
+        {"x^2 - 2", 1.0}, {"x^3 - 2x - 5", 2.0}, {"cos(x) - x", 1.0}, {"exp(x) - 3", 1.0},
+        {"x exp(x) - 1", 1.0}, {"log(x) - 1", 2.0}, {"x^10 - 1", 1.5}, {"sin(x) - 0.5", 0.0},
+        {"sqrt(x) - 3", 5.0}, {"x^2.5 - 7", 2.0}
+    };
+    const int problems = sizeof(suite) / sizeof(suite[0]);
+
+    QVector<std::shared_ptr<const Expression>> programs;
+    for (const Problem& problem : suite) {
+        programs << ExpressionCache::instance().get(problem.equation);
+    }
+
+    int evaluations = 0;
+    const BenchmarkResult measured = measureBenchmark([&]() {
+        evaluations = 0;
+        for (int i = 0; i < problems; ++i) {
+            EquationSolution solution = solveEquation(*programs[i], suite[i].initialGuess, 1e-12, RootMethod(method));
+            evaluations += solution.evaluations;
+        }
+    });
+
+    qInfo() << rootMethodName(RootMethod(method)) << ": вычислений до точности 1e-12"
+            << evaluations << "на" << problems << "задач," << measured.nsPerIteration() / problems << "нс на задачу";
+    QVERIFY(evaluations > 0);
+}
+
+void TestNewton::testLuDecompose()
+{
+    // Размеры по обе стороны от ширины панели блочного разложения
+    QRandomGenerator random(5);
+    const int sizes[] = {1, 3, LU_BLOCK_SIZE, LU_BLOCK_SIZE + 1, 40, 64};
+    for (int n : sizes) {
+        QVector<double> a(n * n);
+        QVector<double> b(n);
+        for (double& v : a) {
+            v = random.generateDouble() * 2.0 - 1.0;
+        }
+        for (double& v : b) {
+            v = random.generateDouble() * 2.0 - 1.0;
+        }
+
+        QVector<double> lu = a;
+        QVector<double> x = b;
+        QVector<int> pivots(n);
+        QVERIFY(luDecompose(lu.data(), n, pivots.data()));
+        luSolve(lu.constData(), n, pivots.constData(), x.data());
+
+        for (int i = 0; i < n; ++i) {
+            double residual = -b[i];
+            for (int j = 0; j < n; ++j) {
+                residual += a[i * n + j] * x[j];
+            }
+            QVERIFY2(qAbs(residual) < 1e-9, qPrintable(QString("n = %1").arg(n)));
+        }
+    }
+
+    // Вырожденная матрица
+    double singular[4] = {1.0, 2.0, 2.0, 4.0};
+    int pivots[2];
+    QVERIFY(!luDecompose(singular, 2, pivots));
+}
+
+void TestNewton::testNewtonSystem()
+{
+    // x² + y² = 4, x = y
+    NewtonSystemSolver solver(2);
+    double x[2] = {1.0, 0.5};
+    SystemSolution solution = solver.solve([](const double* v, double* f, double* j) {
+        f[0] = v[0] * v[0] + v[1] * v[1] - 4.0;
+        f[1] = v[0] - v[1];
+        j[0] = 2 * v[0];
+        j[1] = 2 * v[1];
+        j[2] = 1.0;
+        j[3] = -1.0;
+    }, x);
+    QVERIFY(solution.converged);
+    QVERIFY(qAbs(x[0] - qSqrt(2.0)) < 1e-12 && qAbs(x[1] - qSqrt(2.0)) < 1e-12);
+
+    // Та же система размера 32 с аналитическим якобианом и конечными разностями
+    const int n = 32;
+    NewtonSystemSolver large(n);
+    QVector<double> analytic(n, 0.0);
+    QVector<double> numeric(n, 0.0);
+    solution = large.solve([n](const double* v, double* f, double* j) {
+        denseTestSystem(n, v, f, j);
+    }, analytic.data());
+    QVERIFY(solution.converged);
+    solution = large.solveWithFiniteDifferences([n](const double* v, double* f) {
+        denseTestSystem(n, v, f, nullptr);
+    }, numeric.data());
+    QVERIFY(solution.converged);
+    for (int i = 0; i < n; ++i) {
+        QVERIFY(qAbs(analytic[i] - 1.0) < 1e-10);
+        QVERIFY(qAbs(numeric[i] - 1.0) < 1e-10);
+    }
+
+    // Вырожденный якобиан
+    solution = solver.solve([](const double* v, double* f, double* j) {
+        f[0] = v[0] + v[1] - 1.0;
+        f[1] = 2 * v[0] + 2 * v[1] - 3.0;
+        j[0] = 1.0;
+        j[1] = 1.0;
+        j[2] = 2.0;
+        j[3] = 2.0;
+    }, x);
+    QVERIFY(!solution.converged);
+    QCOMPARE(solution.error, QString("Singular Jacobian"));
+}
+
+void TestNewton::benchmarkNewtonSystem_data()
+{
+    QTest::addColumn<int>("n");
+    QTest::newRow("n=2") << 2;
+    QTest::newRow("n=8") << 8;
+    QTest::newRow("n=32") << 32;
+    QTest::newRow("n=64") << 64;
+}
+
+void TestNewton::benchmarkNewtonSystem()
+{
+    QFETCH(int, n);
+
+    const int count = qMax(64, 65536 / (n * n));
+    const BatchSystemFunction function = [n](int, const double* v, double* f, double* j) {
+        denseTestSystem(n, v, f, j);
+    };
+
+    QVector<double> x(count * n, 0.0);
+    const BenchmarkResult singleTime = measureOnce([&]() {
+        solveSystemsBatch(n, count, function, x.data(), nullptr, 1e-10, 1);
+    });
+
+    SystemBatchStats stats;
+    const BenchmarkResult parallelTime = measureBenchmark([&]() {
+        x.fill(0.0);
+        stats = solveSystemsBatch(n, count, function, x.data());
+    });
+
+    QCOMPARE(stats.converged, count);
+    reportRate(QString("n = %1, потоков %2").arg(n).arg(stats.threads), "систем/с", count,
+               {{QString(), parallelTime}, {"один поток", singleTime}});
+    qInfo() << "Итераций на систему" << double(stats.totalIterations) / count;
+}
+
+void TestNewton::testMixedPrecision()
+{
+    // Числа всех порядков, отрицательные для нечётных степеней и степени выше 64
+    QRandomGenerator random(37);
+    RootBatch batch;
+    batch.resize(20000);
+    for (int i = 0; i < batch.size(); ++i) {
+        const int power = i % 10 == 0 ? 65 + random.bounded(40) : 2 + random.bounded(15);
+        double number = std::pow(10.0, random.bounded(600.0) - 300.0);
+        if (power % 2 == 1 && i % 3 == 0) {
+            number = -number;
+        }
+        batch.numbers[i] = number;
+        batch.powers[i] = power;
+    }
+    batch.numbers[0] = 0.0;
+    batch.numbers[1] = 1024.0;
+    batch.powers[1] = 10;
+    batch.numbers[2] = -8.0;
+    batch.powers[2] = 2;
+    batch.numbers[3] = std::numeric_limits<double>::denorm_min();
+    batch.powers[3] = 3;
+
+    RootIterationStats::instance().reset();
+    solveRootsMixed(batch);
+
+    // Каждая задача учтена в гистограмме ровно один раз и с тем же числом итераций
+    const RootIterationHistogram histogram = RootIterationStats::instance().histogram();
+    QCOMPARE(histogram.total(), quint64(batch.size()));
+    QVector<quint64> expectedCounts(histogram.counts.size(), 0);
+    for (int i = 0; i < batch.size(); ++i) {
+        ++expectedCounts[qMin(int(batch.iterations[i]), expectedCounts.size() - 1)];
+    }
+    QCOMPARE(histogram.counts, expectedCounts);
+
+    QCOMPARE(batch.roots[0], 0.0);
+    QCOMPARE(batch.roots[1], 2.0);
+    QVERIFY(qIsNaN(batch.roots[2]));
+    for (int i = 3; i < batch.size(); ++i) {
+        const double number = batch.numbers[i];
+        const double expected = std::copysign(std::pow(qAbs(number), 1.0 / batch.powers[i]), number);
+        QVERIFY2(qAbs(batch.roots[i] - expected) <= 1e-10 * qAbs(expected),
+                 qPrintable(QString("%1^(1/%2): %3 против %4").arg(number)
+                            .arg(batch.powers[i]).arg(batch.roots[i]).arg(expected)));
+    }
+}
+
+void TestNewton::benchmarkMixedPrecision()
+{
+    // Общее число задач задаётся NEWTON_MIXED_COUNT; 10^7 — при BENCHMARK_LARGE
+    const int chunk = 1 << 20;
+    const qint64 total = benchmarkSize("NEWTON_MIXED_COUNT", chunk, 10000000);
+
+    // Время берётся из статистики пакета: в него не входит проверка точности
+    BenchmarkResult doubleTime;
+    BenchmarkResult mixedTime;
+    doubleTime.iterations = mixedTime.iterations = 1;
+    double worstError = 0.0;
+    bool simd = false;
+    for (qint64 done = 0; done < total; done += chunk) {
+        RootBatch mixed = randomRootBatch(int(qMin<qint64>(chunk, total - done)), quint32(done / chunk + 1));
+        RootBatch reference = mixed;
+
+        doubleTime.elapsedNs += solveRootsBatch(reference).elapsedNs;
+        RootBatchStats stats = solveRootsMixed(mixed);
+        mixedTime.elapsedNs += stats.elapsedNs;
+        simd = stats.simd;
+
+        for (int i = 0; i < mixed.size(); ++i) {
+            if (mixed.powers[i] < 2) {
+                continue;
+            }
+            const double expected = std::pow(mixed.numbers[i], 1.0 / mixed.powers[i]);
+            worstError = qMax(worstError, qAbs(mixed.roots[i] - expected) / expected);
+        }
+    }
+
+    reportRate(QString("Задач %1, AVX2 %2").arg(total).arg(simd ? "да" : "нет"), "корней/с", total,
+               {{"double", doubleTime}, {"float + double", mixedTime}});
+    qInfo() << "Ускорение:" << double(doubleTime.elapsedNs) / qMax<qint64>(1, mixedTime.elapsedNs);
+    qInfo() << "Наибольшая относительная ошибка смешанной точности:" << worstError;
+
+    QVERIFY(worstError < 1e-10);
+}
+
 QTEST_APPLESS_MAIN(TestNewton) 
\ No newline at end of file
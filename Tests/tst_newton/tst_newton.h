@@ -4,6 +4,12 @@
 #include <QTest>
 #include <QString>
 #include "newton.h"
+#include "expression.h"
+#include "newtonbatch.h"
+#include "newtonstats.h"
+#include "rootfinder.h"
+#include "polynomial.h"
+#include "newtonsystem.h"
 
 class TestNewton : public QObject
 {
@@ -14,6 +20,42 @@ private slots:
     void testZeroDerivative();
     void testNoRoot();
     void testPerformance();
+    void testSolveNewtonEquation_data();
+    void testSolveNewtonEquation();
+    void testExpressionErrors();
+    void testExpressionCache();
+    void benchmarkExpressionEvaluate();
+    void testDualDerivative();
+    void benchmarkNewtonDerivative_data();
+    void benchmarkNewtonDerivative();
+    void testBatchMatchesScalar();
+    void benchmarkBatchRoots();
+    void testSpecializedPowersMatchGeneric();
+    void benchmarkRootByPower_data();
+    void benchmarkRootByPower();
+    void testInitialGuessConvergence();
+    void testExactPerfectPowers();
+    void testFindAllRoots_data();
+    void testFindAllRoots();
+    void benchmarkFindAllRoots_data();
+    void benchmarkFindAllRoots();
+    void testPolynomialRoots();
+    void testPolynomialRootsAccuracy_data();
+    void testPolynomialRootsAccuracy();
+    void benchmarkPolynomialBatch_data();
+    void benchmarkPolynomialBatch();
+    void testJetDerivatives();
+    void testHigherOrderMethods_data();
+    void testHigherOrderMethods();
+    void testSquareRootMethods();
+    void benchmarkRootMethods_data();
+    void benchmarkRootMethods();
+    void testLuDecompose();
+    void testNewtonSystem();
+    void benchmarkNewtonSystem_data();
+    void benchmarkNewtonSystem();
+    void testMixedPrecision();
+    void benchmarkMixedPrecision();
 };
 
 #endif // TST_NEWTON_H 
\ No newline at end of file
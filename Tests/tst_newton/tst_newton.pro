@@ -7,9 +7,27 @@ CONFIG -= app_bundle
 TEMPLATE = app
 
 INCLUDEPATH += ../../Server
+INCLUDEPATH += ..
 
 SOURCES += tst_newton.cpp \
-    ../../Server/newton.cpp
+    ../../Server/newton.cpp \
+    ../../Server/expression.cpp \
+    ../../Server/newtonbatch.cpp \
+    ../../Server/newtonstats.cpp \
+    ../../Server/rootfinder.cpp \
+    ../../Server/polynomial.cpp \
+    ../../Server/newtonsystem.cpp
 
 HEADERS += tst_newton.h \
-    ../../Server/newton.h 
\ No newline at end of file
+    ../benchmark.h \
+    ../../Server/newton.h \
+    ../../Server/expression.h \
+    ../../Server/dual.h \
+    ../../Server/jet.h \
+    ../../Server/newtonbatch.h \
+    ../../Server/newtonstats.h \
+    ../../Server/rootfinder.h \
+    ../../Server/polynomial.h \
+    ../../Server/newtonsystem.h \
+    ../../Server/cpufeatures.h \
+    ../../Server/parallel.h 
\ No newline at end of file
@@ -1,6 +1,186 @@
 #include "tst_sha1.h"
 #include <QElapsedTimer>
 #include <QDebug>
+#include <QFile>
+#include <QJsonDocument>
+#include "benchmark.h"
+#include "cpufeatures.h"
+
+/*
+ * Бенчмарки хеширования управляются переменными окружения:
+ *   SHA1_BENCH_OUTPUT         — путь к JSON с результатами (без неё файл не пишется)
+ *   SHA1_BENCH_BASELINE       — JSON прошлого запуска для сравнения
+ *   SHA1_BENCH_MAX_REGRESSION — допустимое падение скорости в процентах (по умолчанию 10)
+ *   BENCHMARK_LARGE           — добавляет строки по 64 МиБ
+ * Если базовый файл задан, строка бенчмарка падает, когда её скорость
+ * ниже базовой больше чем на заданный процент.
+ */
+
+namespace {
+
+const int INCREMENTAL_CHUNK = 64 * 1024;
+
+// Минимальное время замера строки бенчмарка, нс
+const qint64 MIN_MEASURE_NS = 200 * 1000 * 1000;
+
+QByteArray benchmarkBytes(int size)
+{
+    QByteArray data(size, Qt::Uninitialized);
+    for (int i = 0; i < size; ++i) {
+        data[i] = char('a' + i % 26);
+    }
+    return data;
+}
+
+QString formatSize(int size)
+{
+    if (size >= 1024 * 1024) {
+        return QString("%1MiB").arg(size / (1024 * 1024));
+    }
+    if (size >= 1024) {
+        return QString("%1KiB").arg(size / 1024);
+    }
+    return QString("%1B").arg(size);
+}
+
+QString hashOnce(const QByteArray& bytes, const QString& text, bool incremental, bool useString)
+{
+    if (!incremental) {
+        return useString ? sha1(text) : sha1Bytes(bytes);
+    }
+
+    Sha1Incremental hasher;
+    if (useString) {
+        for (int pos = 0; pos < text.size(); pos += INCREMENTAL_CHUNK) {
+            hasher.addData(text.mid(pos, INCREMENTAL_CHUNK));
+        }
+    } else {
+        for (int pos = 0; pos < bytes.size(); pos += INCREMENTAL_CHUNK) {
+            hasher.addData(QByteArray::fromRawData(bytes.constData() + pos,
+                                                   qMin(INCREMENTAL_CHUNK, bytes.size() - pos)));
+        }
+    }
+    return hasher.result();
+}
+
+} // namespace
+
+void TestSHA1::initTestCase()
+{
+    bool ok = false;
+    maxRegressionPercent = qEnvironmentVariable("SHA1_BENCH_MAX_REGRESSION").toDouble(&ok);
+    if (!ok) {
+        maxRegressionPercent = 10.0;
+    }
+
+    const QString baselinePath = qEnvironmentVariable("SHA1_BENCH_BASELINE");
+    if (baselinePath.isEmpty()) {
+        return;
+    }
+
+    QFile file(baselinePath);
+    QVERIFY2(file.open(QIODevice::ReadOnly), qPrintable("Не удалось открыть " + baselinePath));
+    const QJsonArray rows = QJsonDocument::fromJson(file.readAll()).object()["results"].toArray();
+    for (const QJsonValue& row : rows) {
+        baseline[row.toObject()["name"].toString()] = row;
+    }
+    qInfo() << "Базовые результаты:" << baseline.size() << "строк, допуск" << maxRegressionPercent << "%";
+}
+
+void TestSHA1::cleanupTestCase()
+{
+    const QString outputPath = qEnvironmentVariable("SHA1_BENCH_OUTPUT");
+    if (outputPath.isEmpty() || benchmarkResults.isEmpty()) {
+        return;
+    }
+
+    QJsonObject root;
+    root["benchmark"] = "sha1";
+    root["results"] = benchmarkResults;
+
+    QFile file(outputPath);
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(QJsonDocument(root).toJson());
+        qInfo() << "Результаты бенчмарков записаны в" << outputPath;
+    } else {
+        qWarning() << "Не удалось записать" << outputPath;
+    }
+}
+
+void TestSHA1::testIncrementalMatchesSingleShot()
+{
+    const QByteArray bytes = benchmarkBytes(3 * INCREMENTAL_CHUNK + 17);
+    const QString text = QString::fromLatin1(bytes);
+
+    QCOMPARE(hashOnce(bytes, text, true, false), sha1Bytes(bytes));
+    QCOMPARE(hashOnce(bytes, text, true, true), sha1(text));
+    QCOMPARE(sha1Bytes(bytes), sha1(text));
+}
+
+void TestSHA1::benchmarkHash_data()
+{
+    QTest::addColumn<int>("size");
+    QTest::addColumn<bool>("incremental");
+    QTest::addColumn<bool>("useString");
+
+    QList<int> sizes = {0, 64, 1024, 64 * 1024, 1024 * 1024};
+    if (largeBenchmarks()) {
+        sizes << 64 * 1024 * 1024;
+    }
+    for (int size : sizes) {
+        for (bool incremental : {false, true}) {
+            for (bool useString : {false, true}) {
+                const QString name = QString("%1/%2/%3")
+                        .arg(formatSize(size),
+                             QString(incremental ? "incremental" : "single"),
+                             QString(useString ? "qstring" : "bytes"));
+                QTest::newRow(qPrintable(name)) << size << incremental << useString;
+            }
+        }
+    }
+}
+
+void TestSHA1::benchmarkHash()
+{
+    QFETCH(int, size);
+    QFETCH(bool, incremental);
+    QFETCH(bool, useString);
+
+    const QByteArray bytes = benchmarkBytes(size);
+    const QString text = useString ? QString::fromLatin1(bytes) : QString();
+    const QString expected = sha1Bytes(bytes);
+
+    QString result;
+    const BenchmarkResult measured = measureBenchmark([&]() {
+        result = hashOnce(bytes, text, incremental, useString);
+    }, MIN_MEASURE_NS);
+    QCOMPARE(result, expected);
+
+    const double opsPerSecond = measured.perSecond();
+    const double mbPerSecond = opsPerSecond * size / (1024.0 * 1024.0);
+    const QString name = QTest::currentDataTag();
+
+    QJsonObject row;
+    row["name"] = name;
+    row["bytes"] = size;
+    row["mode"] = incremental ? "incremental" : "single";
+    row["input"] = useString ? "qstring" : "bytes";
+    row["iterations"] = measured.iterations;
+    row["nsPerOp"] = measured.nsPerIteration();
+    row["opsPerSecond"] = opsPerSecond;
+    row["mbPerSecond"] = mbPerSecond;
+    benchmarkResults.append(row);
+
+    if (baseline.contains(name)) {
+        const double baseOps = baseline[name].toObject()["opsPerSecond"].toDouble();
+        const double limit = baseOps * (1.0 - maxRegressionPercent / 100.0);
+        QVERIFY2(opsPerSecond >= limit,
+                 qPrintable(QString("Падение производительности: %1 оп/с против базовых %2 (допуск %3%)")
+                            .arg(opsPerSecond, 0, 'f', 1)
+                            .arg(baseOps, 0, 'f', 1)
+                            .arg(maxRegressionPercent)));
+    }
+}
 
 void TestSHA1::testEmptyString()
 {
@@ -58,4 +238,82 @@ void TestSHA1::testPerformance()
     QVERIFY(elapsed < 1000); // Проверяем, что хеширование занимает менее 1 секунды
 }
 
+void TestSHA1::testPreimageBruteForce()
+{
+    Sha1PreimageSearch search(sha1("qtx"));
+    QVERIFY(search.isValid());
+    search.setMaxLength(4);
+
+    QVERIFY(search.bruteForce());
+    QCOMPARE(search.result(), QString("qtx"));
+
+    // Пустая строка тоже входит в пространство перебора
+    Sha1PreimageSearch empty("da39a3ee5e6b4b0d3255bfef95601890afd80709");
+    empty.setMaxLength(2);
+    QVERIFY(empty.bruteForce());
+    QCOMPARE(empty.result(), QString());
+
+    // Строки длиннее максимальной не находятся
+    Sha1PreimageSearch tooLong(sha1("hello"));
+    tooLong.setMaxLength(3);
+    QVERIFY(!tooLong.bruteForce());
+    QCOMPARE(tooLong.progress().tested, Sha1PreimageSearch::keyspaceSize(26, 0, 3));
+}
+
+void TestSHA1::testPreimageDictionary()
+{
+    QStringList words = {"hello", "world", "cryptography", "security", "qt"};
+
+    Sha1PreimageSearch search(sha1("Security7"));
+    QVERIFY(search.dictionary(words, Sha1PreimageSearch::AsIs | Sha1PreimageSearch::Capitalize
+                                         | Sha1PreimageSearch::AppendDigit));
+    QCOMPARE(search.result(), QString("Security7"));
+
+    Sha1PreimageSearch leet(sha1("h3ll0"));
+    QVERIFY(leet.dictionary(words, Sha1PreimageSearch::Leet));
+    QCOMPARE(leet.result(), QString("h3ll0"));
+
+    Sha1PreimageSearch missing(sha1("password"));
+    QVERIFY(!missing.dictionary(words, Sha1PreimageSearch::AllRules));
+}
+
+void TestSHA1::testPreimageSimdMatchesScalar()
+{
+    if (!cpuHasAvx2()) {
+        QSKIP("AVX2 недоступен");
+    }
+
+    const QString target = sha1("zzzz");
+
+    Sha1PreimageSearch simd(target);
+    simd.setMaxLength(4);
+    QVERIFY(simd.bruteForce());
+
+    setSimdEnabled(false);
+    Sha1PreimageSearch scalar(target);
+    scalar.setMaxLength(4);
+    bool scalarFound = scalar.bruteForce();
+    setSimdEnabled(true);
+
+    QVERIFY(scalarFound);
+    QCOMPARE(simd.result(), scalar.result());
+}
+
+void TestSHA1::benchmarkPreimageSearch()
+{
+    // Хеш вне пространства перебора: проходим все 26^5 строк длины 5
+    Sha1PreimageSearch search(sha1("not in keyspace"));
+    search.setMinLength(5);
+    search.setMaxLength(5);
+
+    QVERIFY(!search.bruteForce());
+
+    Sha1SearchProgress p = search.progress();
+    QCOMPARE(p.tested, Sha1PreimageSearch::keyspaceSize(26, 5, 5));
+    qInfo() << "SHA1 перебор:" << p.tested << "хешей за" << p.elapsedMs << "мс,"
+            << qRound64(p.hashesPerSecond) << "хешей/с,"
+            << qRound64(p.hashesPerSecondPerCore()) << "хешей/с на ядро,"
+            << p.threads << "потоков, AVX2:" << Sha1PreimageSearch::simdAvailable();
+}
+
 QTEST_APPLESS_MAIN(TestSHA1) 
\ No newline at end of file
@@ -3,13 +3,22 @@
 
 #include <QTest>
 #include <QString>
+#include <QJsonArray>
+#include <QJsonObject>
 #include "sha1.h"
+#include "sha1search.h"
 
 class TestSHA1 : public QObject
 {
     Q_OBJECT
 
 private slots:
+    // Загрузка базовых результатов бенчмарков
+    void initTestCase();
+
+    // Запись результатов бенчмарков в JSON
+    void cleanupTestCase();
+
     // Тест пустой строки
     void testEmptyString();
     
@@ -24,6 +33,30 @@ private slots:
     
     // Тест производительности
     void testPerformance();
+
+    // Тест совпадения инкрементального и однократного хеширования
+    void testIncrementalMatchesSingleShot();
+
+    // Бенчмарк хеширования: размеры, режимы и типы входа
+    void benchmarkHash_data();
+    void benchmarkHash();
+
+    // Тест полного перебора прообраза
+    void testPreimageBruteForce();
+
+    // Тест словарной атаки с правилами
+    void testPreimageDictionary();
+
+    // Тест совпадения векторного и скалярного ядер
+    void testPreimageSimdMatchesScalar();
+
+    // Бенчмарк перебора: хешей в секунду на ядро
+    void benchmarkPreimageSearch();
+
+private:
+    QJsonArray benchmarkResults;   ///< Результаты для JSON-файла
+    QJsonObject baseline;          ///< Базовые результаты по имени строки данных
+    double maxRegressionPercent;   ///< Допустимое падение производительности, %
 };
 
 #endif // TST_SHA1_H 
\ No newline at end of file
@@ -7,9 +7,15 @@ CONFIG -= app_bundle
 TEMPLATE = app
 
 INCLUDEPATH += ../../Server
+INCLUDEPATH += ..
 
 SOURCES += tst_sha1.cpp \
-    ../../Server/sha1.cpp
+    ../../Server/sha1.cpp \
+    ../../Server/sha1search.cpp
 
 HEADERS += tst_sha1.h \
-    ../../Server/sha1.h 
\ No newline at end of file
+    ../benchmark.h \
+    ../../Server/sha1.h \
+    ../../Server/sha1search.h \
+    ../../Server/cpufeatures.h \
+    ../../Server/parallel.h 
\ No newline at end of file
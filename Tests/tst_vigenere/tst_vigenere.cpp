@@ -1,6 +1,11 @@
 #include "tst_vigenere.h"
 #include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QRandomGenerator>
 #include <QtTest>
+#include "benchmark.h"
+#include "cpufeatures.h"
 
 void TestVigenere::testSimpleEncryption()
 {
@@ -64,4 +69,512 @@ void TestVigenere::testPerformance()
     QVERIFY(elapsed < 100); // Проверяем, что шифрование и дешифрование занимают менее 100 мс
 }
 
+void TestVigenere::testSimdMatchesScalar()
+{
+    // Латиница, знаки, кириллица и буквы Latin-1: блоки с символами
+    // вне ASCII проходят скалярный путь внутри векторного цикла
+    QRandomGenerator random(38);
+    const QString alphabet = QString::fromUtf8("ABCXYZabcxyz ,.!09@[`{");
+    const QString extra = QString::fromUtf8("éЖ");
+    QString text;
+    for (int i = 0; i < 5000; ++i) {
+        text.append(random.bounded(100) < 98 ? alphabet[int(random.bounded(alphabet.size()))]
+                                            : extra[int(random.bounded(extra.size()))]);
+    }
+    const QStringList keys = {"KEY", "lemon", "ThisIsAVeryLongKeyThatShouldWorkFine", "A", "key2"};
+
+    Vigenere vigenere;
+    for (const QString& key : keys) {
+        for (int length : {0, 7, 15, 16, 17, 33, 1000, 5000}) {
+            const QString part = text.left(length);
+            setSimdEnabled(false);
+            const QString classEncrypted = vigenere.encrypt(part, key);
+            const QString classDecrypted = vigenere.decrypt(part, key);
+            const QString encrypted = encryptVigenere(part, key);
+            const QString decrypted = decryptVigenere(part, key);
+            setSimdEnabled(true);
+            QCOMPARE(vigenere.encrypt(part, key), classEncrypted);
+            QCOMPARE(vigenere.decrypt(part, key), classDecrypted);
+            QCOMPARE(encryptVigenere(part, key), encrypted);
+            QCOMPARE(decryptVigenere(part, key), decrypted);
+        }
+    }
+
+    // Текст только из ASCII расшифровывается обратно
+    const QString ascii = QString("Attack at dawn, retreat at dusk! ").repeated(40);
+    QCOMPARE(vigenere.decrypt(vigenere.encrypt(ascii, "LEMON"), "LEMON"), ascii);
+    QCOMPARE(decryptVigenere(encryptVigenere(ascii, "LEMON"), "LEMON"), ascii);
+
+    // Пустой ключ не меняет текст
+    QCOMPARE(vigenere.encrypt(ascii, QString()), ascii);
+    QCOMPARE(encryptVigenere(ascii, QString()), ascii);
+}
+
+void TestVigenere::benchmarkEncrypt_data()
+{
+    QTest::addColumn<int>("bytes");
+    QTest::newRow("1 KB") << 1024;
+    QTest::newRow("64 KB") << 64 * 1024;
+    QTest::newRow("1 MB") << 1024 * 1024;
+    if (largeBenchmarks()) {
+        // Текст, шифротекст и эталон — около 300 МБ памяти
+        QTest::newRow("100 MB") << 100 * 1024 * 1024;
+    }
+}
+
+void TestVigenere::benchmarkEncrypt()
+{
+    QFETCH(int, bytes);
+
+    // Текст на английском: буквы с пробелами и знаками препинания
+    const QString sentence = "The quick brown fox jumps over the lazy dog, again and again. ";
+    const int length = bytes / int(sizeof(QChar));
+    QString text = sentence.repeated(length / sentence.size() + 1);
+    text.truncate(length);
+    const QString key = "LEMON";
+
+    Vigenere vigenere;
+    QString scalar;
+    setSimdEnabled(false);
+    const BenchmarkResult scalarTime = measureOnce([&]() { scalar = vigenere.encrypt(text, key); });
+    setSimdEnabled(true);
+
+    QString encrypted;
+    const BenchmarkResult simdTime = measureBenchmark([&]() { encrypted = vigenere.encrypt(text, key); });
+
+    QCOMPARE(encrypted, scalar);
+    reportThroughput(QString("%1 КБ, AVX2 %2").arg(bytes / 1024).arg(useAvx2() ? "да" : "нет"), bytes,
+                     {{"скалярно", scalarTime}, {"SIMD", simdTime}});
+}
+
+void TestVigenere::testCompiledKey()
+{
+    // Кириллица: А..Е, Ё, Ж..Я — 33 буквы, ключ сдвигается только на буквах
+    VigenereKey cyrillic(QString::fromUtf8("ключ"));
+    QCOMPARE(cyrillic.length(), 4);
+    const QString plain = QString::fromUtf8("ПРИВЕТ, мир! Ёлка");
+    const QString encrypted = cyrillic.encrypt(plain);
+    QCOMPARE(encrypted, QString::fromUtf8("ЪЬЖЩПЮ, каы! Сйвк"));
+    QCOMPARE(cyrillic.decrypt(encrypted), plain);
+
+    // Латинский ключ и смешанный текст; цифры в ключе пропускаются
+    VigenereKey latin("K3EY");
+    QCOMPARE(latin.length(), 3);
+    QCOMPARE(latin.encrypt("HELLO"), QString("RIJVS"));
+    const QString mixed = QString::fromUtf8("Hello, мир! Ça va?");
+    QCOMPARE(latin.decrypt(latin.encrypt(mixed)), mixed);
+
+    // Таблицы Виженера
+    for (VigenereAlphabet alphabet : {VigenereAlphabet::Latin, VigenereAlphabet::Cyrillic}) {
+        const int size = VigenereKey::alphabetSize(alphabet);
+        const quint8* table = VigenereKey::tabulaRecta(alphabet);
+        for (int shift = 0; shift < size; ++shift) {
+            for (int letter = 0; letter < size; ++letter) {
+                QCOMPARE(int(table[shift * size + letter]), (letter + shift) % size);
+            }
+        }
+    }
+
+    // Ключ без букв не меняет текст
+    QVERIFY(!VigenereKey("123").isValid());
+    QCOMPARE(VigenereKey("123").encrypt(mixed), mixed);
+
+    // Класс Vigenere использует скомпилированный ключ
+    Vigenere vigenere;
+    QCOMPARE(vigenere.encrypt(plain, QString::fromUtf8("КЛЮЧ")), encrypted);
+    QCOMPARE(vigenere.encrypt("HELLO", "KEY"), QString("RIJVS"));
+}
+
+void TestVigenere::benchmarkCompiledKey()
+{
+    // Короткие сообщения задачи 4: компиляция ключа на каждый вызов и один раз
+    const QStringList messages = {"HELLO", "WORLD", "SECRET", "MESSAGE", "CRYPTO"};
+    const int rounds = 100000;
+
+    int checksum = 0;
+    const BenchmarkResult perCall = measureOnce([&]() {
+        for (int i = 0; i < rounds; ++i) {
+            checksum += VigenereKey("LOCK").encrypt(messages[i % messages.size()]).size();
+        }
+    });
+
+    const VigenereKey key("LOCK");
+    const BenchmarkResult compiled = measureBenchmark([&]() {
+        for (int i = 0; i < rounds; ++i) {
+            checksum += key.encrypt(messages[i % messages.size()]).size();
+        }
+    });
+
+    QVERIFY(checksum > 0);
+    reportRate("Короткие сообщения", "сообщений/с", rounds,
+               {{"компиляция на вызов", perCall}, {"готовый ключ", compiled}});
+}
+
+void TestVigenere::testStreamingFile()
+{
+    // Латиница, пробелы и кириллица в UTF-8
+    QRandomGenerator random(40);
+    const QStringList words = {"Lorem", "ipsum", "DOLOR", "sit", "amet,", "привет", "\n", "42"};
+    QString text;
+    while (text.size() < 300000) {
+        text += words[int(random.bounded(words.size()))] + ' ';
+    }
+    const QByteArray plain = text.toUtf8();
+    const VigenereKey key("Lemon");
+
+    // Фрагменты произвольного размера дают тот же результат, что и весь буфер сразу
+    QByteArray whole = plain;
+    VigenereStream(key, false).process(whole);
+    QByteArray chunked = plain;
+    char* data = chunked.data();
+    VigenereStream stream(key, false);
+    for (int pos = 0; pos < chunked.size();) {
+        const int size = qMin(chunked.size() - pos, 1 + int(random.bounded(5000)));
+        stream.process(data + pos, data + pos, size);
+        pos += size;
+    }
+    QCOMPARE(chunked, whole);
+    QCOMPARE(whole.size(), plain.size());
+
+    // Для ASCII совпадает со строковым API
+    const QString ascii = "Attack at dawn, retreat at dusk!";
+    QByteArray asciiBytes = ascii.toUtf8();
+    VigenereStream(key, false).process(asciiBytes);
+    QCOMPARE(QString::fromUtf8(asciiBytes), key.encrypt(ascii));
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString inputPath = dir.filePath("plain.txt");
+    const QString sequentialPath = dir.filePath("sequential.enc");
+    const QString parallelPath = dir.filePath("parallel.enc");
+    const QString decryptedPath = dir.filePath("decrypted.txt");
+    QFile input(inputPath);
+    QVERIFY(input.open(QIODevice::WriteOnly));
+    input.write(plain);
+    input.close();
+
+    // Параллельный режим побайтно совпадает с последовательным при любом размере фрагмента
+    VigenereFileResult sequential = transformVigenereFile(inputPath, sequentialPath, key, false, 4096);
+    QVERIFY2(sequential.success, qPrintable(sequential.error));
+    QFile sequentialFile(sequentialPath);
+    QVERIFY(sequentialFile.open(QIODevice::ReadOnly));
+    const QByteArray expected = sequentialFile.readAll();
+    QCOMPARE(expected, whole);
+
+    // Размер фрагмента вне диапазона int не обрезается до отрицательного
+    const QString hugeChunkPath = dir.filePath("huge.enc");
+    VigenereFileResult hugeChunk = transformVigenereFile(inputPath, hugeChunkPath, key, false, qint64(1) << 40);
+    QVERIFY2(hugeChunk.success, qPrintable(hugeChunk.error));
+    QFile hugeChunkFile(hugeChunkPath);
+    QVERIFY(hugeChunkFile.open(QIODevice::ReadOnly));
+    QCOMPARE(hugeChunkFile.readAll(), expected);
+
+    for (qint64 chunkSize : {qint64(1), qint64(777), qint64(65536), VIGENERE_CHUNK_SIZE, qint64(1) << 40}) {
+        VigenereFileResult parallel = transformVigenereFileParallel(inputPath, parallelPath, key, false, 0, chunkSize);
+        QVERIFY2(parallel.success, qPrintable(parallel.error));
+        QFile parallelFile(parallelPath);
+        QVERIFY(parallelFile.open(QIODevice::ReadOnly));
+        QCOMPARE(parallelFile.readAll(), expected);
+    }
+
+    // Расшифрование на месте возвращает исходный файл
+    QVERIFY(transformVigenereFileParallel(parallelPath, parallelPath, key, true).success);
+    QFile decrypted(parallelPath);
+    QVERIFY(decrypted.open(QIODevice::ReadOnly));
+    QCOMPARE(decrypted.readAll(), plain);
+
+    QVERIFY(!transformVigenereFile(inputPath, inputPath, key, false).success);
+    QVERIFY(!transformVigenereFile(dir.filePath("missing.txt"), decryptedPath, key, false).success);
+}
+
+void TestVigenere::benchmarkStreamingFile()
+{
+    // Размер файла задаётся VIGENERE_FILE_MB; 64 МБ — при BENCHMARK_LARGE
+    const qint64 megabytes = benchmarkSize("VIGENERE_FILE_MB", 16, 64);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString inputPath = dir.filePath("corpus.txt");
+    const QByteArray line = "The quick brown fox jumps over the lazy dog, again and again.\n";
+    QFile input(inputPath);
+    QVERIFY(input.open(QIODevice::WriteOnly));
+    const QByteArray block = line.repeated(qMax(1, (1 << 20) / line.size()));
+    for (qint64 written = 0; written < megabytes << 20; written += block.size()) {
+        input.write(block);
+    }
+    input.close();
+
+    const VigenereKey key("LEMON");
+    VigenereFileResult sequential;
+    VigenereFileResult parallel;
+    const BenchmarkResult sequentialTime = measureOnce([&]() {
+        sequential = transformVigenereFile(inputPath, dir.filePath("sequential.enc"), key, false);
+    });
+    const BenchmarkResult parallelTime = measureBenchmark([&]() {
+        parallel = transformVigenereFileParallel(inputPath, dir.filePath("parallel.enc"), key, false);
+    });
+    QVERIFY(sequential.success);
+    QVERIFY(parallel.success);
+
+    reportThroughput(QString("%1 МБ, %2 потоков").arg(parallel.bytes >> 20).arg(parallel.threads), parallel.bytes,
+                     {{"последовательно", sequentialTime}, {"параллельно", parallelTime}});
+}
+
+namespace {
+
+// Текст из частых английских слов: частоты букв близки к английским
+QString englishText(int letters, quint32 seed)
+{
+    static const QStringList words = {
+        "the", "of", "and", "to", "in", "is", "you", "that", "it", "he", "was", "for", "on", "are",
+        "as", "with", "his", "they", "at", "be", "this", "have", "from", "or", "one", "had", "by",
+        "word", "but", "not", "what", "all", "were", "we", "when", "your", "can", "said", "there",
+        "use", "each", "which", "she", "do", "how", "their", "if", "will", "up", "other", "about",
+        "out", "many", "then", "them", "these", "so", "some", "her", "would", "make", "like", "him",
+        "into", "time", "has", "look", "two", "more", "write", "go", "see", "number", "no", "way",
+        "could", "people", "my", "than", "first", "water", "been", "call", "who", "now", "find",
+        "long", "down", "day", "did", "get", "come", "made", "may", "part", "over", "new", "sound",
+        "take", "only", "little", "work", "know", "place", "year", "live", "back", "give", "most",
+        "very", "after", "thing", "our", "just", "name", "good", "sentence", "man", "think", "say",
+        "great", "where", "help", "through", "much", "before", "line", "right", "mean", "old"};
+    QRandomGenerator random(seed);
+    QString text;
+    int count = 0;
+    while (count < letters) {
+        const QString& word = words[int(random.bounded(words.size()))];
+        text.append(word);
+        count += word.size();
+        text.append(random.bounded(12) == 0 ? ". " : " ");
+    }
+    return text;
+}
+
+} // namespace
+
+void TestVigenere::testAnalyzeVigenere()
+{
+    const QStringList keys = {"LEMON", "KEY", "A", "ABCABD", "CRYPTOGRAPHY", "SECRETKEYWORDTHATISLONG"};
+    for (const QString& keyText : keys) {
+        const VigenereKey key(keyText);
+        const QString ciphertext = key.encrypt(englishText(5000, quint32(keyText.size())));
+        VigenereAnalysis analysis = analyzeVigenere(ciphertext);
+        QCOMPARE(analysis.key, keyText);
+        QCOMPARE(analysis.candidates.first().length % keyText.size(), 0);
+        QCOMPARE(key.decrypt(ciphertext), VigenereKey(analysis.key).decrypt(ciphertext));
+
+        // Байтовый вариант видит те же буквы
+        QCOMPARE(analyzeVigenere(ciphertext.toUtf8()).key, keyText);
+    }
+
+    // Длина ключа задания 4 находится и по 1000 буквам
+    const QString task = VigenereKey("CODE").encrypt(englishText(1000, 4));
+    QCOMPARE(analyzeVigenere(task).key, QString("CODE"));
+
+    QVERIFY(analyzeVigenere(QString("123, !?")).key.isEmpty());
+    QVERIFY(analyzeVigenere(QByteArray()).candidates.isEmpty());
+
+    // Векторная гистограмма совпадает со скалярной, включая хвост и байты вне ASCII
+    QRandomGenerator random(41);
+    QByteArray bytes(70000, Qt::Uninitialized);
+    for (int i = 0; i < bytes.size(); ++i) {
+        bytes[i] = char(random.bounded(256));
+    }
+    for (int size : {0, 31, 32, 33, 255 * 32 + 5, bytes.size()}) {
+        quint64 scalar[26] = {};
+        quint64 vector[26] = {};
+        setSimdEnabled(false);
+        latinHistogram(bytes.constData(), size, scalar);
+        setSimdEnabled(true);
+        latinHistogram(bytes.constData(), size, vector);
+        for (int letter = 0; letter < 26; ++letter) {
+            QCOMPARE(vector[letter], scalar[letter]);
+        }
+    }
+}
+
+void TestVigenere::benchmarkAnalyzeVigenere()
+{
+    const VigenereKey key("INSTRUCTORTOOL");
+    const QByteArray ciphertext = key.encrypt(englishText(1 << 20, 1)).toUtf8();
+
+    VigenereAnalysis analysis;
+    QBENCHMARK {
+        analysis = analyzeVigenere(ciphertext);
+    }
+    QCOMPARE(analysis.key, QString("INSTRUCTORTOOL"));
+    qInfo() << analysis.letters << "букв: ключ найден за" << analysis.elapsedNs / 1e6 << "мс,"
+            << analysis.threads << "потоков";
+}
+
+void TestVigenere::testKeySearch()
+{
+    // Короткие сообщения задачи 4 находятся перебором ключей задания
+    const QStringList taskKeys = {"KEY", "CODE", "PASS", "LOCK", "SAFE"};
+    for (const QString& message : {QString("HELLO"), QString("WORLD"), QString("SECRET"), QString("MESSAGE")}) {
+        for (const QString& key : taskKeys) {
+            VigenereKeySearch search(VigenereKey(key).encrypt(message));
+            QVERIFY(search.dictionary(taskKeys));
+            QCOMPARE(search.key(), key);
+            QCOMPARE(search.plaintext(), message);
+        }
+    }
+
+    // Ключи не из словаря: модификации слов и поиск восхождением; результат
+    // не зависит от числа потоков
+    const QString text = "Meet me near the old bridge at midnight and bring the documents with you.";
+    for (const QString& key : {QString("LEMON"), QString("QWERTY"), QString("X")}) {
+        const QString ciphertext = VigenereKey(key).encrypt(text);
+        for (int threads : {1, 0}) {
+            VigenereKeySearch search(ciphertext);
+            search.setThreadCount(threads);
+            search.dictionary(VigenereKeySearch::defaultDictionary(), VigenereKeySearch::AllMutations);
+            QVERIFY(search.hillClimb());
+            QCOMPARE(search.key(), key);
+            QCOMPARE(search.plaintext(), text);
+            QVERIFY(search.stats().keysTried > 0);
+        }
+    }
+
+    // Словарь оценивает ключи со штрафом за длину, как восхождение:
+    // повтор ключа из словаря уступает короткому ключу восхождения
+    VigenereKeySearch repeated(VigenereKey("LEMON").encrypt(text));
+    QVERIFY(repeated.dictionary({"LEMONLEMON"}));
+    QCOMPARE(repeated.key(), QString("LEMONLEMON"));
+    const double dictionaryScore = repeated.score();
+    QVERIFY(repeated.hillClimb());
+    QCOMPARE(repeated.key(), QString("LEMON"));
+    QVERIFY(repeated.score() > dictionaryScore);
+    QCOMPARE(repeated.plaintext(), text);
+
+    // Слишком короткий текст: поиск восхождением не запускается
+    QVERIFY(!VigenereKeySearch("ABC").hillClimb());
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QFile counts(dir.filePath("quadgrams.txt"));
+    QVERIFY(counts.open(QIODevice::WriteOnly | QIODevice::Text));
+    counts.write("TION 13168375\nNTHE 11234972\nTHER 10218035\nbad line\nTH3R 5\n");
+    counts.close();
+    QuadgramTable table;
+    QVERIFY(table.load(counts.fileName()));
+    const int tion = (((19 * 26) + 8) * 26 + 14) * 26 + 13;
+    const int qqqq = (((16 * 26) + 16) * 26 + 16) * 26 + 16;
+    QVERIFY(table.data()[tion] > table.data()[qqqq]);
+    QVERIFY(!table.load(dir.filePath("missing.txt")));
+}
+
+void TestVigenere::benchmarkKeySearch()
+{
+    const QString text = QString("The weather today is cold and windy, so stay at home and read a good book by the fire. ")
+            .repeated(4);
+    const QString ciphertext = VigenereKey("CRYPTOGRAPHY").encrypt(text);
+
+    VigenereKeySearch search(ciphertext);
+    search.dictionary(VigenereKeySearch::defaultDictionary(), VigenereKeySearch::AllMutations);
+    const VigenereSearchStats dictionary = search.stats();
+    search.hillClimb(16);
+    const VigenereSearchStats climb = search.stats();
+
+    QCOMPARE(search.key(), QString("CRYPTOGRAPHY"));
+    qInfo() << "Словарь:" << dictionary.keysTried << "ключей," << qRound64(dictionary.keysPerSecondPerCore())
+            << "ключей/с на ядро";
+    qInfo() << "Восхождение:" << climb.keysTried << "ключей," << qRound64(climb.keysPerSecondPerCore())
+            << "ключей/с на ядро," << climb.threads << "потоков";
+}
+
+void TestVigenere::testClassicalCiphers()
+{
+    QCOMPARE(encryptBeaufort("DEFENDTHEEASTWALLOFTHECASTLE", "FORTIFICATION"),
+             QString("CKMPVCPVWPIWUJOGIUAPVWRIWUUK"));
+    QCOMPARE(encryptGronsfeld("HELLO", "31415"), QString("KFPMT"));
+    QCOMPARE(encryptAutokey("ATTACKATDAWN", "QUEENLY"), QString("QNXEPVYTWTWP"));
+    QCOMPARE(decryptAutokey("QNXEPVYTWTWP", "QUEENLY"), QString("ATTACKATDAWN"));
+
+    // Регистр и знаки сохраняются, ключ сдвигается только на буквах
+    QCOMPARE(encryptGronsfeld("He, llo!", "31415"), QString("Kf, pmt!"));
+    QCOMPARE(encryptBeaufort("Hello", QString()), QString("Hello"));
+    QCOMPARE(encryptGronsfeld("Hello", "key"), QString("Hello"));
+
+    // Векторный путь совпадает со скалярным; расшифрование обращает шифрование
+    QRandomGenerator random(43);
+    const QString alphabet = QString::fromUtf8("ABCXYZabcxyz ,.!09@[`{");
+    const QString extra = QString::fromUtf8("éЖ");
+    QString text;
+    for (int i = 0; i < 5000; ++i) {
+        text.append(random.bounded(100) < 98 ? alphabet[int(random.bounded(alphabet.size()))]
+                                            : extra[int(random.bounded(extra.size()))]);
+    }
+    for (const QString& key : {QString("KEY"), QString("lemon"), QString("LONGKEYWITHMORETHANSIXTEENLETTERS"),
+                               QString("31415"), QString("9")}) {
+        for (int length : {0, 15, 16, 17, 33, 1000, 5000}) {
+            const QString part = text.left(length);
+            setSimdEnabled(false);
+            const QString beaufort = encryptBeaufort(part, key);
+            const QString gronsfeld = encryptGronsfeld(part, key);
+            const QString autokey = encryptAutokey(part, key);
+            setSimdEnabled(true);
+            QCOMPARE(encryptBeaufort(part, key), beaufort);
+            QCOMPARE(encryptGronsfeld(part, key), gronsfeld);
+            QCOMPARE(encryptAutokey(part, key), autokey);
+            QCOMPARE(decryptBeaufort(beaufort, key), part);
+            QCOMPARE(decryptGronsfeld(gronsfeld, key), part);
+            QCOMPARE(decryptAutokey(autokey, key), part);
+        }
+    }
+}
+
+namespace {
+
+typedef QString (*CipherFunction)(const QString&, const QString&);
+
+// Варианты семейства для сравнения скорости
+struct CipherVariant {
+    const char* name;
+    CipherFunction function;
+    const char* key;
+};
+
+const CipherVariant CIPHER_VARIANTS[] = {
+    {"Vigenere (key by letter)", [](const QString& text, const QString& key) { return VigenereKey(key).encrypt(text); },
+     "LEMON"},
+    {"Vigenere (key by position)", encryptVigenere, "LEMON"},
+    {"Beaufort", encryptBeaufort, "FORTIFICATION"},
+    {"Gronsfeld", encryptGronsfeld, "31415"},
+    {"Autokey encrypt", encryptAutokey, "QUEENLY"},
+    {"Autokey decrypt", decryptAutokey, "QUEENLY"}
+};
+
+} // namespace
+
+void TestVigenere::benchmarkCipherFamily_data()
+{
+    QTest::addColumn<int>("variant");
+    for (int i = 0; i < int(sizeof(CIPHER_VARIANTS) / sizeof(CIPHER_VARIANTS[0])); ++i) {
+        QTest::newRow(CIPHER_VARIANTS[i].name) << i;
+    }
+}
+
+void TestVigenere::benchmarkCipherFamily()
+{
+    QFETCH(int, variant);
+    const CipherVariant& cipher = CIPHER_VARIANTS[variant];
+
+    const int bytes = 4 * 1024 * 1024;
+    const QString sentence = "The quick brown fox jumps over the lazy dog, again and again. ";
+    QString text = sentence.repeated(bytes / int(sizeof(QChar)) / sentence.size() + 1);
+    text.truncate(bytes / int(sizeof(QChar)));
+
+    QString scalar;
+    setSimdEnabled(false);
+    const BenchmarkResult scalarTime = measureOnce([&]() { scalar = cipher.function(text, cipher.key); });
+    setSimdEnabled(true);
+
+    QString result;
+    const BenchmarkResult simdTime = measureBenchmark([&]() { result = cipher.function(text, cipher.key); });
+
+    QCOMPARE(result, scalar);
+    reportThroughput(QString("%1, AVX2 %2").arg(cipher.name).arg(useAvx2() ? "да" : "нет"), bytes,
+                     {{"скалярно", scalarTime}, {"SIMD", simdTime}});
+}
+
 QTEST_APPLESS_MAIN(TestVigenere) 
\ No newline at end of file
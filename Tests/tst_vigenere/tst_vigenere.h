@@ -3,6 +3,10 @@
 
 #include <QObject>
 #include "../Server/vigenere.h"
+#include "../Server/vigenerestream.h"
+#include "../Server/vigenereanalysis.h"
+#include "../Server/vigenereattack.h"
+#include "../Server/classicalciphers.h"
 
 class TestVigenere : public QObject
 {
@@ -13,6 +17,20 @@ private slots:
     void testWithSpacesAndPunctuation();
     void testLongKey();
     void testPerformance();
+    void testSimdMatchesScalar();
+    void benchmarkEncrypt_data();
+    void benchmarkEncrypt();
+    void testCompiledKey();
+    void benchmarkCompiledKey();
+    void testStreamingFile();
+    void benchmarkStreamingFile();
+    void testAnalyzeVigenere();
+    void benchmarkAnalyzeVigenere();
+    void testKeySearch();
+    void benchmarkKeySearch();
+    void testClassicalCiphers();
+    void benchmarkCipherFamily_data();
+    void benchmarkCipherFamily();
 };
 
 #endif // TST_VIGENERE_H 
\ No newline at end of file
@@ -7,9 +7,22 @@ CONFIG -= app_bundle
 TEMPLATE = app
 
 INCLUDEPATH += ../../Server
+INCLUDEPATH += ..
 
 SOURCES += tst_vigenere.cpp \
-    ../../Server/vigenere.cpp
+    ../../Server/vigenere.cpp \
+    ../../Server/classicalciphers.cpp \
+    ../../Server/vigenereanalysis.cpp \
+    ../../Server/vigenereattack.cpp \
+    ../../Server/vigenerestream.cpp
 
 HEADERS += tst_vigenere.h \
-    ../../Server/vigenere.h 
\ No newline at end of file
+    ../benchmark.h \
+    ../../Server/vigenere.h \
+    ../../Server/classicalciphers.h \
+    ../../Server/cipherkernel.h \
+    ../../Server/vigenereanalysis.h \
+    ../../Server/vigenereattack.h \
+    ../../Server/vigenerestream.h \
+    ../../Server/cpufeatures.h \
+    ../../Server/parallel.h 
\ No newline at end of file
@@ -2,6 +2,91 @@
 #include <QElapsedTimer>
 #include <QFile>
 #include <QDir>
+#include <QTemporaryDir>
+#include <QRandomGenerator>
+#include "benchmark.h"
+#include "cpufeatures.h"
+
+namespace {
+
+QByteArray le16(int value)
+{
+    QByteArray bytes(2, 0);
+    bytes[0] = char(value & 0xFF);
+    bytes[1] = char((value >> 8) & 0xFF);
+    return bytes;
+}
+
+QByteArray le32(quint32 value)
+{
+    QByteArray bytes(4, 0);
+    for (int i = 0; i < 4; ++i) {
+        bytes[i] = char((value >> (8 * i)) & 0xFF);
+    }
+    return bytes;
+}
+
+// Блок RIFF: ID, длина, данные и байт выравнивания при нечётной длине
+QByteArray riffChunk(const char* id, const QByteArray& body, quint32 size)
+{
+    QByteArray chunk(id, 4);
+    chunk.append(le32(size));
+    chunk.append(body);
+    if (body.size() & 1) {
+        chunk.append('\0');
+    }
+    return chunk;
+}
+
+QByteArray riffChunk(const char* id, const QByteArray& body)
+{
+    return riffChunk(id, body, quint32(body.size()));
+}
+
+// Тело блока "fmt " длиной 16 байт
+QByteArray fmtBody(int formatTag, int channels, int sampleRate, int bitDepth, int blockAlign = -1)
+{
+    if (blockAlign < 0) {
+        blockAlign = channels * bitDepth / 8;
+    }
+    QByteArray body;
+    body.append(le16(formatTag));
+    body.append(le16(channels));
+    body.append(le32(quint32(sampleRate)));
+    body.append(le32(quint32(sampleRate * blockAlign)));
+    body.append(le16(blockAlign));
+    body.append(le16(bitDepth));
+    return body;
+}
+
+// Тело блока "fmt " WAVE_FORMAT_EXTENSIBLE длиной 40 байт
+QByteArray extensibleFmtBody(int channels, int sampleRate, int bitDepth, int validBits, int subFormat)
+{
+    QByteArray body = fmtBody(WAV_FORMAT_EXTENSIBLE, channels, sampleRate, bitDepth);
+    body.append(le16(22));
+    body.append(le16(validBits));
+    body.append(le32(channels == 2 ? 0x3 : 0x4));
+    body.append(le16(subFormat));
+    body.append(QByteArray("\x00\x00\x00\x00\x10\x00\x80\x00\x00\xAA\x00\x38\x9B\x71", 14));
+    return body;
+}
+
+void writeWavFile(const QString& filename, const QByteArray& chunks)
+{
+    QFile file(filename);
+    file.open(QIODevice::WriteOnly);
+    file.write(riffChunk("RIFF", "WAVE" + chunks));
+    file.close();
+}
+
+QByteArray readFile(const QString& filename)
+{
+    QFile file(filename);
+    file.open(QIODevice::ReadOnly);
+    return file.readAll();
+}
+
+} // namespace
 
 void TestWavEmbed::testShortMessage()
 {
@@ -63,6 +148,7 @@ void TestWavEmbed::testMessageExtraction()
 void TestWavEmbed::testDifferentWavFormats()
 {
     WavEmbed wavEmbed;
+    WavEmbed reader;
     QString inputFile = "test_input.wav";
     QString outputFile = "test_output.wav";
     QString message = "Test message";
@@ -82,11 +168,104 @@ void TestWavEmbed::testDifferentWavFormats()
             QCOMPARE(extractedMessage, message);
         }
     }
+
+    // Целые 8/16/24/32 бита и float32, моно и стерео, 1–4 бита на отсчёт
+    const QList<QPair<int, int>> formats = {
+        {8, WAV_FORMAT_PCM}, {16, WAV_FORMAT_PCM}, {24, WAV_FORMAT_PCM}, {32, WAV_FORMAT_PCM},
+        {32, WAV_FORMAT_IEEE_FLOAT}
+    };
+    for (const QPair<int, int>& format : formats) {
+        const int depth = format.first;
+        const int stride = depth / 8;
+        for (int channels : {1, 2}) {
+            createTestWavFile(inputFile, 44100, depth, channels, format.second);
+            const QByteArray original = readFile(inputFile);
+            const qint64 dataOffset = readWavInfo(inputFile).dataOffset;
+
+            for (int bits = 1; bits <= 4; ++bits) {
+                wavEmbed.setSampleBits(bits);
+                const qint64 capacity = wavEmbed.capacity(inputFile);
+                QCOMPARE(capacity, (10000 * channels - STEG_HEADER_SIZE * 8) * bits / 8);
+
+                // Сообщение во всю вместимость помещается, на байт длиннее — нет;
+                // извлечению число битов не задаётся
+                const QString full(int(capacity), QChar('a' + bits));
+                QVERIFY2(wavEmbed.embedMessage(inputFile, outputFile, full), qPrintable(wavEmbed.errorString()));
+                QCOMPARE(reader.extractMessage(outputFile), full);
+                QVERIFY(!wavEmbed.embedMessage(inputFile, outputFile, full + "!"));
+                QVERIFY(wavEmbed.errorString().contains(QString::number(capacity)));
+
+                // Меняются только k младших битов отсчётов
+                QVERIFY2(wavEmbed.embedMessage(inputFile, outputFile, full), qPrintable(wavEmbed.errorString()));
+                const QByteArray embedded = readFile(outputFile);
+                QCOMPARE(embedded.size(), original.size());
+                for (int i = int(dataOffset); i < embedded.size(); i += stride) {
+                    const uchar mask = (i - dataOffset) % stride == 0 ? uchar(~((1 << bits) - 1)) : 0xFF;
+                    QCOMPARE(uchar(embedded[i] ^ original[i]) & mask, 0);
+                    for (int b = 1; b < stride; ++b) {
+                        QCOMPARE(embedded[i + b], original[i + b]);
+                    }
+                }
+            }
+        }
+    }
     
     QFile::remove(inputFile);
     QFile::remove(outputFile);
 }
 
+void TestWavEmbed::benchmarkWavFormats_data()
+{
+    QTest::addColumn<int>("depth");
+    QTest::addColumn<int>("formatTag");
+    QTest::addColumn<int>("channels");
+    for (int depth : {8, 16, 24, 32}) {
+        for (int channels : {1, 2}) {
+            QTest::newRow(qPrintable(QString("%1 бит, каналов: %2").arg(depth).arg(channels)))
+                    << depth << int(WAV_FORMAT_PCM) << channels;
+        }
+    }
+    for (int channels : {1, 2}) {
+        QTest::newRow(qPrintable(QString("32 бит float, каналов: %1").arg(channels)))
+                << 32 << int(WAV_FORMAT_IEEE_FLOAT) << channels;
+    }
+}
+
+void TestWavEmbed::benchmarkWavFormats()
+{
+    QFETCH(int, depth);
+    QFETCH(int, formatTag);
+    QFETCH(int, channels);
+
+    // Обложка задаётся через WAVEMBED_FORMAT_MB, по умолчанию 4 МБ, при BENCHMARK_LARGE — 64 МБ; 4 бита на отсчёт
+    const int stride = depth / 8;
+    const int dataSize = int(benchmarkSize("WAVEMBED_FORMAT_MB", 4, 64) << 20);
+    const int frames = dataSize / (stride * channels);
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString inputFile = dir.filePath("input.wav");
+    const QString outputFile = dir.filePath("output.wav");
+    writeWavFile(inputFile, riffChunk("fmt ", fmtBody(formatTag, channels, 44100, depth))
+                 + riffChunk("data", QByteArray(frames * stride * channels, 0x55)));
+
+    WavEmbed wavEmbed;
+    WavEmbed reader;
+    wavEmbed.setSampleBits(4);
+    const QString message(int(wavEmbed.capacity(inputFile)), QChar('z'));
+    bool embedded = false;
+    const BenchmarkResult embed = measureBenchmark([&]() {
+        embedded = wavEmbed.embedMessage(inputFile, outputFile, message);
+    });
+    QVERIFY2(embedded, qPrintable(wavEmbed.errorString()));
+    QString extracted;
+    const BenchmarkResult extract = measureOnce([&]() { extracted = reader.extractMessage(outputFile); });
+    QCOMPARE(extracted, message);
+
+    reportThroughput(QString("%1 бит%2, каналов: %3, МБ отсчётов").arg(depth)
+                         .arg(formatTag == WAV_FORMAT_IEEE_FLOAT ? " float" : "").arg(channels),
+                     frames * stride * channels, {{"встраивание", embed}, {"извлечение", extract}});
+}
+
 void TestWavEmbed::testPerformance()
 {
     WavEmbed wavEmbed;
@@ -109,32 +288,776 @@ void TestWavEmbed::testPerformance()
     QFile::remove(outputFile);
 }
 
+void TestWavEmbed::testWavChunks()
+{
+    WavEmbed wavEmbed;
+    QString inputFile = "test_input.wav";
+    QString outputFile = "test_output.wav";
+    QString message = QString::fromUtf8("Скрытое сообщение");
+
+    // EXTENSIBLE, блоки fact и LIST нечётной длины до отсчётов, LIST после них
+    QByteArray samples(6000, 0);
+    for (int i = 0; i < samples.size(); ++i) {
+        samples[i] = char(i * 37 + 11);
+    }
+    const QByteArray before = riffChunk("fmt ", extensibleFmtBody(2, 48000, 24, 20, WAV_FORMAT_PCM))
+            + riffChunk("fact", le32(1000)) + riffChunk("LIST", "INFOx");
+    const QByteArray after = riffChunk("LIST", "INFOtrailing");
+    writeWavFile(inputFile, before + riffChunk("data", samples) + after);
+
+    WavInfo info = readWavInfo(inputFile);
+    QVERIFY2(info.valid, qPrintable(info.error));
+    QCOMPARE(int(info.formatTag), int(WAV_FORMAT_EXTENSIBLE));
+    QVERIFY(!info.isFloat);
+    QCOMPARE(info.channels, 2);
+    QCOMPARE(info.sampleRate, quint32(48000));
+    QCOMPARE(info.bitsPerSample, 24);
+    QCOMPARE(info.validBits, 20);
+    QCOMPARE(info.blockAlign, 6);
+    QCOMPARE(info.dataOffset, qint64(12 + before.size() + 8));
+    QCOMPARE(info.dataSize, qint64(samples.size()));
+    QCOMPARE(info.frameCount(), qint64(1000));
+
+    // Меняются только младшие биты первых байт блока "data"
+    QVERIFY2(wavEmbed.embedMessage(inputFile, outputFile, message), qPrintable(wavEmbed.errorString()));
+    QCOMPARE(wavEmbed.extractMessage(outputFile), message);
+    const QByteArray original = readFile(inputFile);
+    const QByteArray embedded = readFile(outputFile);
+    QCOMPARE(embedded.size(), original.size());
+    // 20 значащих бит из 24: сообщение в бите 4 первого байта каждого отсчёта
+    const int embedEnd = int(info.dataOffset) + (message.toUtf8().size() + STEG_HEADER_SIZE) * 8 * 3;
+    QCOMPARE(embedded.left(int(info.dataOffset)), original.left(int(info.dataOffset)));
+    QCOMPARE(embedded.mid(embedEnd), original.mid(embedEnd));
+    for (int i = int(info.dataOffset); i < embedEnd; ++i) {
+        const int mask = (i - int(info.dataOffset)) % 3 == 0 ? 0xEF : 0xFF;
+        QCOMPARE(embedded[i] & mask, original[i] & mask);
+    }
+
+    // 32-битный float; длина "data" за концом файла обрезается
+    writeWavFile(inputFile, riffChunk("fmt ", fmtBody(WAV_FORMAT_IEEE_FLOAT, 1, 44100, 32))
+                 + riffChunk("data", QByteArray(4000, 0), 0xFFFFFFFFu));
+    info = readWavInfo(inputFile);
+    QVERIFY2(info.valid, qPrintable(info.error));
+    QVERIFY(info.isFloat);
+    QCOMPARE(info.dataSize, qint64(4000));
+    QVERIFY(wavEmbed.embedMessage(inputFile, outputFile, "IEEE float!"));
+    QCOMPARE(wavEmbed.extractMessage(outputFile), QString("IEEE float!"));
+
+    QFile::remove(inputFile);
+    QFile::remove(outputFile);
+}
+
+void TestWavEmbed::testInvalidWav()
+{
+    WavEmbed wavEmbed;
+    QString inputFile = "test_input.wav";
+    QString outputFile = "test_output.wav";
+    const QByteArray data = riffChunk("data", QByteArray(1000, 0));
+
+    const QList<QByteArray> files = {
+        QByteArray("RIFX") + le32(4) + "WAVE",                                       // не RIFF
+        riffChunk("RIFF", "AVI "),                                                   // не WAVE
+        riffChunk("RIFF", "WAVE" + data),                                            // нет "fmt "
+        riffChunk("RIFF", "WAVE" + riffChunk("fmt ", fmtBody(WAV_FORMAT_PCM, 1, 8000, 16))),  // нет "data"
+        riffChunk("RIFF", "WAVE" + riffChunk("fmt ", fmtBody(WAV_FORMAT_PCM, 2, 8000, 16, 2)) + data),
+        riffChunk("RIFF", "WAVE" + riffChunk("fmt ", fmtBody(WAV_FORMAT_PCM, 1, 8000, 12, 2)) + data),
+        riffChunk("RIFF", "WAVE" + riffChunk("fmt ", fmtBody(WAV_FORMAT_IEEE_FLOAT, 1, 8000, 16)) + data),
+        riffChunk("RIFF", "WAVE" + riffChunk("fmt ", fmtBody(0x0055, 1, 8000, 16)) + data),
+        riffChunk("RIFF", "WAVE" + riffChunk("fmt ", fmtBody(WAV_FORMAT_PCM, 0, 8000, 16)) + data),
+        riffChunk("RIFF", "WAVE" + riffChunk("fmt ", extensibleFmtBody(1, 8000, 16, 24, WAV_FORMAT_PCM)) + data),
+        riffChunk("RIFF", "WAVE" + riffChunk("fmt ", fmtBody(WAV_FORMAT_PCM, 1, 8000, 16).left(12)) + data)
+    };
+    for (const QByteArray& contents : files) {
+        QFile file(inputFile);
+        file.open(QIODevice::WriteOnly);
+        file.write(contents);
+        file.close();
+
+        const WavInfo info = readWavInfo(inputFile);
+        QVERIFY(!info.valid);
+        QVERIFY(!info.error.isEmpty());
+        QVERIFY(!wavEmbed.embedMessage(inputFile, outputFile, "Test message"));
+        QCOMPARE(wavEmbed.errorString(), info.error);
+        qInfo() << "Отклонён:" << info.error;
+    }
+
+    // Сообщение не помещается в блок "data"
+    createTestWavFile(inputFile);
+    QVERIFY(!wavEmbed.embedMessage(inputFile, outputFile, QString(2000, 'A')));
+    QVERIFY(!wavEmbed.errorString().isEmpty());
+
+    QFile::remove(inputFile);
+    QFile::remove(outputFile);
+}
+
+void TestWavEmbed::testMappedMode()
+{
+    WavEmbed wavEmbed;
+    QString inputFile = "test_input.wav";
+    QString outputFile = "test_output.wav";
+    QString inPlaceFile = "test_inplace.wav";
+    QString message = QString::fromUtf8("Сообщение для отображения в память ").repeated(60) + "!";
+
+    QByteArray samples(200000, 0);
+    for (int i = 0; i < samples.size(); ++i) {
+        samples[i] = char(i * 7 + (i >> 9));
+    }
+    writeWavFile(inputFile, riffChunk("fmt ", fmtBody(WAV_FORMAT_PCM, 2, 44100, 16)) + riffChunk("LIST", "INFO")
+                 + riffChunk("data", samples) + riffChunk("LIST", "INFOtrailing"));
+
+    // Оба режима дают одинаковый файл и читают сообщение из любого из них
+    QByteArray expected;
+    for (WavEmbed::IoMode mode : {WavEmbed::Streamed, WavEmbed::Mapped}) {
+        wavEmbed.setIoMode(mode);
+        QVERIFY2(wavEmbed.embedMessage(inputFile, outputFile, message), qPrintable(wavEmbed.errorString()));
+        const QByteArray embedded = readFile(outputFile);
+        if (expected.isEmpty()) {
+            expected = embedded;
+        }
+        QCOMPARE(embedded, expected);
+        for (WavEmbed::IoMode extractMode : {WavEmbed::Streamed, WavEmbed::Mapped}) {
+            wavEmbed.setIoMode(extractMode);
+            QCOMPARE(wavEmbed.extractMessage(outputFile), message);
+        }
+
+        // Встраивание на месте меняет файл так же, как встраивание в копию
+        wavEmbed.setIoMode(mode);
+        QFile::remove(inPlaceFile);
+        QVERIFY(QFile::copy(inputFile, inPlaceFile));
+        QVERIFY2(wavEmbed.embedMessage(inPlaceFile, inPlaceFile, message), qPrintable(wavEmbed.errorString()));
+        QCOMPARE(readFile(inPlaceFile), expected);
+    }
+
+    // Несуществующий файл не создаётся
+    QFile::remove(inPlaceFile);
+    QVERIFY(!wavEmbed.embedMessage(inPlaceFile, inPlaceFile, message));
+    QVERIFY(!QFile::exists(inPlaceFile));
+
+    QFile::remove(inputFile);
+    QFile::remove(outputFile);
+}
+
+void TestWavEmbed::benchmarkIoModes_data()
+{
+    QTest::addColumn<int>("mode");
+    QTest::newRow("Streamed") << int(WavEmbed::Streamed);
+    QTest::newRow("Mapped") << int(WavEmbed::Mapped);
+}
+
+void TestWavEmbed::benchmarkIoModes()
+{
+    QFETCH(int, mode);
+    WavEmbed wavEmbed;
+    wavEmbed.setIoMode(WavEmbed::IoMode(mode));
+    QString inputFile = "test_input.wav";
+    QString outputFile = "test_output.wav";
+    QString message = QString(1000, 'A');
+
+    // Обложка WAVEMBED_IO_MB; 64 МБ — при BENCHMARK_LARGE
+    const int dataSize = int(benchmarkSize("WAVEMBED_IO_MB", 16, 64) << 20);
+    writeWavFile(inputFile, riffChunk("fmt ", fmtBody(WAV_FORMAT_PCM, 2, 44100, 16))
+                 + riffChunk("data", QByteArray(dataSize, 0x55)));
+
+    bool embedded = false;
+    const BenchmarkResult embed = measureBenchmark([&]() {
+        embedded = wavEmbed.embedMessage(inputFile, outputFile, message);
+    });
+    QVERIFY(embedded);
+
+    bool embeddedInPlace = false;
+    const BenchmarkResult inPlace = measureOnce([&]() {
+        embeddedInPlace = wavEmbed.embedMessage(outputFile, outputFile, message);
+    });
+    QVERIFY(embeddedInPlace);
+
+    QString extracted;
+    const BenchmarkResult extract = measureOnce([&]() { extracted = wavEmbed.extractMessage(outputFile); });
+    QCOMPARE(extracted, message);
+
+    reportThroughput(mode == WavEmbed::Mapped ? "Отображение" : "Фрагменты", dataSize,
+                     {{"встраивание в копию", embed}});
+    qInfo() << "  на месте" << inPlace.elapsedNs / 1000 << "мкс, извлечение" << extract.elapsedNs / 1000 << "мкс";
+
+    QFile::remove(inputFile);
+    QFile::remove(outputFile);
+}
+
+namespace {
+
+// Записывает байты в младшие биты отсчётов (старший бит первым), как встраивание старого формата
+void embedRawBytes(QByteArray& samples, const QByteArray& bytes)
+{
+    for (int i = 0; i < bytes.size() * 8; ++i) {
+        const int bit = (uchar(bytes[i / 8]) >> (7 - i % 8)) & 1;
+        samples[i] = char((samples[i] & 0xFE) | bit);
+    }
+}
+
+} // namespace
+
+void TestWavEmbed::testContainer()
+{
+    WavEmbed wavEmbed;
+    QString inputFile = "test_input.wav";
+    QString outputFile = "test_output.wav";
+
+    // Заголовок и CRC-32 (контрольное значение для "123456789")
+    QCOMPARE(crc32("123456789", 9), quint32(0xCBF43926));
+    const QByteArray packed = packStegContainer("abc");
+    QCOMPARE(packed.size(), STEG_HEADER_SIZE + 3);
+    StegHeader header;
+    QVERIFY(parseStegHeader(packed, header).isEmpty());
+    QCOMPARE(header.length, quint32(3));
+    QCOMPARE(header.crc, crc32("abc", 3));
+
+    QByteArray cover(60000, 0);
+    for (int i = 0; i < cover.size(); ++i) {
+        cover[i] = char(i * 13 + 5);
+    }
+    const QByteArray fmt = riffChunk("fmt ", fmtBody(WAV_FORMAT_PCM, 1, 44100, 16));
+
+    // Старый формат читается; нулевые биты в конце текста больше не принимаются за маркер
+    const QList<QByteArray> legacyMessages = {
+        "Test message", "float", QString::fromUtf8("Пробел в конце ").toUtf8(), QByteArray(5000, 'p')
+    };
+    for (const QByteArray& legacy : legacyMessages) {
+        QByteArray samples = cover;
+        embedRawBytes(samples, legacy + QByteArray(1, '\0'));
+        writeWavFile(inputFile, fmt + riffChunk("data", samples));
+        for (WavEmbed::IoMode mode : {WavEmbed::Streamed, WavEmbed::Mapped}) {
+            wavEmbed.setIoMode(mode);
+            QCOMPARE(wavEmbed.extractMessage(inputFile), QString::fromUtf8(legacy));
+        }
+    }
+
+    // Новый формат сохраняет такие сообщения целиком
+    for (const QString& message : {QString("float"), QString::fromUtf8("Пробел в конце "), QString()}) {
+        createTestWavFile(inputFile);
+        QVERIFY(wavEmbed.embedMessage(inputFile, outputFile, message));
+        QCOMPARE(wavEmbed.extractMessage(outputFile), message);
+        QVERIFY(wavEmbed.errorString().isEmpty());
+    }
+
+    // Повреждённые контейнеры отклоняются
+    QByteArray corrupted = packStegContainer("Secret message");
+    corrupted[STEG_HEADER_SIZE + 2] = char(corrupted[STEG_HEADER_SIZE + 2] ^ 0x01);
+    QByteArray tooLong = packStegContainer("Secret message");
+    tooLong[9] = char(0x7F);
+    QByteArray newerVersion = packStegContainer("Secret message");
+    newerVersion[4] = char(STEG_CONTAINER_VERSION + 1);
+    const QList<QPair<QByteArray, QString>> damaged = {
+        {corrupted, "Container CRC mismatch"},
+        {tooLong, "Container length exceeds data chunk"},
+        {newerVersion, QString("Unsupported container version %1").arg(STEG_CONTAINER_VERSION + 1)}
+    };
+    for (const QPair<QByteArray, QString>& item : damaged) {
+        QByteArray samples = cover;
+        embedRawBytes(samples, item.first);
+        writeWavFile(inputFile, fmt + riffChunk("data", samples));
+        QVERIFY(wavEmbed.extractMessage(inputFile).isEmpty());
+        QCOMPARE(wavEmbed.errorString(), item.second);
+    }
+
+    QFile::remove(inputFile);
+    QFile::remove(outputFile);
+}
+
+void TestWavEmbed::benchmarkContainerExtraction()
+{
+    // Размер обложки задаётся через WAVEMBED_COVER_MB (до 4095), по умолчанию 64 МБ, при BENCHMARK_LARGE — 1 ГБ
+    const qint64 megabytes = qMin<qint64>(benchmarkSize("WAVEMBED_COVER_MB", 64, 1024), 4095);
+
+    // Разреженный файл: заголовок и блок "data" из нулей, место на диске не занимается
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString coverFile = dir.filePath("cover.wav");
+    const qint64 dataSize = megabytes << 20;
+    const QByteArray header = riffChunk("RIFF", "WAVE" + riffChunk("fmt ", fmtBody(WAV_FORMAT_PCM, 2, 44100, 16))
+                                        + riffChunk("data", QByteArray(), quint32(dataSize)), quint32(dataSize + 36));
+    QFile cover(coverFile);
+    QVERIFY(cover.open(QIODevice::WriteOnly));
+    cover.write(header);
+    QVERIFY(cover.resize(header.size() + dataSize));
+    cover.close();
+
+    WavEmbed wavEmbed;
+    QString message = QString(1000, 'A');
+    QVERIFY(wavEmbed.embedMessage(coverFile, coverFile, message));
+
+    // Извлечение читает только заголовок и биты сообщения, поэтому повторяется до минимального времени
+    QString extracted;
+    wavEmbed.setIoMode(WavEmbed::Streamed);
+    const BenchmarkResult streamed = measureOnce([&]() { extracted = wavEmbed.extractMessage(coverFile); });
+    QCOMPARE(extracted, message);
+    wavEmbed.setIoMode(WavEmbed::Mapped);
+    const BenchmarkResult mapped = measureBenchmark([&]() { extracted = wavEmbed.extractMessage(coverFile); });
+    QCOMPARE(extracted, message);
+
+    // Для сравнения: чтение всего блока "data", как делало прежнее извлечение
+    QVERIFY(cover.open(QIODevice::ReadOnly));
+    QByteArray buffer(1 << 20, Qt::Uninitialized);
+    const BenchmarkResult fullRead = measureOnce([&]() {
+        while (cover.read(buffer.data(), buffer.size()) > 0) {
+        }
+    });
+
+    reportRate(QString("%1 МБ, извлечение").arg(megabytes), "извлечений/с", 1.0,
+               {{"фрагменты", streamed}, {"отображение", mapped}, {"чтение всего блока data", fullRead}});
+}
+
+namespace {
+
+// Побитные эталоны: младший бит байта обложки 8i + k — бит 7 - k байта сообщения i
+QByteArray referenceEmbed(QByteArray cover, const QByteArray& message, qint64 firstBit, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        const qint64 bit = firstBit + i;
+        cover[i] = char((cover[i] & 0xFE) | ((uchar(message[int(bit >> 3)]) >> (7 - (bit & 7))) & 1));
+    }
+    return cover;
+}
+
+QByteArray referenceExtract(const QByteArray& cover, int count)
+{
+    QByteArray message(count, 0);
+    for (int i = 0; i < count * 8; ++i) {
+        message[i / 8] = char((message[i / 8] << 1) | (cover[i] & 1));
+    }
+    return message;
+}
+
+// Побитный эталон для отсчётов: отсчёт i получает биты [(firstSample + i)·k, ... + k)
+QByteArray referenceSampleEmbed(QByteArray samples, const LsbLayout& layout, const QByteArray& message,
+                                int firstSample, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        char* sample = samples.data() + i * layout.stride;
+        for (int j = 0; j < layout.bits; ++j) {
+            const qint64 bit = qint64(firstSample + i) * layout.bits + j;
+            const int value = bit < message.size() * 8 ? (uchar(message[int(bit >> 3)]) >> (7 - (bit & 7))) & 1 : 0;
+            const int position = layout.shift + layout.bits - 1 - j;
+            char& byte = sample[position / 8];
+            byte = char((byte & ~(1 << (position % 8))) | (value << (position % 8)));
+        }
+    }
+    return samples;
+}
+
+QByteArray randomBytes(QRandomGenerator& random, int size)
+{
+    QByteArray bytes(size, Qt::Uninitialized);
+    for (int i = 0; i < size; ++i) {
+        bytes[i] = char(random.bounded(256));
+    }
+    return bytes;
+}
+
+} // namespace
+
+void TestWavEmbed::testLsbKernels()
+{
+    QRandomGenerator random(47);
+    for (bool simd : {false, true}) {
+        setSimdEnabled(simd);
+        for (int count : {0, 1, 3, 4, 5, 8, 31, 32, 33, 100, 1000}) {
+            const QByteArray message = randomBytes(random, count);
+            const QByteArray cover = randomBytes(random, count * 8);
+
+            QByteArray embedded = cover;
+            embedLsbBytes(embedded.data(), message.constData(), count);
+            QCOMPARE(embedded, referenceEmbed(cover, message, 0, count * 8));
+
+            QByteArray extracted(count, 0);
+            extractLsbBytes(embedded.constData(), extracted.data(), count);
+            QCOMPARE(extracted, message);
+            extractLsbBytes(cover.constData(), extracted.data(), count);
+            QCOMPARE(extracted, referenceExtract(cover, count));
+        }
+
+        // Отрезки, начинающиеся и заканчивающиеся внутри байта сообщения
+        const QByteArray message = randomBytes(random, 64);
+        for (int firstBit : {0, 1, 7, 8, 13}) {
+            for (int count : {0, 1, 6, 7, 8, 9, 40, 300, 64 * 8 - 13}) {
+                const QByteArray cover = randomBytes(random, count);
+                QByteArray embedded = cover;
+                embedLsbBits(embedded.data(), count, message.constData(), firstBit);
+                QCOMPARE(embedded, referenceEmbed(cover, message, firstBit, count));
+            }
+        }
+
+        // Отсчёты 1–8 байт, поля внутри байта и через границу байта
+        const QList<LsbLayout> layouts = {
+            {1, 0, 1}, {1, 0, 3}, {1, 4, 4}, {2, 0, 2}, {2, 6, 4}, {3, 4, 3}, {3, 7, 2}, {4, 0, 4}, {8, 0, 3}
+        };
+        for (const LsbLayout& layout : layouts) {
+            const int count = (64 * 8 + layout.bits - 1) / layout.bits;
+            const QByteArray samples = randomBytes(random, (count + 5) * layout.stride);
+            for (int firstSample : {0, 5}) {
+                QByteArray embedded = samples;
+                embedSampleBits(embedded.data(), count + 5, layout, message.constData(), message.size(), firstSample);
+                QCOMPARE(embedded, referenceSampleEmbed(samples, layout, message, firstSample, count + 5));
+            }
+
+            // Извлечение с начала и с байта сообщения, начинающегося внутри отсчёта
+            QByteArray embedded = samples;
+            embedSampleBits(embedded.data(), count, layout, message.constData(), message.size(), 0);
+            QByteArray extracted(64, 0);
+            extractSampleBits(embedded.constData(), layout, 0, extracted.data(), 64);
+            QCOMPARE(extracted, message);
+            const int bit = 3 * 8;
+            extracted.resize(61);
+            extractSampleBits(embedded.constData() + bit / layout.bits * layout.stride, layout, bit % layout.bits,
+                              extracted.data(), 61);
+            QCOMPARE(extracted, message.mid(3));
+        }
+    }
+    setSimdEnabled(true);
+}
+
+void TestWavEmbed::benchmarkLsbKernels_data()
+{
+    QTest::addColumn<bool>("extract");
+    QTest::newRow("embed") << false;
+    QTest::newRow("extract") << true;
+}
+
+void TestWavEmbed::benchmarkLsbKernels()
+{
+    QFETCH(bool, extract);
+
+    // Обложка задаётся через WAVEMBED_KERNEL_MB (до 255), по умолчанию 16 МБ, при BENCHMARK_LARGE — 64 МБ; сообщение в 8 раз меньше
+    const int count = int(qMin<qint64>(benchmarkSize("WAVEMBED_KERNEL_MB", 16, 64), 255) << 17);
+    QRandomGenerator random(470);
+    QByteArray message = randomBytes(random, count);
+    QByteArray cover = randomBytes(random, count * 8);
+    auto run = [&]() {
+        if (extract) {
+            extractLsbBytes(cover.constData(), message.data(), count);
+        } else {
+            embedLsbBytes(cover.data(), message.constData(), count);
+        }
+    };
+
+    const BenchmarkResult bitwise = measureOnce([&]() {
+        if (extract) {
+            message = referenceExtract(cover, count);
+        } else {
+            cover = referenceEmbed(cover, message, 0, count * 8);
+        }
+    });
+
+    setSimdEnabled(false);
+    const BenchmarkResult scalar = measureOnce(run);
+    setSimdEnabled(true);
+    const BenchmarkResult simd = measureBenchmark(run);
+
+    reportThroughput(QString("%1, AVX2 %2, МБ обложки").arg(extract ? "Извлечение" : "Встраивание")
+                         .arg(useAvx2() ? "да" : "нет"),
+                     double(count) * 8, {{"побитно", bitwise}, {"скалярно", scalar}, {"AVX2", simd}});
+}
+
+void TestWavEmbed::testPipeline()
+{
+    WavEmbed wavEmbed;
+    QString inputFile = "test_input.wav";
+    QString outputFile = "test_output.wav";
+    QString inPlaceFile = "test_inplace.wav";
+    QString message = QString::fromUtf8("Конвейер ").repeated(2000) + "!";
+
+    // 3 МБ стерео 24 бит, блоки до и после отсчётов
+    QByteArray samples(3 * 1024 * 1024, 0);
+    for (int i = 0; i < samples.size(); ++i) {
+        samples[i] = char(i * 29 + (i >> 11));
+    }
+    writeWavFile(inputFile, riffChunk("fmt ", fmtBody(WAV_FORMAT_PCM, 2, 48000, 24)) + riffChunk("LIST", "INFOx")
+                 + riffChunk("data", samples) + riffChunk("LIST", "INFOtrailing"));
+
+    // Эталон — встраивание через отображение в память
+    wavEmbed.setSampleBits(2);
+    QVERIFY2(wavEmbed.embedMessage(inputFile, outputFile, message), qPrintable(wavEmbed.errorString()));
+    const QByteArray expected = readFile(outputFile);
+
+    // Маленькие буферы: сообщение занимает несколько, файл — десятки оборотов пула
+    wavEmbed.setIoMode(WavEmbed::Pipelined);
+    wavEmbed.setPipelineBuffers(64 * 1024, 3);
+    QVector<double> fractions;
+    wavEmbed.setProgressCallback([&](const StreamPipelineStats& stats) { fractions.append(stats.fraction()); }, 0);
+    QVERIFY2(wavEmbed.embedMessage(inputFile, outputFile, message), qPrintable(wavEmbed.errorString()));
+    QCOMPARE(readFile(outputFile), expected);
+    const StreamPipelineStats stats = wavEmbed.pipelineStats();
+    QCOMPARE(stats.bytes, stats.total);
+    QVERIFY(stats.memory <= 3 * 64 * 1024);
+    QVERIFY(fractions.size() > 10);
+    for (int i = 1; i < fractions.size(); ++i) {
+        QVERIFY(fractions[i] >= fractions[i - 1]);
+    }
+    QCOMPARE(fractions.last(), 1.0);
+
+    // Извлечение конвейером и чтение результата в других режимах
+    QCOMPARE(wavEmbed.extractMessage(outputFile), message);
+    QVERIFY(wavEmbed.pipelineStats().total < stats.total);
+    wavEmbed.setIoMode(WavEmbed::Streamed);
+    QCOMPARE(wavEmbed.extractMessage(outputFile), message);
+
+    // На месте конвейер перезаписывает только отсчёты с сообщением
+    wavEmbed.setIoMode(WavEmbed::Pipelined);
+    QFile::remove(inPlaceFile);
+    QVERIFY(QFile::copy(inputFile, inPlaceFile));
+    QVERIFY2(wavEmbed.embedMessage(inPlaceFile, inPlaceFile, message), qPrintable(wavEmbed.errorString()));
+    QCOMPARE(readFile(inPlaceFile), expected);
+    QVERIFY(wavEmbed.pipelineStats().total < stats.total / 4);
+
+    // Отмена из обработчика прогресса
+    wavEmbed.setProgressCallback([&](const StreamPipelineStats& progress) {
+        if (progress.fraction() > 0.25) {
+            wavEmbed.cancel();
+        }
+    }, 0);
+    QVERIFY(!wavEmbed.embedMessage(inputFile, outputFile, message));
+    QCOMPARE(wavEmbed.errorString(), QString("Cancelled"));
+    QVERIFY(wavEmbed.pipelineStats().bytes < stats.total);
+    QVERIFY(readFile(outputFile).size() < expected.size());
+    wavEmbed.setProgressCallback(nullptr);
+
+    // Отмена до начала операции прерывает ближайший проход и на следующий не переходит
+    wavEmbed.cancel();
+    QVERIFY(!wavEmbed.embedMessage(inputFile, outputFile, message));
+    QCOMPARE(wavEmbed.errorString(), QString("Cancelled"));
+    QCOMPARE(wavEmbed.pipelineStats().bytes, qint64(0));
+    QVERIFY2(wavEmbed.embedMessage(inputFile, outputFile, message), qPrintable(wavEmbed.errorString()));
+    QCOMPARE(readFile(outputFile), expected);
+
+    QFile::remove(inputFile);
+    QFile::remove(outputFile);
+    QFile::remove(inPlaceFile);
+}
+
+void TestWavEmbed::benchmarkPipeline()
+{
+    // Размер обложки задаётся через WAVEMBED_PIPELINE_MB (до 4095), по умолчанию 32 МБ, при BENCHMARK_LARGE — 256 МБ
+    const qint64 megabytes = qMin<qint64>(benchmarkSize("WAVEMBED_PIPELINE_MB", 32, 256), 4095);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString coverFile = dir.filePath("cover.wav");
+    const QString outputFile = dir.filePath("output.wav");
+    const qint64 dataSize = megabytes << 20;
+    QFile cover(coverFile);
+    QVERIFY(cover.open(QIODevice::WriteOnly));
+    cover.write(riffChunk("RIFF", "WAVE" + riffChunk("fmt ", fmtBody(WAV_FORMAT_PCM, 2, 44100, 16))
+                          + riffChunk("data", QByteArray(), quint32(dataSize)), quint32(dataSize + 36)));
+    QByteArray block(1 << 20, 0);
+    for (int i = 0; i < block.size(); ++i) {
+        block[i] = char(i * 31 + (i >> 10));
+    }
+    for (qint64 i = 0; i < megabytes; ++i) {
+        cover.write(block);
+    }
+    cover.close();
+
+    // Сообщение на четверть обложки при 4 битах на отсчёт
+    WavEmbed wavEmbed;
+    wavEmbed.setSampleBits(4);
+    const QString message(int(qMin<qint64>(wavEmbed.capacity(coverFile) / 4, 256 << 20)), QChar('p'));
+
+    // Файлы в сотни мегабайт — каждый режим замеряется одним проходом
+    QString extracted;
+    bool embedded = false;
+    wavEmbed.setIoMode(WavEmbed::Streamed);
+    const BenchmarkResult streamedEmbed = measureOnce([&]() {
+        embedded = wavEmbed.embedMessage(coverFile, outputFile, message);
+    });
+    QVERIFY2(embedded, qPrintable(wavEmbed.errorString()));
+    const BenchmarkResult streamedExtract = measureOnce([&]() { extracted = wavEmbed.extractMessage(outputFile); });
+    QCOMPARE(extracted, message);
+
+    wavEmbed.setIoMode(WavEmbed::Pipelined);
+    const BenchmarkResult pipelinedEmbed = measureBenchmark([&]() {
+        embedded = wavEmbed.embedMessage(coverFile, outputFile, message);
+    }, 0);
+    QVERIFY2(embedded, qPrintable(wavEmbed.errorString()));
+    const StreamPipelineStats embedStats = wavEmbed.pipelineStats();
+    const BenchmarkResult pipelinedExtract = measureOnce([&]() { extracted = wavEmbed.extractMessage(outputFile); });
+    QCOMPARE(extracted, message);
+    const StreamPipelineStats extractStats = wavEmbed.pipelineStats();
+
+    reportThroughput(QString("%1 МБ, встраивание").arg(megabytes), dataSize,
+                     {{"фрагменты", streamedEmbed}, {"конвейер", pipelinedEmbed}});
+    reportThroughput(QString("%1 МБ, извлечение, МБ отсчётов").arg(megabytes), message.size() * 8.0 / 4,
+                     {{"фрагменты", streamedExtract}, {"конвейер", pipelinedExtract}});
+    qInfo() << "  встраивание конвейером: чтение" << qRound64(embedStats.readMegabytesPerSecond())
+            << "обработка" << qRound64(embedStats.processMegabytesPerSecond())
+            << "запись" << qRound64(embedStats.writeMegabytesPerSecond()) << "МБ/с,"
+            << "буферы" << embedStats.memory / 1024 << "КБ";
+    qInfo() << "  извлечение конвейером: чтение" << qRound64(extractStats.readMegabytesPerSecond())
+            << "обработка" << qRound64(extractStats.processMegabytesPerSecond()) << "МБ/с";
+}
+
+void TestWavEmbed::testScatterPermutation()
+{
+    for (quint64 domain : {1ull, 2ull, 3ull, 7ull, 64ull, 1000ull, 65537ull}) {
+        const ScatterPermutation permutation(domain, "key");
+        QCOMPARE(permutation.domain(), domain);
+        QVector<bool> seen(int(domain), false);
+        int fixed = 0;
+        for (quint64 i = 0; i < domain; ++i) {
+            const quint64 image = permutation.map(i);
+            QVERIFY(image < domain);
+            QVERIFY(!seen[int(image)]);
+            seen[int(image)] = true;
+            QCOMPARE(permutation.unmap(image), i);
+            fixed += image == i;
+        }
+        // У случайной перестановки в среднем одна неподвижная точка
+        if (domain >= 1000) {
+            QVERIFY(fixed < 10);
+        }
+    }
+
+    // Большая область: обратимость и разные ключи дают разные перестановки
+    const quint64 domain = 500000000ull;
+    const ScatterPermutation first(domain, "key");
+    const ScatterPermutation second(domain, "kez");
+    int same = 0;
+    for (quint64 i = 0; i < 10000; ++i) {
+        const quint64 image = first.map(i * 49999);
+        QVERIFY(image < domain);
+        QCOMPARE(first.unmap(image), i * 49999);
+        same += image == second.map(i * 49999);
+    }
+    QCOMPARE(same, 0);
+}
+
+void TestWavEmbed::testKeyedEmbedding()
+{
+    WavEmbed wavEmbed;
+    QString inputFile = "test_input.wav";
+    QString outputFile = "test_output.wav";
+    QString inPlaceFile = "test_inplace.wav";
+    QString message = QString::fromUtf8("Рассеянное сообщение ").repeated(100);
+
+    QByteArray samples(2 * 1024 * 1024, 0);
+    for (int i = 0; i < samples.size(); ++i) {
+        samples[i] = char(i * 53 + (i >> 13));
+    }
+    writeWavFile(inputFile, riffChunk("fmt ", fmtBody(WAV_FORMAT_PCM, 2, 44100, 16)) + riffChunk("data", samples)
+                 + riffChunk("LIST", "INFOtrailing"));
+    const QByteArray original = readFile(inputFile);
+    const int dataOffset = int(readWavInfo(inputFile).dataOffset);
+
+    // Результат не зависит от числа потоков и режима доступа
+    wavEmbed.setKey("correct horse");
+    wavEmbed.setSampleBits(2);
+    QByteArray expected;
+    for (int threads : {1, 4}) {
+        for (WavEmbed::IoMode mode : {WavEmbed::Streamed, WavEmbed::Mapped, WavEmbed::Pipelined}) {
+            wavEmbed.setThreadCount(threads);
+            wavEmbed.setIoMode(mode);
+            QVERIFY2(wavEmbed.embedMessage(inputFile, outputFile, message), qPrintable(wavEmbed.errorString()));
+            const QByteArray embedded = readFile(outputFile);
+            if (expected.isEmpty()) {
+                expected = embedded;
+            }
+            QCOMPARE(embedded, expected);
+            QCOMPARE(wavEmbed.extractMessage(outputFile), message);
+        }
+    }
+
+    // Изменённые отсчёты разбросаны по всему блоку, а не собраны в начале
+    QCOMPARE(expected.size(), original.size());
+    int changedInLastHalf = 0;
+    for (int i = dataOffset; i < dataOffset + samples.size(); i += 2) {
+        QCOMPARE(expected[i + 1], original[i + 1]);
+        QCOMPARE(uchar(expected[i] ^ original[i]) & 0xFC, 0);
+        changedInLastHalf += i >= dataOffset + samples.size() / 2 && expected[i] != original[i];
+    }
+    QVERIFY(changedInLastHalf > 1000);
+    QCOMPARE(expected.mid(dataOffset + samples.size()), original.mid(dataOffset + samples.size()));
+
+    // На месте — то же самое
+    QFile::remove(inPlaceFile);
+    QVERIFY(QFile::copy(inputFile, inPlaceFile));
+    QVERIFY2(wavEmbed.embedMessage(inPlaceFile, inPlaceFile, message), qPrintable(wavEmbed.errorString()));
+    QCOMPARE(readFile(inPlaceFile), expected);
+
+    // Без ключа или с другим ключом сообщение не находится
+    wavEmbed.setKey("wrong horse");
+    QVERIFY(wavEmbed.extractMessage(outputFile).isEmpty());
+    QCOMPARE(wavEmbed.errorString(), QString("No message found for this key"));
+    wavEmbed.setKey(QByteArray());
+    QVERIFY(wavEmbed.extractMessage(outputFile).isEmpty());
+    QVERIFY(!wavEmbed.errorString().isEmpty());
+
+    // Вместимость та же, что и при последовательном встраивании
+    wavEmbed.setKey("correct horse");
+    const QString full(int(wavEmbed.capacity(inputFile)), QChar('k'));
+    QVERIFY2(wavEmbed.embedMessage(inputFile, outputFile, full), qPrintable(wavEmbed.errorString()));
+    QCOMPARE(wavEmbed.extractMessage(outputFile), full);
+    QVERIFY(!wavEmbed.embedMessage(inputFile, outputFile, full + "!"));
+
+    QFile::remove(inputFile);
+    QFile::remove(outputFile);
+    QFile::remove(inPlaceFile);
+}
+
+void TestWavEmbed::benchmarkKeyedScatter()
+{
+    // Размер обложки задаётся через WAVEMBED_COVER_MB (до 4095), по умолчанию 64 МБ, при BENCHMARK_LARGE — 256 МБ
+    const qint64 megabytes = qMin<qint64>(benchmarkSize("WAVEMBED_COVER_MB", 64, 256), 4095);
+
+    // Разреженный файл, 16-битное стерео; сообщение задевает почти каждую страницу
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString coverFile = dir.filePath("cover.wav");
+    const qint64 dataSize = megabytes << 20;
+    const QByteArray header = riffChunk("RIFF", "WAVE" + riffChunk("fmt ", fmtBody(WAV_FORMAT_PCM, 2, 44100, 16))
+                                        + riffChunk("data", QByteArray(), quint32(dataSize)), quint32(dataSize + 36));
+    QFile cover(coverFile);
+    QVERIFY(cover.open(QIODevice::WriteOnly));
+    cover.write(header);
+    QVERIFY(cover.resize(header.size() + dataSize));
+    cover.close();
+
+    // Перестановка без обращения к файлу
+    const ScatterPermutation permutation(quint64(dataSize / 2), "benchmark");
+    const int evaluations = int(qMin<qint64>(1 << 22, dataSize / 2));
+    quint64 sum = 0;
+    const BenchmarkResult map = measureBenchmark([&]() {
+        for (int i = 0; i < evaluations; ++i) {
+            sum += permutation.map(quint64(i));
+        }
+    });
+    QVERIFY(sum > 0);
+    reportRate(QString("Перестановка %1 отсчётов").arg(dataSize / 2), "млн индексов/с", evaluations / 1e6, {{"", map}});
+
+    // Сообщение до 1 МБ, не больше половины вместимости обложки
+    WavEmbed wavEmbed;
+    wavEmbed.setKey("benchmark");
+    const QString message(int(qMin<qint64>(1 << 20, wavEmbed.capacity(coverFile) / 2)), QChar('s'));
+    QVERIFY(!message.isEmpty());
+    bool embedded = false;
+    QString extracted;
+    for (int threads : {1, 0}) {
+        wavEmbed.setThreadCount(threads);
+        const BenchmarkResult embed = measureOnce([&]() {
+            embedded = wavEmbed.embedMessage(coverFile, coverFile, message);
+        });
+        QVERIFY2(embedded, qPrintable(wavEmbed.errorString()));
+        const BenchmarkResult extract = measureOnce([&]() { extracted = wavEmbed.extractMessage(coverFile); });
+        QCOMPARE(extracted, message);
+        reportRate(QString("%1 МБ, сообщение %2 КБ, %3").arg(megabytes).arg(message.size() / 1024)
+                       .arg(threads ? "1 поток" : "все ядра"),
+                   "КБ/с сообщения", message.size() / 1024.0, {{"встраивание", embed}, {"извлечение", extract}});
+    }
+}
+
 // Вспомогательная функция для создания тестового WAV файла
-void createTestWavFile(const QString& filename, int sampleRate, int bitDepth)
-{
-    // Создаем заголовок WAV файла
-    QByteArray header;
-    header.append("RIFF");
-    header.append(QByteArray(4, 0)); // Размер файла
-    header.append("WAVE");
-    header.append("fmt ");
-    header.append(QByteArray(4, 0)); // Размер формата
-    header.append(QByteArray(2, 0)); // Тип формата
-    header.append(QByteArray(2, 0)); // Количество каналов
-    header.append(QByteArray(4, 0)); // Частота дискретизации
-    header.append(QByteArray(4, 0)); // Байт в секунду
-    header.append(QByteArray(2, 0)); // Блок выравнивания
-    header.append(QByteArray(2, 0)); // Бит на сэмпл
-    header.append("data");
-    header.append(QByteArray(4, 0)); // Размер данных
-    // Добавим хотя бы 10000 байт данных
-    QByteArray data(10000, 0);
-    
-    QFile file(filename);
-    file.open(QIODevice::WriteOnly);
-    file.write(header);
-    file.write(data);
-    file.close();
+void createTestWavFile(const QString& filename, int sampleRate, int bitDepth, int channels, int formatTag)
+{
+    // 10000 кадров тишины
+    QByteArray data(10000 * channels * bitDepth / 8, 0);
+    writeWavFile(filename, riffChunk("fmt ", fmtBody(formatTag, channels, sampleRate, bitDepth))
+                 + riffChunk("data", data));
 }
 
 QTEST_APPLESS_MAIN(TestWavEmbed) 
\ No newline at end of file
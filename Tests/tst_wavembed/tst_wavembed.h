@@ -4,6 +4,11 @@
 #include <QTest>
 #include <QString>
 #include "wavembed.h"
+#include "wavformat.h"
+#include "stegcontainer.h"
+#include "lsbkernels.h"
+#include "streampipeline.h"
+#include "keyedscatter.h"
 
 class TestWavEmbed : public QObject
 {
@@ -21,12 +26,58 @@ private slots:
     
     // Тест с разными форматами WAV
     void testDifferentWavFormats();
+
+    // Скорость встраивания и извлечения в разных форматах WAV
+    void benchmarkWavFormats_data();
+    void benchmarkWavFormats();
     
     // Тест производительности
     void testPerformance();
+
+    // Тест разбора блоков RIFF
+    void testWavChunks();
+
+    // Тест отклонения некорректных файлов
+    void testInvalidWav();
+
+    // Тест режима отображения в память и встраивания на месте
+    void testMappedMode();
+
+    // Сравнение скорости режимов доступа к файлу
+    void benchmarkIoModes_data();
+    void benchmarkIoModes();
+
+    // Тест формата контейнера и чтения старого формата
+    void testContainer();
+
+    // Время извлечения из большой обложки
+    void benchmarkContainerExtraction();
+
+    // Тест векторных и скалярных ядер младших битов
+    void testLsbKernels();
+
+    // Скорость ядер младших битов
+    void benchmarkLsbKernels_data();
+    void benchmarkLsbKernels();
+
+    // Тест конвейера: совпадение с другими режимами, прогресс, отмена
+    void testPipeline();
+
+    // Скорость стадий конвейера на большой обложке
+    void benchmarkPipeline();
+
+    // Тест ключевой перестановки отсчётов
+    void testScatterPermutation();
+
+    // Тест рассеянного встраивания по ключу
+    void testKeyedEmbedding();
+
+    // Скорость рассеянного встраивания в одном и нескольких потоках
+    void benchmarkKeyedScatter();
 };
 
 #endif // TST_WAVEMBED_H
 
 // Объявление вспомогательной функции для создания тестового WAV файла
-void createTestWavFile(const QString& filename, int sampleRate = 44100, int bitDepth = 16); 
\ No newline at end of file
+void createTestWavFile(const QString& filename, int sampleRate = 44100, int bitDepth = 16, int channels = 1,
+                       int formatTag = WAV_FORMAT_PCM); 
\ No newline at end of file
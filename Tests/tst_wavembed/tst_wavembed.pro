@@ -7,9 +7,23 @@ CONFIG -= app_bundle
 TEMPLATE = app
 
 INCLUDEPATH += ../../Server
+INCLUDEPATH += ..
 
 SOURCES += tst_wavembed.cpp \
-    ../../Server/wavembed.cpp
+    ../../Server/wavembed.cpp \
+    ../../Server/wavformat.cpp \
+    ../../Server/stegcontainer.cpp \
+    ../../Server/lsbkernels.cpp \
+    ../../Server/streampipeline.cpp \
+    ../../Server/keyedscatter.cpp
 
 HEADERS += tst_wavembed.h \
-    ../../Server/wavembed.h 
\ No newline at end of file
+    ../benchmark.h \
+    ../../Server/wavembed.h \
+    ../../Server/wavformat.h \
+    ../../Server/stegcontainer.h \
+    ../../Server/lsbkernels.h \
+    ../../Server/streampipeline.h \
+    ../../Server/keyedscatter.h \
+    ../../Server/parallel.h \
+    ../../Server/cpufeatures.h 
\ No newline at end of file